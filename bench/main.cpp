@@ -0,0 +1,349 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::message;
+using namespace bc::network;
+
+// Each result is written to stdout as a single line of json, for example:
+// {"benchmark":"heading_parse","iterations":1000000,"nanoseconds_per_op":
+// 42.0,"operations_per_second":23809523.8}
+
+static const auto version = version::level::maximum;
+static const uint16_t loopback_port = 28333;
+static const size_t broadcast_channels = 8;
+
+// Accumulate results so that the measured work is not optimized away.
+static volatile size_t sink = 0;
+
+static void report(const std::string& name, size_t iterations,
+    const asio::duration& elapsed)
+{
+    const auto nanoseconds = std::chrono::duration_cast<
+        std::chrono::nanoseconds>(elapsed).count();
+    const auto per_operation = double(nanoseconds) / iterations;
+    const auto per_second = per_operation == 0 ? 0 : 1e9 / per_operation;
+
+    std::cout
+        << "{\"benchmark\":\"" << name << "\","
+        << "\"iterations\":" << iterations << ","
+        << "\"nanoseconds_per_op\":" << per_operation << ","
+        << "\"operations_per_second\":" << per_second << "}" << std::endl;
+}
+
+// Warm caches and allocators with a tenth of the iterations before timing.
+template <typename Function>
+static void measure(const std::string& name, size_t iterations,
+    Function function)
+{
+    for (size_t index = 0; index < iterations / 10; ++index)
+        function();
+
+    const auto start = asio::steady_clock::now();
+
+    for (size_t index = 0; index < iterations; ++index)
+        function();
+
+    report(name, iterations, asio::steady_clock::now() - start);
+}
+
+// Framing.
+// ----------------------------------------------------------------------------
+
+static void heading_parse(uint32_t magic)
+{
+    const auto message = serialize(version, ping(42), magic);
+    const data_chunk data(message.begin(),
+        message.begin() + heading::maximum_size());
+
+    measure("heading_parse", 1000000, [&]()
+    {
+        sink += heading::factory(data).payload_size();
+    });
+}
+
+// Payload load (no subscribers, so this is parse and validation only).
+// ----------------------------------------------------------------------------
+
+static void payload_load(message_subscriber& subscriber,
+    const std::string& command, const data_chunk& payload, size_t iterations)
+{
+    measure("load_" + command, iterations, [&]()
+    {
+        auto source = make_safe_deserializer(payload.begin(), payload.end());
+        sink += subscriber.load(command, version, source).value();
+    });
+}
+
+static void payload_loads(threadpool& pool)
+{
+    message_subscriber subscriber(pool);
+    subscriber.start();
+
+    const auto genesis = chain::block::genesis_mainnet();
+    const inventory_vector vector(inventory::type_id::block, genesis.hash());
+    const inventory_vector::list vectors(500, vector);
+    const header::list headers_list(2000, header(genesis.header()));
+
+    payload_load(subscriber, ping::command, ping(42).to_data(version),
+        1000000);
+    payload_load(subscriber, inventory::command,
+        inventory(vectors).to_data(version), 10000);
+    payload_load(subscriber, headers::command,
+        headers(headers_list).to_data(version), 1000);
+    payload_load(subscriber, transaction::command,
+        genesis.transactions().front().to_data(), 100000);
+    payload_load(subscriber, block::command, genesis.to_data(), 100000);
+
+    subscriber.stop();
+}
+
+// Subscriber fan-out (ping is blocking, so handlers are invoked in place).
+// ----------------------------------------------------------------------------
+
+static void subscriber_fanout(threadpool& pool, size_t subscribers)
+{
+    message_subscriber subscriber(pool);
+    subscriber.start();
+
+    for (size_t index = 0; index < subscribers; ++index)
+        subscriber.subscribe<ping>([](const code& ec, ping_const_ptr message)
+        {
+            if (ec)
+                return false;
+
+            sink += message->nonce();
+            return true;
+        });
+
+    const auto payload = ping(42).to_data(version);
+
+    measure("fanout_" + std::to_string(subscribers), 100000, [&]()
+    {
+        auto source = make_safe_deserializer(payload.begin(), payload.end());
+        sink += subscriber.load(ping::command, version, source).value();
+    });
+
+    subscriber.stop();
+    subscriber.broadcast(error::channel_stopped);
+}
+
+// Capture replay (received messages of a capture file, in order).
+// ----------------------------------------------------------------------------
+
+static bool replay(threadpool& pool, const std::string& file)
+{
+    message_capture::record::list records;
+
+    if (!message_capture::load(file, records))
+    {
+        std::cerr << "Invalid capture file: " << file << std::endl;
+        return false;
+    }
+
+    message_subscriber subscriber(pool);
+    subscriber.start();
+
+    size_t failures = 0;
+    size_t received = 0;
+
+    // Each operation is a load of all received messages of the capture.
+    const auto load_all = [&]()
+    {
+        for (const auto& record: records)
+        {
+            if (record.direction != message_capture::direction::received)
+                continue;
+
+            const auto& payload = record.payload;
+            auto source = make_safe_deserializer(payload.begin(),
+                payload.end());
+            const auto ec = subscriber.load(record.heading.command(),
+                version, source);
+
+            failures += ec ? 1 : 0;
+            ++received;
+        }
+    };
+
+    load_all();
+    const auto loads = received;
+    const auto invalid = failures;
+    measure("replay", 10, load_all);
+
+    subscriber.stop();
+
+    std::cout
+        << "{\"capture\":\"" << file << "\","
+        << "\"messages\":" << records.size() << ","
+        << "\"received_loads\":" << loads << ","
+        << "\"failures\":" << invalid << "}" << std::endl;
+
+    return true;
+}
+
+// Broadcast over loopback channels.
+// ----------------------------------------------------------------------------
+
+static network::settings loopback_settings()
+{
+    auto configuration = network::settings(bc::config::settings::testnet);
+    configuration.threads = 2;
+    configuration.outbound_connections = 0;
+    configuration.inbound_connections = 0;
+    configuration.host_pool_capacity = 0;
+    configuration.manual_attempt_limit = 1;
+    configuration.seeds.clear();
+    configuration.statistics_interval_seconds = 0;
+    return configuration;
+}
+
+static code start_result(p2p& network)
+{
+    std::promise<code> promise;
+    network.start([&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    });
+
+    return promise.get_future().get();
+}
+
+static code run_result(p2p& network)
+{
+    std::promise<code> promise;
+    network.run([&promise](const code& ec)
+    {
+        promise.set_value(ec);
+    });
+
+    return promise.get_future().get();
+}
+
+static code connect_result(p2p& network, uint16_t port)
+{
+    std::promise<code> promise;
+    network.connect("127.0.0.1", port, [&promise](const code& ec,
+        channel::ptr)
+    {
+        promise.set_value(ec);
+    });
+
+    return promise.get_future().get();
+}
+
+static code broadcast_result(p2p& network, const inventory& message)
+{
+    std::promise<code> promise;
+    network.broadcast(message, [](const code&, channel::ptr) {},
+        [&promise](const code& ec)
+        {
+            promise.set_value(ec);
+        });
+
+    return promise.get_future().get();
+}
+
+static bool broadcast(size_t channels)
+{
+    auto server_settings = loopback_settings();
+    server_settings.threads = 4;
+    server_settings.inbound_port = loopback_port;
+    server_settings.inbound_connections = channels;
+    p2p server(server_settings);
+
+    if (start_result(server) || run_result(server))
+    {
+        std::cerr << "Failed to start loopback server." << std::endl;
+        return false;
+    }
+
+    // Each client is a distinct node, connecting over distinct local ports.
+    std::vector<std::shared_ptr<p2p>> clients;
+
+    for (size_t index = 0; index < channels; ++index)
+    {
+        const auto client = std::make_shared<p2p>(loopback_settings());
+        clients.push_back(client);
+
+        if (start_result(*client) || run_result(*client) ||
+            connect_result(*client, loopback_port))
+        {
+            std::cerr << "Failed to connect loopback client." << std::endl;
+            return false;
+        }
+    }
+
+    // The server registers inbound channels after its side of the handshake.
+    while (server.connection_count() < channels)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    // Inventory is not handled by the clients, so is discarded by them.
+    const auto genesis = chain::block::genesis_mainnet();
+    const inventory_vector vector(inventory::type_id::block, genesis.hash());
+    const inventory message(inventory_vector::list(10, vector));
+
+    measure("broadcast_" + std::to_string(channels), 1000, [&]()
+    {
+        sink += broadcast_result(server, message).value();
+    });
+
+    for (const auto client: clients)
+        client->close();
+
+    server.close();
+    return true;
+}
+
+// A capture file argument replays the capture instead of the benchmarks.
+int main(int argc, char* argv[])
+{
+    const auto magic = network::settings(
+        bc::config::settings::mainnet).identifier;
+
+    threadpool pool(1);
+
+    if (argc > 1)
+    {
+        const auto result = replay(pool, argv[1]);
+        pool.shutdown();
+        pool.join();
+        return result ? 0 : -1;
+    }
+
+    heading_parse(magic);
+    payload_loads(pool);
+    subscriber_fanout(pool, 1);
+    subscriber_fanout(pool, 8);
+    subscriber_fanout(pool, 64);
+
+    pool.shutdown();
+    pool.join();
+
+    return broadcast(broadcast_channels) ? 0 : -1;
+}
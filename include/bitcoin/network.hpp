@@ -16,22 +16,62 @@
 
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/acceptor.hpp>
+#include <bitcoin/network/address_cache.hpp>
+#include <bitcoin/network/admission.hpp>
+#include <bitcoin/network/anchors.hpp>
+#include <bitcoin/network/announcement_cache.hpp>
+#include <bitcoin/network/blacklist.hpp>
+#include <bitcoin/network/bloom_filter.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_metrics.hpp>
+#include <bitcoin/network/channel_pools.hpp>
+#include <bitcoin/network/channel_registry.hpp>
+#include <bitcoin/network/compact_block_pool.hpp>
+#include <bitcoin/network/connect_scheduler.hpp>
 #include <bitcoin/network/connector.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/eviction.hpp>
 #include <bitcoin/network/hosts.hpp>
+#include <bitcoin/network/inventory_queue.hpp>
+#include <bitcoin/network/lazy_block.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/loopback.hpp>
+#include <bitcoin/network/loopback_acceptor.hpp>
+#include <bitcoin/network/loopback_connector.hpp>
+#include <bitcoin/network/message_capture.hpp>
 #include <bitcoin/network/message_subscriber.hpp>
 #include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/pending_set.hpp>
+#include <bitcoin/network/pipe_transport.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
 #include <bitcoin/network/proxy.hpp>
+#include <bitcoin/network/rate_limiter.hpp>
+#include <bitcoin/network/request_tracker.hpp>
+#include <bitcoin/network/resolver_cache.hpp>
+#include <bitcoin/network/rolling_bloom.hpp>
+#include <bitcoin/network/runtime_settings.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/socket_options.hpp>
+#include <bitcoin/network/socket_transport.hpp>
+#include <bitcoin/network/statistics_emitter.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
+#include <bitcoin/network/transport.hpp>
 #include <bitcoin/network/version.hpp>
+#include <bitcoin/network/work_scheduler.hpp>
 #include <bitcoin/network/protocols/protocol.hpp>
 #include <bitcoin/network/protocols/protocol_address_31402.hpp>
+#include <bitcoin/network/protocols/protocol_bloom_filter_70001.hpp>
+#include <bitcoin/network/protocols/protocol_compact_block_70014.hpp>
 #include <bitcoin/network/protocols/protocol_events.hpp>
+#include <bitcoin/network/protocols/protocol_fee_filter_70013.hpp>
 #include <bitcoin/network/protocols/protocol_ping_31402.hpp>
 #include <bitcoin/network/protocols/protocol_ping_60001.hpp>
 #include <bitcoin/network/protocols/protocol_reject_70002.hpp>
+#include <bitcoin/network/protocols/protocol_relay_31402.hpp>
 #include <bitcoin/network/protocols/protocol_seed_31402.hpp>
+#include <bitcoin/network/protocols/protocol_send_headers_70012.hpp>
+#include <bitcoin/network/protocols/protocol_stall_31402.hpp>
 #include <bitcoin/network/protocols/protocol_timer.hpp>
 #include <bitcoin/network/protocols/protocol_version_31402.hpp>
 #include <bitcoin/network/protocols/protocol_version_70002.hpp>
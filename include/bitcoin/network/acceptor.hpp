@@ -20,13 +20,19 @@
 #define LIBBITCOIN_NETWORK_ACCEPTOR_HPP
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/admission.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_pools.hpp>
 #include <bitcoin/network/define.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/socket_options.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -42,32 +48,45 @@ public:
     typedef std::function<void(const code&, channel::ptr)> accept_handler;
 
     /// Construct an instance.
-    acceptor(threadpool& pool, const settings& settings);
+    acceptor(threadpool& pool, channel_pools& pools, buffer_pool& buffers,
+        timer_wheel& timers, admission& admission, const settings& settings);
 
     /// Validate acceptor stopped.
     ~acceptor();
 
+    /// The number of listeners that may share a port on this platform.
+    static size_t maximum_listeners();
+
     /// Start the listener on the specified port.
     virtual code listen(uint16_t port);
 
-    /// Accept the next connection available, until canceled.
+    /// Accept the next admitted connection available, until canceled.
+    /// The handler of an admitted connection owns an admission slot.
     virtual void accept(accept_handler handler);
 
     /// Cancel outstanding accept attempt.
     virtual void stop(const code& ec);
 
-private:
+protected:
     virtual bool stopped() const;
 
-    void handle_accept(const boost_code& ec, socket::ptr socket,
-        accept_handler handler);
-
     // These are thread safe.
     std::atomic<bool> stopped_;
     threadpool& pool_;
+    channel_pools& pools_;
+    buffer_pool& buffers_;
+    timer_wheel& timers_;
+    admission& admission_;
     const settings& settings_;
     mutable dispatcher dispatch_;
 
+private:
+    void handle_accept(const boost_code& ec, socket::ptr socket,
+        threadpool& pool, accept_handler handler);
+
+    // This is thread safe.
+    const socket_options options_;
+
     // These are protected by mutex.
     asio::acceptor acceptor_;
     mutable shared_mutex mutex_;
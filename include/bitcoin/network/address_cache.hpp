@@ -0,0 +1,59 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_ADDRESS_CACHE_HPP
+#define LIBBITCOIN_NETWORK_ADDRESS_CACHE_HPP
+
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/hosts.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The response to get_address, sampled from the host pool and regenerated
+/// once per interval rather than per request. This bounds the cost of
+/// requests and keeps repeated requests from mapping the pool.
+class BCT_API address_cache
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    address_cache(hosts& pool, const settings& settings);
+
+    /// The current response, regenerated if expired, empty if no hosts.
+    virtual address_const_ptr get();
+
+private:
+    address_const_ptr generate() const;
+
+    hosts& hosts_;
+    const asio::duration interval_;
+
+    // These are protected by mutex.
+    address_const_ptr response_;
+    asio::time_point expiry_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
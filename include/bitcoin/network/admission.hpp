@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_ADMISSION_HPP
+#define LIBBITCOIN_NETWORK_ADMISSION_HPP
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/blacklist.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// Admission control for inbound connections, applied upon accept and before
+/// a channel is created. Rejects blacklisted addresses and subnets,
+/// connections beyond per-address and per-subnet rates (token buckets) and
+/// connections beyond the limit of concurrent inbound handshakes.
+/// Bucket tables are bounded, the least recently used bucket is evicted.
+class BCT_API admission
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    admission(blacklist& blacklist, const settings& settings);
+
+    /// Determine if the address of the authority is blacklisted.
+    virtual bool blacklisted(const config::authority& authority) const;
+
+    /// Admit a connection from the authority, taking a handshake slot.
+    /// Returns error::address_blocked or error::peer_throttling if rejected.
+    virtual code admit(const config::authority& authority);
+
+    /// Release the handshake slot of an admitted connection.
+    virtual void release();
+
+private:
+    typedef asio::ipv6::bytes_type key;
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::list<key> key_list;
+
+    struct bucket
+    {
+        double tokens;
+        asio::time_point updated;
+        key_list::iterator position;
+    };
+
+    typedef std::unordered_map<key, bucket, key_hash> bucket_map;
+
+    // Buckets are ordered from least to most recently used.
+    struct table
+    {
+        bucket_map buckets;
+        key_list order;
+    };
+
+    static key subnet(const asio::ipv6& ip);
+    static double tokens(const bucket& entry, double capacity, double rate,
+        const asio::time_point& now);
+    static void prune(table& buckets, double capacity, double rate,
+        const asio::time_point& now);
+    static bool available(const table& buckets, const key& value,
+        double capacity, double rate, const asio::time_point& now);
+    static void take(table& buckets, const key& value, double capacity,
+        double rate, const asio::time_point& now);
+
+    // These are thread safe.
+    const double address_capacity_;
+    const double address_rate_;
+    const double subnet_capacity_;
+    const double subnet_rate_;
+    const size_t handshake_limit_;
+    blacklist& blacklist_;
+
+    // These are protected by mutex.
+    table addresses_;
+    table subnets_;
+    size_t handshakes_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
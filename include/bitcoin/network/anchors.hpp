@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_ANCHORS_HPP
+#define LIBBITCOIN_NETWORK_ANCHORS_HPP
+
+#include <cstddef>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The outbound peers connected at stop, which are reconnected first on the
+/// next start. The file is a line-oriented set of config::authority
+/// serializations. It is removed once loaded, so that an anchor that causes
+/// a failure is not retried on every restart.
+class BCT_API anchors
+  : noncopyable
+{
+public:
+    typedef config::authority::list list;
+
+    /// Construct an instance.
+    anchors(const settings& settings);
+
+    /// Load and remove the anchors file, empty if none or disabled.
+    virtual list load();
+
+    /// Save up to the configured number of anchors, replacing the file.
+    virtual code save(const list& peers);
+
+private:
+    const size_t capacity_;
+    const boost::filesystem::path file_path_;
+
+    // This is protected by mutex.
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
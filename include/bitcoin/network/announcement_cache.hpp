@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_ANNOUNCEMENT_CACHE_HPP
+#define LIBBITCOIN_NETWORK_ANNOUNCEMENT_CACHE_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The most recent block announcement, serialized on first use for each
+/// protocol version and form (headers or inv) and then shared by all
+/// channels, so that a new tip is encoded once rather than once per peer.
+class BCT_API announcement_cache
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<const data_chunk> payload_ptr;
+
+    /// Construct an instance.
+    /// @param[in]  identifier  The network magic of serialized messages.
+    announcement_cache(uint32_t identifier);
+
+    /// Replace the announcement, the last header being the new tip.
+    /// Returns false (and has no effect) if there are no headers.
+    virtual bool set(headers_const_ptr announcement);
+
+    /// The hash of the announced tip, null_hash if none.
+    virtual hash_digest tip() const;
+
+    /// The serialized headers message of the announcement, null if none.
+    virtual payload_ptr headers(uint32_t version);
+
+    /// The serialized inv message of the announced tip, null if none.
+    virtual payload_ptr inventory(uint32_t version);
+
+private:
+    typedef std::map<uint32_t, payload_ptr> payloads;
+
+    const uint32_t identifier_;
+
+    // These are protected by mutex.
+    headers_const_ptr announcement_;
+    hash_digest tip_;
+    payloads headers_;
+    payloads inventory_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_BLACKLIST_HPP
+#define LIBBITCOIN_NETWORK_BLACKLIST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/runtime_settings.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A set of banned addresses and subnets (CIDR), matched by hash.
+/// Entries are grouped by prefix length, so a match costs one hash lookup
+/// per distinct prefix length in use, independent of the number of entries.
+/// Prefixes are of the ipv6 form, an ipv4 /n is stored as /(96 + n).
+class BCT_API blacklist
+  : noncopyable
+{
+public:
+    static const uint8_t address_prefix = 128;
+
+    /// Parse "address[/prefix]", where the prefix is of the address family.
+    static bool parse(const std::string& subnet, asio::ipv6& out_ip,
+        uint8_t& out_prefix);
+
+    /// Construct an instance from the blacklists and blacklist_subnets.
+    blacklist(const settings& settings);
+
+    /// Replace the configured entries of one reload with those of the next.
+    /// Entries inserted otherwise (e.g. bans) are retained unless they are
+    /// also configured entries of the prior reload.
+    virtual void reconfigure(const runtime_settings& prior,
+        const runtime_settings& next);
+
+    /// Determine if the address is within any entry.
+    virtual bool contains(const asio::ipv6& ip) const;
+
+    /// Add an entry, no effect if it exists.
+    virtual void insert(const asio::ipv6& ip, uint8_t prefix);
+
+    /// Remove an entry, returns false if it did not exist.
+    virtual bool erase(const asio::ipv6& ip, uint8_t prefix);
+
+    /// The number of entries.
+    virtual size_t size() const;
+
+private:
+    typedef asio::ipv6::bytes_type key;
+
+    struct key_hash
+    {
+        size_t operator()(const key& value) const;
+    };
+
+    typedef std::unordered_set<key, key_hash> key_set;
+    typedef std::map<uint8_t, key_set> prefix_map;
+
+    static key mask(const asio::ipv6& ip, uint8_t prefix);
+
+    void configure(const config::authority::list& blacklists,
+        const std::vector<std::string>& subnets, bool add);
+
+    // These are protected by mutex.
+    prefix_map prefixes_;
+    size_t size_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_BLOOM_FILTER_HPP
+#define LIBBITCOIN_NETWORK_BLOOM_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The transaction filter loaded by an SPV peer (bip37). Matching may update
+/// the filter with the outpoints of matched outputs, as the flags direct.
+/// Match results of a filter that is not updated by matching are cached by
+/// transaction hash, so that relay evaluates the filter once per transaction,
+/// and the cache is cleared by filter_add.
+class BCT_API bloom_filter
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<bloom_filter> ptr;
+
+    /// The bip37 limits on filter size and number of hash functions.
+    static const size_t maximum_size = 36000;
+    static const size_t maximum_hash_functions = 50;
+
+    /// The bip37 limit on the size of a filter_add element.
+    static const size_t maximum_element = 520;
+
+    /// The outpoint update policy of matched outputs.
+    enum update : uint8_t
+    {
+        none = 0,
+        all = 1,
+        pay_public_key_only = 2
+    };
+
+    /// Construct an instance from a filter_load message.
+    bloom_filter(const message::filter_load& message);
+
+    /// True if the message is within bip37 limits.
+    static bool valid(const message::filter_load& message);
+
+    /// The bip37 (32 bit x86) murmur3 hash.
+    static uint32_t murmur3(uint32_t seed, const data_slice& data);
+
+    /// Add an element to the filter, clearing cached results.
+    void insert(const data_slice& element);
+
+    /// True if the element (probably) matches the filter.
+    bool contains(const data_slice& element) const;
+
+    /// True if the transaction matches, updating the filter as flagged.
+    bool matches(const chain::transaction& tx);
+
+    /// The merkle block of the matching transactions of the block.
+    /// @param[out]  matched  The indexes of the matching transactions.
+    message::merkle_block filter(const chain::block& block,
+        std::vector<size_t>& matched);
+
+private:
+    typedef std::unordered_map<hash_digest, bool> results;
+
+    bool test(const data_slice& element) const;
+    void set(const data_slice& element);
+    bool evaluate(const chain::transaction& tx, bool& updated);
+
+    const uint32_t hash_functions_;
+    const uint32_t tweak_;
+    const uint8_t flags_;
+
+    // These are protected by mutex.
+    data_chunk data_;
+    results results_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_BUFFER_POOL_HPP
+#define LIBBITCOIN_NETWORK_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A size-classed pool of reusable payload buffers shared by all channels.
+/// Size classes are powers of two, starting at the minimum class size.
+/// Buffers are moved out on acquire and must be moved back on release.
+class BCT_API buffer_pool
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    /// @param[in]  retained  The maximum number of buffers kept per class.
+    buffer_pool(size_t retained);
+
+    /// Obtain a buffer with size set to the specified size.
+    virtual data_chunk acquire(size_t size);
+
+    /// Return a buffer to the pool (may be freed if the class is full).
+    virtual void release(data_chunk&& buffer);
+
+    /// The number of bytes currently retained by the pool.
+    virtual size_t retained_bytes() const;
+
+private:
+    typedef std::vector<data_chunk> buffers;
+
+    static size_t class_index(size_t size);
+    static size_t class_size(size_t index);
+    size_t class_limit(size_t index) const;
+
+    const size_t retained_;
+
+    // These are protected by mutex.
+    std::vector<buffers> classes_;
+    size_t retained_bytes_;
+    mutable upgrade_mutex mutex_;
+};
+
+/// This class is not thread safe.
+/// A buffer borrowed from a pool for the lifetime of the instance, so that it
+/// is returned to the pool on every path, including stop and failure paths.
+class BCT_API pooled_buffer
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<pooled_buffer> ptr;
+
+    /// Borrow a buffer with size set to the specified size.
+    pooled_buffer(buffer_pool& pool, size_t size);
+
+    /// Return the buffer to the pool.
+    ~pooled_buffer();
+
+    /// The borrowed buffer.
+    data_chunk& data();
+
+private:
+    buffer_pool& pool_;
+    data_chunk buffer_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -26,10 +26,16 @@
 #include <utility>
 #include <string>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/bloom_filter.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/inventory_queue.hpp>
 #include <bitcoin/network/message_subscriber.hpp>
 #include <bitcoin/network/proxy.hpp>
+#include <bitcoin/network/request_tracker.hpp>
+#include <bitcoin/network/rolling_bloom.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -42,21 +48,78 @@ public:
     typedef std::shared_ptr<channel> ptr;
 
     /// Construct an instance.
-    channel(threadpool& pool, socket::ptr socket, const settings& settings);
+    channel(threadpool& pool, buffer_pool& buffers, timer_wheel& timers,
+        transport::ptr transport, const settings& settings);
 
     void start(result_handler handler) override;
 
     // Properties.
 
+    /// A process-unique identifier for this channel.
+    virtual uint64_t id() const;
+
     virtual bool notify() const;
     virtual void set_notify(bool value);
 
+    /// Replace the configured timeouts, this must be called before start.
+    virtual void set_timeouts(const asio::duration& expiration,
+        const asio::duration& inactivity);
+
+    /// The channel was established by the outbound session.
+    virtual bool outbound() const;
+    virtual void set_outbound(bool value);
+
+    /// The channel was accepted by the inbound session.
+    virtual bool inbound() const;
+    virtual void set_inbound(bool value);
+
+    /// The time of channel construction (connection).
+    virtual asio::time_point started() const;
+
+    /// The last time the peer relayed novel inventory, epoch if never.
+    virtual asio::time_point last_useful() const;
+    virtual void set_useful();
+
+    /// The peer asked for block announcement by headers (bip130).
+    virtual bool headers_preferred() const;
+    virtual void set_headers_preferred(bool value);
+
+    /// The peer's minimum fee rate for transaction relay (bip133).
+    virtual uint64_t fee_filter() const;
+    virtual void set_fee_filter(uint64_t value);
+
+    /// The transaction filter loaded by the peer (bip37), null if none.
+    virtual bloom_filter::ptr filter() const;
+    virtual void set_filter(bloom_filter::ptr value);
+
+    /// True if the peer accepts transaction announcements, as set by its
+    /// version or enabled by a filter load or clear (bip37).
+    virtual bool peer_relay() const;
+    virtual void enable_peer_relay();
+
     virtual uint64_t nonce() const;
     virtual void set_nonce(uint64_t value);
 
     virtual version_const_ptr peer_version() const;
     virtual void set_peer_version(version_const_ptr value);
 
+    /// The inventory pending announcement to and known by the peer.
+    virtual inventory_queue& announcements();
+
+    /// The get_data requests outstanding to the peer.
+    virtual request_tracker& requests();
+
+    /// Mark addresses as known to the peer, such as those received from it.
+    virtual void known_addresses(const message::network_address::list& list);
+
+    /// True if any of the addresses is (probably) not known to the peer.
+    virtual bool unknown_addresses(
+        const message::network_address::list& list) const;
+
+    /// Those addresses not known to the peer, which are then marked known.
+    virtual message::network_address::list mark_addresses(
+        const message::network_address::list& list);
+
 protected:
     virtual void signal_activity() override;
     virtual void handle_stopping() override;
@@ -68,14 +131,34 @@ private:
     void start_expiration();
     void handle_expiration(const code& ec);
 
-    void start_inactivity();
+    void start_inactivity(const asio::duration& delay);
     void handle_inactivity(const code& ec);
 
+    const uint64_t id_;
     std::atomic<bool> notify_;
+    std::atomic<bool> outbound_;
+    std::atomic<bool> inbound_;
+    const asio::time_point started_;
+    std::atomic<int64_t> last_useful_;
+    std::atomic<bool> headers_preferred_;
+    std::atomic<uint64_t> fee_filter_;
+    bc::atomic<bloom_filter::ptr> filter_;
+    std::atomic<bool> relay_enabled_;
     std::atomic<uint64_t> nonce_;
     bc::atomic<version_const_ptr> peer_version_;
-    deadline::ptr expiration_;
-    deadline::ptr inactivity_;
+    inventory_queue announcements_;
+    request_tracker requests_;
+    timer_wheel& timers_;
+
+    // These are protected by address_mutex_.
+    rolling_bloom known_addresses_;
+    mutable upgrade_mutex address_mutex_;
+
+    asio::duration expiration_;
+    asio::duration inactivity_;
+    std::atomic<int64_t> last_activity_;
+    std::atomic<timer_wheel::token> expiration_timer_;
+    std::atomic<timer_wheel::token> inactivity_timer_;
 };
 
 } // namespace network
@@ -0,0 +1,124 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_CHANNEL_METRICS_HPP
+#define LIBBITCOIN_NETWORK_CHANNEL_METRICS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// Traffic and latency counters of a channel, by message type.
+/// Recording is a relaxed atomic increment, so it is cheap enough to remain
+/// enabled. Counters are cumulative from channel construction.
+class BCT_API channel_metrics
+  : noncopyable
+{
+public:
+    /// The counters of a message type.
+    struct counters
+    {
+        uint64_t messages_in;
+        uint64_t bytes_in;
+        uint64_t parse_microseconds;
+        uint64_t messages_out;
+        uint64_t bytes_out;
+        uint64_t send_wait_microseconds;
+    };
+
+    /// Ping round trip statistics, durations are zero until sampled.
+    struct round_trip
+    {
+        size_t samples;
+        asio::duration minimum;
+        asio::duration average;
+        asio::duration jitter;
+    };
+
+    /// A point in time copy of counters, summable across channels.
+    struct snapshot
+    {
+        snapshot();
+
+        /// Accumulate the counters of another snapshot.
+        void add(const snapshot& other);
+
+        /// Counters indexed as commands().
+        std::vector<counters> types;
+        uint64_t pings;
+        uint64_t ping_microseconds;
+    };
+
+    /// The message commands by index, the last entry counts all others.
+    static const std::vector<std::string>& commands();
+
+    /// Construct an instance.
+    channel_metrics();
+
+    /// Record a received message, including its heading.
+    void received(const std::string& command, size_t bytes,
+        const asio::duration& parse);
+
+    /// Record a sent message and the time it spent in the send queue.
+    void sent(const std::string& command, size_t bytes,
+        const asio::duration& wait);
+
+    /// Record a ping round trip.
+    void pinged(const asio::duration& sample);
+
+    /// The ping round trip statistics.
+    round_trip latency() const;
+
+    /// Copy the current counters.
+    snapshot collect() const;
+
+private:
+    struct atomic_counters
+    {
+        std::atomic<uint64_t> messages_in;
+        std::atomic<uint64_t> bytes_in;
+        std::atomic<uint64_t> parse_microseconds;
+        std::atomic<uint64_t> messages_out;
+        std::atomic<uint64_t> bytes_out;
+        std::atomic<uint64_t> send_wait_microseconds;
+    };
+
+    static size_t index(const std::string& command);
+
+    // These are thread safe.
+    std::vector<atomic_counters> types_;
+    std::atomic<uint64_t> pings_;
+    std::atomic<uint64_t> ping_microseconds_;
+
+    // This is protected by mutex.
+    round_trip latency_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_CHANNEL_POOLS_HPP
+#define LIBBITCOIN_NETWORK_CHANNEL_POOLS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A set of single-threaded pools to which new channels are assigned in turn
+/// (thread-per-core), so that the socket, subscribers and dispatch of each
+/// channel run on one thread. With no pools every channel is assigned the
+/// shared pool. Work across channels (such as broadcast) is posted to the
+/// pool of each channel.
+class BCT_API channel_pools
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    /// @param[in]  shared  The pool assigned when there are no pools.
+    /// @param[in]  count   The number of single-threaded pools.
+    channel_pools(threadpool& shared, size_t count);
+
+    /// Start one thread in each pool.
+    virtual void spawn();
+
+    /// Signal each pool to stop accepting work.
+    virtual void shutdown();
+
+    /// Block on the threads of each pool.
+    virtual void join();
+
+    /// The pool to which the next channel is assigned.
+    virtual threadpool& select();
+
+private:
+    typedef std::vector<std::shared_ptr<threadpool>> pools;
+
+    static pools create(size_t count);
+
+    // These are thread safe.
+    threadpool& shared_;
+    const pools pools_;
+    std::atomic<size_t> next_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
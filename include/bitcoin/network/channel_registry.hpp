@@ -0,0 +1,100 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_CHANNEL_REGISTRY_HPP
+#define LIBBITCOIN_NETWORK_CHANNEL_REGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A collection of channels hashed by channel id, with hash indexes on
+/// authority and nonce so that lookups do not scan the collection.
+/// An immutable snapshot is maintained for iteration without the lock.
+class BCT_API channel_registry
+  : noncopyable
+{
+public:
+    typedef std::vector<channel::ptr> list;
+    typedef std::shared_ptr<const list> list_ptr;
+
+    /// Construct an instance.
+    channel_registry(size_t initial_capacity);
+
+    /// The number of channels in the registry.
+    size_t size() const;
+
+    /// Store a channel, fails if stopped or if unique and the authority
+    /// is already registered (error::address_in_use).
+    code store(channel::ptr channel, bool unique_authority);
+
+    /// Remove a channel if it exists.
+    void remove(channel::ptr channel);
+
+    /// Determine if a channel with the authority is registered.
+    bool exists(const config::authority& authority) const;
+
+    /// Determine if a channel with the nonce is registered.
+    bool exists(uint64_t nonce) const;
+
+    /// Find a channel by its id, null if not registered.
+    channel::ptr find(uint64_t id) const;
+
+    /// Obtain the current set of channels, does not take the lock.
+    list_ptr snapshot() const;
+
+    /// Stop all channels and prevent subsequent store.
+    void stop(const code& ec);
+
+private:
+    struct authority_hash
+    {
+        size_t operator()(const config::authority& authority) const;
+    };
+
+    typedef std::unordered_map<config::authority, size_t, authority_hash>
+        authority_index;
+    typedef std::unordered_map<uint64_t, size_t> nonce_index;
+    typedef std::unordered_map<uint64_t, channel::ptr> channel_map;
+
+    void update_snapshot();
+
+    // These are protected by mutex.
+    bool stopped_;
+    channel_map channels_;
+    authority_index authorities_;
+    nonce_index nonces_;
+    mutable upgrade_mutex mutex_;
+
+    // This is replaced under mutex and loaded atomically.
+    list_ptr snapshot_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_COMPACT_BLOCK_POOL_HPP
+#define LIBBITCOIN_NETWORK_COMPACT_BLOCK_POOL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// Interface to the transaction pool and block store of the layer above,
+/// used by compact block relay (bip152). Implementations must be thread
+/// safe, as they are called from all channels.
+class BCT_API compact_block_pool
+{
+public:
+    typedef std::shared_ptr<compact_block_pool> ptr;
+    typedef std::vector<transaction_const_ptr> transaction_list;
+    typedef std::function<void(const code&, block_const_ptr)> block_handler;
+
+    virtual ~compact_block_pool() {}
+
+    /// Populate the null positions of the block's transactions from the
+    /// pool. Null positions correspond, in order, to the short ids of the
+    /// block, under its siphash key and of txids (version 1) or of wtxids
+    /// (version 2). Positions without a match are left null.
+    /// Return false if short ids collide, so that the block is requested.
+    virtual bool fill(const message::compact_block& block, uint64_t version,
+        transaction_list& transactions) = 0;
+
+    /// Fetch a block by hash, in order to serve its transactions to a peer.
+    virtual void fetch(const hash_digest& hash, block_handler handler) = 0;
+
+    /// Accept a block reconstructed from a compact block and pool, the
+    /// merkle root has been verified against the header.
+    virtual void store(block_const_ptr block,
+        const config::authority& source) = 0;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
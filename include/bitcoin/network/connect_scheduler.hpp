@@ -0,0 +1,99 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_CONNECT_SCHEDULER_HPP
+#define LIBBITCOIN_NETWORK_CONNECT_SCHEDULER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/hosts.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// Adaptive scheduling of outbound connection slots. Attempt outcomes feed
+/// a moving success rate that scales the batch size, each slot backs off
+/// exponentially across consecutive failures, and the network groups of
+/// connected slots are tracked so that new attempts favor diversity.
+class BCT_API connect_scheduler
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    /// @param[in]  slots       The number of outbound connection slots.
+    /// @param[in]  batch_size  The configured (minimum) batch size.
+    /// @param[in]  maximum     The upper limit of a slot's backoff delay.
+    connect_scheduler(size_t slots, size_t batch_size,
+        const asio::duration& maximum);
+
+    /// The network group of the address, /16 for ipv4 and /32 for ipv6.
+    static uint32_t group(const config::authority& host);
+
+    /// The jittered exponential backoff for consecutive failures.
+    static asio::duration backoff(size_t failures, const asio::duration& base,
+        const asio::duration& maximum);
+
+    /// The number of concurrent attempts to make for the next batch.
+    size_t batch_size() const;
+
+    /// The delay before the next batch of the slot (zero if not failing).
+    asio::duration delay(size_t slot) const;
+
+    /// The network groups of the connected slots.
+    hosts::groups groups() const;
+
+    /// Record the outcome of a single connection attempt.
+    void attempted(bool success);
+
+    /// Record the failure of the slot, extending its backoff.
+    void failed(size_t slot);
+
+    /// Record the connection of the slot, clearing its backoff.
+    void connected(size_t slot, const config::authority& host);
+
+    /// Record the disconnection of the slot.
+    void disconnected(size_t slot);
+
+    /// Increase the number of slots, slots are never removed.
+    void resize(size_t slots);
+
+private:
+    struct slot_state
+    {
+        size_t failures;
+        bool connected;
+        uint32_t group;
+    };
+
+    const size_t batch_size_;
+    const asio::duration maximum_;
+
+    // These are protected by mutex.
+    double success_rate_;
+    std::vector<slot_state> slots_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -24,9 +24,14 @@
 #include <memory>
 #include <string>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_pools.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/resolver_cache.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/socket_options.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -34,6 +39,7 @@ namespace network {
 /// Create outbound socket connections.
 /// This class is thread safe against stop.
 /// This class is not safe for concurrent connection attempts.
+/// Sequential attempts may reuse an instance once recycled.
 class BCT_API connector
   : public enable_shared_from_base<connector>, noncopyable, track<connector>
 {
@@ -42,7 +48,9 @@ public:
     typedef std::function<void(const code& ec, channel::ptr)> connect_handler;
 
     /// Construct an instance.
-    connector(threadpool& pool, const settings& settings);
+    connector(threadpool& pool, channel_pools& pools, buffer_pool& buffers,
+        timer_wheel& timers, resolver_cache& resolver,
+        const settings& settings);
 
     /// Validate connector stopped.
     ~connector();
@@ -59,31 +67,47 @@ public:
     virtual void connect(const std::string& hostname, uint16_t port,
         connect_handler handler);
 
+    /// Set the timeout of subsequent attempts (initially connect_timeout).
+    void set_timeout(const asio::duration& timeout);
+
     /// Cancel outstanding connection attempt.
     void stop(const code& ec);
 
-private:
-    typedef std::shared_ptr<asio::query> query_ptr;
+    /// End the completed attempt so the instance may be reused.
+    /// Returns false if stopped, in which case it may not be reused.
+    bool recycle();
 
+protected:
     bool stopped() const;
 
-    void handle_resolve(const boost_code& ec, asio::iterator iterator,
-        connect_handler handler);
-    void handle_connect(const boost_code& ec, asio::iterator iterator,
-        socket::ptr socket, connect_handler handler);
-    void handle_timer(const code& ec, socket::ptr socket,
-        connect_handler handler);
-
     // These are thread safe
     std::atomic<bool> stopped_;
     threadpool& pool_;
+    channel_pools& pools_;
+    buffer_pool& buffers_;
+    timer_wheel& timers_;
     const settings& settings_;
     mutable dispatcher dispatch_;
 
+private:
+    typedef resolver_cache::endpoints endpoints;
+    typedef resolver_cache::endpoints_ptr endpoints_ptr;
+
+    void handle_resolve(const code& ec, endpoints_ptr hosts,
+        connect_handler handler);
+    void handle_connect(const boost_code& ec, endpoints::const_iterator,
+        endpoints_ptr hosts, socket::ptr socket, threadpool& pool,
+        connect_handler handler);
+    void handle_timer(const code& ec, socket::ptr socket,
+        connect_handler handler);
+
+    // These are thread safe
+    resolver_cache& resolver_;
+    const socket_options options_;
+
     // These are protected by mutex.
-    query_ptr query_;
     deadline::ptr timer_;
-    asio::resolver resolver_;
+    asio::duration timeout_;
     mutable upgrade_mutex mutex_;
 };
 
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_EVICTION_HPP
+#define LIBBITCOIN_NETWORK_EVICTION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_registry.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// Selection of an inbound channel to drop in favor of a new connection.
+/// Channels are protected in turn by keyed network group, by lowest ping
+/// round trip, by most recent useful relay and by longest uptime. Of the
+/// remainder the youngest channel of the most populous network group is
+/// selected. The group key is private to the instance, so that an attacker
+/// cannot choose addresses to obtain the group protection.
+class BCT_API eviction
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    eviction();
+
+    /// Select the channel to evict, null if all channels are protected.
+    /// @param[in]  channels  The inbound channels subject to eviction.
+    channel::ptr select(const channel_registry::list& channels) const;
+
+private:
+    struct candidate
+    {
+        channel::ptr channel;
+        uint32_t group;
+        size_t keyed_group;
+        asio::duration ping;
+        asio::time_point useful;
+        asio::time_point started;
+    };
+
+    typedef std::vector<candidate> candidates;
+
+    template <typename Compare>
+    static void protect(candidates& values, size_t count, Compare compare);
+
+    const uint64_t key_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -23,6 +23,8 @@
 #include <cstddef>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/define.hpp>
@@ -34,8 +36,23 @@ namespace network {
 /// This class is thread safe.
 /// The hosts class manages a thread-safe dynamic store of network addresses.
 /// The store can be loaded and saved from/to the specified file path.
-/// The file is a line-oriented set of config::authority serializations.
+/// The file is a magic number followed by fixed-size records of a
+/// network_address (with timestamp and services) and its table state, or
+/// optionally (hosts_file_text) a line-oriented set of config::authority
+/// serializations. Either format is accepted on load, so a text file is
+/// imported and may be exported.
 /// Duplicate addresses and those with zero-valued ports are disacarded.
+/// Addresses are indexed by ip and port, so lookup and random fetch are O(1).
+/// Addresses are kept in "new" and "tried" tables. Stored addresses are new,
+/// connection success moves an address to tried and repeated failure
+/// demotes it from tried or evicts it from new. Fetch favors tried addresses
+/// and addresses with fewer failures.
+/// The pool is divided into buckets by network group, each with its own lock
+/// and capacity, so one group cannot displace the others and fetches only
+/// contend with writes to the same bucket.
+/// Each bucket counts its addresses by network group, so a fetch that
+/// excludes network groups skips buckets of only excluded groups and
+/// passes over excluded addresses within a bucket without retries.
 class BCT_API hosts
   : noncopyable
 {
@@ -43,6 +60,7 @@ public:
     typedef std::shared_ptr<hosts> ptr;
     typedef message::network_address address;
     typedef handle0 result_handler;
+    typedef std::unordered_set<uint32_t> groups;
 
     /// Construct an instance.
     hosts(const settings& settings);
@@ -53,26 +71,122 @@ public:
     // Save hosts to file.
     virtual code stop();
 
+    /// Save hosts to file if changed since the last save, while running.
+    virtual code save();
+
     virtual size_t count() const;
     virtual code fetch(address& out) const;
+
+    /// Fetch an address that is not within any of the excluded groups.
+    virtual code fetch(address& out, const groups& excluded) const;
+
+    /// Fetch up to the maximum number of addresses, sampled over buckets.
+    virtual code fetch(address::list& out, size_t maximum) const;
     virtual code remove(const address& host);
     virtual code store(const address& host);
     virtual void store(const address::list& hosts, result_handler handler);
 
+    /// Record a successful connection, moving the address to tried.
+    virtual code promote(const address& host);
+
+    /// Record a failed connection attempt.
+    virtual code demote(const address& host);
+
+    /// Record the observed round trip latency of an address.
+    virtual code rate(const address& host, uint32_t milliseconds);
+
+    /// The network group of the address, /16 for ipv4 and /32 for ipv6.
+    static uint32_t group(const address& host);
+
 private:
-    typedef boost::circular_buffer<address> list;
-    typedef list::iterator iterator;
+    struct address_hash
+    {
+        size_t operator()(const address& host) const;
+    };
+
+    struct address_equal
+    {
+        bool operator()(const address& left, const address& right) const;
+    };
+
+    struct entry
+    {
+        address host;
+        size_t attempts;
 
-    iterator find(const address& host);
+        // Round trip in milliseconds, zero if unknown (not persisted).
+        uint32_t latency;
+    };
 
-    // These are protected by a mutex.
-    list buffer_;
+    struct location
+    {
+        bool tried;
+        size_t position;
+    };
+
+    typedef std::vector<entry> list;
+    typedef std::unordered_map<address, location, address_hash,
+        address_equal> index;
+    typedef std::unordered_map<uint32_t, size_t> group_counts;
+
+    // The members of each bucket are protected by its mutex.
+    struct bucket
+    {
+        list fresh;
+        list tried;
+        index table;
+        group_counts groups;
+        size_t next_fresh;
+        size_t next_tried;
+        mutable upgrade_mutex mutex;
+    };
+
+    typedef std::unique_ptr<bucket> bucket_ptr;
+    typedef std::vector<bucket_ptr> buckets;
+
+    static size_t bucket_count(size_t capacity);
+    static size_t bucket_capacity(size_t capacity);
+    static buckets make_buckets(size_t capacity);
+    static const entry& better(const entry& one, const entry& two);
+    static const entry* eligible(const list& table, const groups& excluded);
+    static bool eligible(const bucket& part, const groups& excluded);
+    static void count(bucket& part, const address& host);
+    static void uncount(bucket& part, const address& host);
+
+    size_t group_hash(const address& host) const;
+    bucket& select(const address& host) const;
+    void add(bucket& part, const entry& item, bool tried);
+    void drop(bucket& part, const location& item);
+    bool insert(const address& host);
+    bool insert(const entry& item, bool tried);
+    bool erase(const address& host);
+    void clear();
+
+    void load_file();
+    code save_file() const;
+    void load_text(const data_chunk& data);
+    void load_binary(const data_chunk& data);
+    data_chunk to_text() const;
+    data_chunk to_binary() const;
+
+    const uint64_t key_;
+    const size_t capacity_;
+    const size_t tried_capacity_;
+    const size_t fresh_capacity_;
+    const buckets buckets_;
+
+    // Writers share this mutex, start and stop hold it exclusively.
     std::atomic<bool> stopped_;
+    std::atomic<bool> dirty_;
     mutable upgrade_mutex mutex_;
 
+    // This serializes writes of the hosts file.
+    mutable upgrade_mutex file_mutex_;
+
     // HACK: we use this because the buffer capacity cannot be set to zero.
     const bool disabled_;
     const boost::filesystem::path file_path_;
+    const bool text_file_;
 };
 
 } // namespace network
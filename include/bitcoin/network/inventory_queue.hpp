@@ -0,0 +1,70 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_INVENTORY_QUEUE_HPP
+#define LIBBITCOIN_NETWORK_INVENTORY_QUEUE_HPP
+
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/rolling_bloom.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The inventory pending announcement to a peer, and a filter of the
+/// inventory known to the peer, whether announced to it or by it.
+/// Announcement of known inventory is suppressed.
+class BCT_API inventory_queue
+  : noncopyable
+{
+public:
+    typedef message::inventory_vector::list list;
+
+    /// Construct an instance.
+    /// @param[in]  known_capacity  The number of known hashes remembered.
+    inventory_queue(size_t known_capacity);
+
+    /// Queue those items that are not known to the peer, and mark them.
+    /// Returns the number of items queued.
+    virtual size_t enqueue(const list& items);
+
+    /// Mark items as known to the peer, such as those announced by it.
+    virtual void known(const list& items);
+
+    /// Determine if the hash is (probably) known to the peer.
+    virtual bool is_known(const hash_digest& hash) const;
+
+    /// Remove up to the maximum number of queued items, oldest first.
+    virtual list dequeue(size_t maximum);
+
+    /// The number of queued items.
+    virtual size_t size() const;
+
+private:
+    // These are protected by mutex.
+    rolling_bloom known_;
+    list pending_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_LAZY_BLOCK_HPP
+#define LIBBITCOIN_NETWORK_LAZY_BLOCK_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A block message that defers transaction deserialization.
+/// Loading parses only the header and transaction count and retains the
+/// serialized transactions, so the channel resumes reading without paying
+/// for transaction parsing. Transactions are located and decoded on demand,
+/// individually (for example in parallel) or all together as a block.
+/// Subscribe to this type in place of message::block, not in addition to it.
+class BCT_API lazy_block
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<lazy_block> ptr;
+    typedef std::shared_ptr<const lazy_block> const_ptr;
+    typedef std::vector<size_t> offsets;
+
+    static const std::string command;
+    static const uint32_t version_minimum;
+    static const uint32_t version_maximum;
+
+    lazy_block();
+
+    /// Load the header and retain the serialized transactions.
+    bool from_data(uint32_t version, reader& source);
+
+    /// True if loaded successfully.
+    bool is_valid() const;
+
+    /// The block header.
+    const chain::header& header() const;
+
+    /// The number of transactions indicated by the message.
+    size_t transaction_count() const;
+
+    /// The serialized transactions (excluding the count).
+    const data_chunk& transactions_data() const;
+
+    /// Locate transaction boundaries without deserializing, idempotent.
+    /// Returns false if the transactions are not well formed.
+    bool index() const;
+
+    /// Deserialize the transaction at the position, indexing as necessary.
+    bool transaction(size_t position, chain::transaction& out) const;
+
+    /// Deserialize all transactions, returns nullptr if not well formed.
+    message::block::ptr block() const;
+
+private:
+    static size_t skip_transaction(reader& source);
+
+    chain::header header_;
+    size_t count_;
+    data_chunk body_;
+    bool valid_;
+
+    // These are protected by mutex.
+    mutable bool indexed_;
+    mutable bool index_valid_;
+    mutable offsets offsets_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,46 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_LOGGING_HPP
+#define LIBBITCOIN_NETWORK_LOGGING_HPP
+
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+// Logging for per-message paths (proxy, channel and protocols).
+// The verbose statement must be made where a verbose() member is in scope
+// (proxy and protocol), so that each channel reads its own settings.
+// Statement arguments are not evaluated unless verbose() returns true.
+// Defining BCT_DISABLE_VERBOSE_LOG compiles verbose and debug statements out
+// entirely, though they remain type checked.
+// The if/else form admits a trailing stream and never captures an else.
+#define NETWORK_LOG_IF(condition, statement) \
+    if (!(condition)) {} else statement
+
+#ifdef BCT_DISABLE_VERBOSE_LOG
+    #define NETWORK_LOG_VERBOSE(module) \
+        NETWORK_LOG_IF(false, LOG_VERBOSE(module))
+    #define NETWORK_LOG_DEBUG(module) \
+        NETWORK_LOG_IF(false, LOG_DEBUG(module))
+#else
+    #define NETWORK_LOG_VERBOSE(module) \
+        NETWORK_LOG_IF(verbose(), LOG_VERBOSE(module))
+    #define NETWORK_LOG_DEBUG(module) LOG_DEBUG(module)
+#endif
+
+#endif
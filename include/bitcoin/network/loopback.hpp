@@ -0,0 +1,83 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_LOOPBACK_HPP
+#define LIBBITCOIN_NETWORK_LOOPBACK_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/transport.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// An in-memory network of listening ports, shared by nodes simulated in one
+/// process (see loopback_connector and loopback_acceptor). Connections are
+/// pairs of pipe transports, so no sockets, resolution or timers are used.
+/// Hostnames are ignored, each simulated node listens on a distinct port.
+class BCT_API loopback
+  : noncopyable
+{
+public:
+    typedef std::function<void(const code&, transport::ptr)>
+        transport_handler;
+
+    /// Construct an instance.
+    /// @param[in]  pool  The threadpool on which handlers are invoked.
+    loopback(threadpool& pool);
+
+    /// Start listening on the port, fails if the port is in use.
+    virtual code listen(uint16_t port);
+
+    /// Stop listening on the port, canceling a pending accept.
+    virtual void unlisten(uint16_t port);
+
+    /// Accept the next connection to the port, one accept at a time.
+    virtual void accept(uint16_t port, transport_handler handler);
+
+    /// Connect to the port, fails if there is no listener.
+    virtual void connect(uint16_t port, transport_handler handler);
+
+private:
+    struct listener
+    {
+        std::deque<transport::ptr> connections;
+        transport_handler handler;
+    };
+
+    typedef std::map<uint16_t, listener> listeners;
+
+    // These are thread safe.
+    threadpool& pool_;
+    mutable dispatcher dispatch_;
+
+    // These are protected by mutex.
+    uint16_t next_port_;
+    listeners listeners_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
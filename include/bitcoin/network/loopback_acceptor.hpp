@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_LOOPBACK_ACCEPTOR_HPP
+#define LIBBITCOIN_NETWORK_LOOPBACK_ACCEPTOR_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/acceptor.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_pools.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/loopback.hpp>
+#include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
+#include <bitcoin/network/transport.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// Create inbound connections over an in-memory loopback network.
+/// Return from p2p::create_acceptor to simulate peers in process.
+class BCT_API loopback_acceptor
+  : public acceptor
+{
+public:
+    typedef std::shared_ptr<loopback_acceptor> ptr;
+
+    /// Construct an instance.
+    loopback_acceptor(loopback& network, threadpool& pool,
+        channel_pools& pools, buffer_pool& buffers, timer_wheel& timers,
+        admission& admission, const settings& settings);
+
+    /// Validate acceptor stopped.
+    ~loopback_acceptor();
+
+    /// Start the listener on the specified loopback port.
+    code listen(uint16_t port) override;
+
+    /// Accept the next connection available, until canceled.
+    void accept(accept_handler handler) override;
+
+    /// Cancel outstanding accept attempt.
+    void stop(const code& ec) override;
+
+protected:
+    bool stopped() const override;
+
+private:
+    void handle_accept(const code& ec, transport::ptr transport,
+        accept_handler handler);
+
+    // These are thread safe.
+    loopback& network_;
+    std::atomic<bool> listening_;
+    std::atomic<uint16_t> port_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
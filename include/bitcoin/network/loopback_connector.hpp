@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_LOOPBACK_CONNECTOR_HPP
+#define LIBBITCOIN_NETWORK_LOOPBACK_CONNECTOR_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_pools.hpp>
+#include <bitcoin/network/connector.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/loopback.hpp>
+#include <bitcoin/network/resolver_cache.hpp>
+#include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
+#include <bitcoin/network/transport.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// Create outbound connections over an in-memory loopback network.
+/// Return from p2p::create_connector to simulate peers in process.
+class BCT_API loopback_connector
+  : public connector
+{
+public:
+    typedef std::shared_ptr<loopback_connector> ptr;
+
+    /// Construct an instance.
+    loopback_connector(loopback& network, threadpool& pool,
+        channel_pools& pools, buffer_pool& buffers, timer_wheel& timers,
+        resolver_cache& resolver, const settings& settings);
+
+    /// Try to connect to the port of host:port, the host is ignored.
+    void connect(const std::string& hostname, uint16_t port,
+        connect_handler handler) override;
+
+private:
+    void handle_connect(const code& ec, transport::ptr transport,
+        connect_handler handler);
+
+    // This is thread safe.
+    loopback& network_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_MESSAGE_CAPTURE_HPP
+#define LIBBITCOIN_NETWORK_MESSAGE_CAPTURE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A bounded ring of the messages sent and received on a channel, for the
+/// forensic capture of selected peers. The oldest messages are discarded
+/// once the retained payload bytes exceed the capacity. Sent payloads are
+/// shared with the send queue, received payloads are copied.
+/// The file is a magic number followed by records of a timestamp (uint64
+/// microseconds since the epoch), a direction byte and the message in wire
+/// form (heading and payload). Checksums are computed only upon save.
+class BCT_API message_capture
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<message_capture> ptr;
+    typedef std::shared_ptr<const std::string> command_ptr;
+    typedef std::shared_ptr<const data_chunk> payload_ptr;
+
+    enum class direction : uint8_t
+    {
+        received = 0,
+        sent = 1
+    };
+
+    struct record
+    {
+        typedef std::vector<record> list;
+
+        uint64_t timestamp;
+        message_capture::direction direction;
+        message::heading heading;
+        data_chunk payload;
+    };
+
+    /// Read a capture file, false if it is missing or malformed.
+    static bool load(const boost::filesystem::path& file, record::list& out);
+
+    /// Construct an instance.
+    /// @param[in]  capacity  The maximum retained payload bytes.
+    /// @param[in]  magic     The network magic of saved headings.
+    message_capture(size_t capacity, uint32_t magic);
+
+    /// Capture a received message (the payload is copied).
+    void received(const std::string& command, const data_slice& payload);
+
+    /// Capture a sent message (the payload is shared).
+    void sent(command_ptr command, payload_ptr payload);
+
+    /// The number of messages retained.
+    size_t size() const;
+
+    /// Write the retained messages to the file, oldest first.
+    code save(const boost::filesystem::path& file) const;
+
+private:
+    struct entry
+    {
+        uint64_t timestamp;
+        message_capture::direction direction;
+        command_ptr command;
+        payload_ptr payload;
+    };
+
+    void push(entry&& item);
+
+    const size_t capacity_;
+    const uint32_t magic_;
+
+    // These are protected by mutex.
+    std::deque<entry> entries_;
+    size_t bytes_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -19,131 +19,86 @@
 #ifndef LIBBITCOIN_NETWORK_MESSAGE_SUBSCRIBER_HPP
 #define LIBBITCOIN_NETWORK_MESSAGE_SUBSCRIBER_HPP
 
-#include <istream>
 #include <functional>
-#include <map>
 #include <memory>
 #include <utility>
 #include <string>
+#include <unordered_map>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
 
 namespace libbitcoin {
 namespace network {
 
-#define DEFINE_SUBSCRIBER_TYPE(value) \
-    typedef resubscriber<code, message::value::const_ptr> \
-        value##_subscriber_type
-
-#define DEFINE_SUBSCRIBER_OVERLOAD(value) \
-    template <typename Handler> \
-    void subscribe(message::value&&, Handler&& handler) \
-    { \
-        value##_subscriber_->subscribe(std::forward<Handler>(handler), \
-            error::channel_stopped, {}); \
-    }
-
-#define DECLARE_SUBSCRIBER(value) \
-    value##_subscriber_type::ptr value##_subscriber_
-
 template <class Message>
 using message_handler =
     std::function<bool(const code&, std::shared_ptr<const Message>)>;
 
 /// Aggregation of subscribers by messasge type, thread safe.
+/// Dispatch is by table lookup on the message command. The subscriber for a
+/// message type is created on first subscription, so a channel carries only
+/// the subscribers of the message types that its protocols handle.
 class BCT_API message_subscriber
   : noncopyable
 {
 public:
-    DEFINE_SUBSCRIBER_TYPE(address);
-    DEFINE_SUBSCRIBER_TYPE(alert);
-    DEFINE_SUBSCRIBER_TYPE(block);
-    DEFINE_SUBSCRIBER_TYPE(block_transactions);
-    DEFINE_SUBSCRIBER_TYPE(compact_block);
-    DEFINE_SUBSCRIBER_TYPE(fee_filter);
-    DEFINE_SUBSCRIBER_TYPE(filter_add);
-    DEFINE_SUBSCRIBER_TYPE(filter_clear);
-    DEFINE_SUBSCRIBER_TYPE(filter_load);
-    DEFINE_SUBSCRIBER_TYPE(get_address);
-    DEFINE_SUBSCRIBER_TYPE(get_blocks);
-    DEFINE_SUBSCRIBER_TYPE(get_block_transactions);
-    DEFINE_SUBSCRIBER_TYPE(get_data);
-    DEFINE_SUBSCRIBER_TYPE(get_headers);
-    DEFINE_SUBSCRIBER_TYPE(headers);
-    DEFINE_SUBSCRIBER_TYPE(inventory);
-    DEFINE_SUBSCRIBER_TYPE(memory_pool);
-    DEFINE_SUBSCRIBER_TYPE(merkle_block);
-    DEFINE_SUBSCRIBER_TYPE(not_found);
-    DEFINE_SUBSCRIBER_TYPE(ping);
-    DEFINE_SUBSCRIBER_TYPE(pong);
-    DEFINE_SUBSCRIBER_TYPE(reject);
-    DEFINE_SUBSCRIBER_TYPE(send_compact);
-    DEFINE_SUBSCRIBER_TYPE(send_headers);
-    DEFINE_SUBSCRIBER_TYPE(transaction);
-    DEFINE_SUBSCRIBER_TYPE(verack);
-    DEFINE_SUBSCRIBER_TYPE(version);
-
     /**
      * Create an instance of this class.
      * @param[in]  pool  The threadpool to use for sending notifications.
      */
     message_subscriber(threadpool& pool);
 
+    /**
+     * Declare a message type that is not built in (such as an extension).
+     * Messages of undeclared types fail to load with error::not_found.
+     * @param[in]  blocking  Handle before reading the next message.
+     */
+    template <class Message>
+    void declare(bool blocking)
+    {
+        declare(Message::command, { blocking, &validate<Message> });
+    }
+
     /**
      * Subscribe to receive a notification when a message of type is received.
      * The handler is unregistered when the call is made.
      * Subscribing must be immediate, we cannot switch thread contexts.
+     * Subscription to a second type with the same command (such as both
+     * message::block and lazy_block) fails with error::operation_failed.
      * @param[in]  handler  The handler to register.
      */
     template <class Message, typename Handler>
     void subscribe(Handler&& handler)
     {
-        subscribe(Message(), std::forward<Handler>(handler));
+        const auto found = find_or_create(Message::command,
+            &create<Message>);
+
+        if (!found)
+        {
+            handler(error::channel_stopped, {});
+            return;
+        }
+
+        // A command is bound to the first message type subscribed to it.
+        const auto entry = std::dynamic_pointer_cast<subscription<Message>>(
+            found);
+
+        if (!entry)
+        {
+            handler(error::operation_failed, {});
+            return;
+        }
+
+        entry->subscribe(std::forward<Handler>(handler));
     }
 
     /**
-     * Load a stream into a message instance and notify subscribers.
-     * @param[in]  stream      The stream from which to load the message.
-     * @param[in]  version     The peer protocol version.
-     * @param[in]  subscriber  The subscriber for the message type.
-     * @return                 Returns error::bad_stream if failed.
+     * Determine if the command is of a known type that has no subscriber.
+     * A message of such a type may be discarded without being loaded.
+     * @param[in]  command  The payload message command.
      */
-    template <class Message, class Subscriber>
-    code relay(std::istream& stream, uint32_t version,
-        Subscriber& subscriber) const
-    {
-        const auto message = std::make_shared<Message>();
-
-        // Subscribers are invoked only with stop and success codes.
-        if (!message->from_data(version, stream))
-            return error::bad_stream;
-
-        ////const auto const_ptr = std::const_pointer_cast<const Message>(message);
-        subscriber->relay(error::success, message);
-        return error::success;
-    }
-
-    /**
-     * Load a stream into a message instance and invoke subscribers.
-     * @param[in]  stream      The stream from which to load the message.
-     * @param[in]  version     The peer protocol version.
-     * @param[in]  subscriber  The subscriber for the message type.
-     * @return                 Returns error::bad_stream if failed.
-     */
-    template <class Message, class Subscriber>
-    code handle(std::istream& stream, uint32_t version,
-        Subscriber& subscriber) const
-    {
-        const auto message = std::make_shared<Message>();
-
-        // Subscribers are invoked only with stop and success codes.
-        if (!message->from_data(version, stream))
-            return error::bad_stream;
-
-        ////const auto const_ptr = std::const_pointer_cast<const Message>(message);
-        subscriber->invoke(error::success, message);
-        return error::success;
-    }
+    virtual bool unsubscribed(const std::string& command) const;
 
     /**
      * Broadcast a default message instance with the specified error code.
@@ -152,16 +107,16 @@ public:
     virtual void broadcast(const code& ec);
 
     /*
-     * Load a stream of the specified command type.
+     * Load a payload of the specified command.
      * Creates an instance of the indicated message type.
      * Sends the message instance to each subscriber of the type.
-     * @param[in]  type     The stream message type identifier.
+     * @param[in]  command  The payload message command.
      * @param[in]  version  The peer protocol version.
-     * @param[in]  stream   The stream from which to load the message.
+     * @param[in]  source   The reader from which to load the message.
      * @return              Returns error::bad_stream if failed.
      */
-    virtual code load(message::message_type type, uint32_t version,
-        std::istream& stream) const;
+    virtual code load(const std::string& command, uint32_t version,
+        reader& source) const;
 
     /**
      * Start all subscribers so that they accept subscription.
@@ -174,66 +129,124 @@ public:
     virtual void stop();
 
 private:
-    DEFINE_SUBSCRIBER_OVERLOAD(address);
-    DEFINE_SUBSCRIBER_OVERLOAD(alert);
-    DEFINE_SUBSCRIBER_OVERLOAD(block);
-    DEFINE_SUBSCRIBER_OVERLOAD(block_transactions);
-    DEFINE_SUBSCRIBER_OVERLOAD(compact_block);
-    DEFINE_SUBSCRIBER_OVERLOAD(fee_filter);
-    DEFINE_SUBSCRIBER_OVERLOAD(filter_add);
-    DEFINE_SUBSCRIBER_OVERLOAD(filter_clear);
-    DEFINE_SUBSCRIBER_OVERLOAD(filter_load);
-    DEFINE_SUBSCRIBER_OVERLOAD(get_address);
-    DEFINE_SUBSCRIBER_OVERLOAD(get_blocks);
-    DEFINE_SUBSCRIBER_OVERLOAD(get_block_transactions);
-    DEFINE_SUBSCRIBER_OVERLOAD(get_data);
-    DEFINE_SUBSCRIBER_OVERLOAD(get_headers);
-    DEFINE_SUBSCRIBER_OVERLOAD(headers);
-    DEFINE_SUBSCRIBER_OVERLOAD(inventory);
-    DEFINE_SUBSCRIBER_OVERLOAD(memory_pool);
-    DEFINE_SUBSCRIBER_OVERLOAD(merkle_block);
-    DEFINE_SUBSCRIBER_OVERLOAD(not_found);
-    DEFINE_SUBSCRIBER_OVERLOAD(ping);
-    DEFINE_SUBSCRIBER_OVERLOAD(pong);
-    DEFINE_SUBSCRIBER_OVERLOAD(reject);
-    DEFINE_SUBSCRIBER_OVERLOAD(send_compact);
-    DEFINE_SUBSCRIBER_OVERLOAD(send_headers);
-    DEFINE_SUBSCRIBER_OVERLOAD(transaction);
-    DEFINE_SUBSCRIBER_OVERLOAD(verack);
-    DEFINE_SUBSCRIBER_OVERLOAD(version);
-
-    DECLARE_SUBSCRIBER(address);
-    DECLARE_SUBSCRIBER(alert);
-    DECLARE_SUBSCRIBER(block);
-    DECLARE_SUBSCRIBER(block_transactions);
-    DECLARE_SUBSCRIBER(compact_block);
-    DECLARE_SUBSCRIBER(fee_filter);
-    DECLARE_SUBSCRIBER(filter_add);
-    DECLARE_SUBSCRIBER(filter_clear);
-    DECLARE_SUBSCRIBER(filter_load);
-    DECLARE_SUBSCRIBER(get_address);
-    DECLARE_SUBSCRIBER(get_blocks);
-    DECLARE_SUBSCRIBER(get_block_transactions);
-    DECLARE_SUBSCRIBER(get_data);
-    DECLARE_SUBSCRIBER(get_headers);
-    DECLARE_SUBSCRIBER(headers);
-    DECLARE_SUBSCRIBER(inventory);
-    DECLARE_SUBSCRIBER(memory_pool);
-    DECLARE_SUBSCRIBER(merkle_block);
-    DECLARE_SUBSCRIBER(not_found);
-    DECLARE_SUBSCRIBER(ping);
-    DECLARE_SUBSCRIBER(pong);
-    DECLARE_SUBSCRIBER(reject);
-    DECLARE_SUBSCRIBER(send_compact);
-    DECLARE_SUBSCRIBER(send_headers);
-    DECLARE_SUBSCRIBER(transaction);
-    DECLARE_SUBSCRIBER(verack);
-    DECLARE_SUBSCRIBER(version);
-};
+    typedef code (*validator)(uint32_t version, reader& source);
+
+    /// The dispatch properties of a message type.
+    struct descriptor
+    {
+        bool blocking;
+        validator validate;
+    };
+
+    /// The subscriber of one message type, type erased for the table.
+    class entry
+    {
+    public:
+        typedef std::shared_ptr<entry> ptr;
+
+        virtual ~entry() {}
+        virtual code load(uint32_t version, reader& source) const = 0;
+        virtual void broadcast(const code& ec) = 0;
+        virtual void start() = 0;
+        virtual void stop() = 0;
+    };
+
+    template <class Message>
+    class subscription
+      : public entry
+    {
+    public:
+        typedef resubscriber<code, std::shared_ptr<const Message>>
+            subscriber_type;
+
+        subscription(threadpool& pool, bool blocking)
+          : blocking_(blocking),
+            subscriber_(std::allocate_shared<subscriber_type>(
+                pool_allocator<subscriber_type>(), pool,
+                Message::command + "_sub"))
+        {
+        }
+
+        template <typename Handler>
+        void subscribe(Handler&& handler)
+        {
+            subscriber_->subscribe(std::forward<Handler>(handler),
+                error::channel_stopped, {});
+        }
+
+        // Subscribers are invoked only with stop and success codes.
+        // Invocation (versus relay) blocks the peer while handling.
+        // Message instances (with control blocks) are pooled by type.
+        code load(uint32_t version, reader& source) const override
+        {
+            const auto message = std::allocate_shared<Message>(
+                pool_allocator<Message>());
+
+            if (!message->from_data(version, source))
+                return error::bad_stream;
+
+            if (blocking_)
+                subscriber_->invoke(error::success, message);
+            else
+                subscriber_->relay(error::success, message);
+
+            return error::success;
+        }
+
+        void broadcast(const code& ec) override
+        {
+            subscriber_->relay(ec, {});
+        }
+
+        void start() override
+        {
+            subscriber_->start();
+        }
+
+        void stop() override
+        {
+            subscriber_->stop();
+        }
+
+    private:
+        const bool blocking_;
+        typename subscriber_type::ptr subscriber_;
+    };
+
+    typedef entry::ptr (*factory)(threadpool& pool, bool blocking);
+    typedef std::unordered_map<std::string, descriptor> descriptors;
+    typedef std::unordered_map<std::string, entry::ptr> entries;
+
+    template <class Message>
+    static entry::ptr create(threadpool& pool, bool blocking)
+    {
+        return std::allocate_shared<subscription<Message>>(
+            pool_allocator<subscription<Message>>(), pool, blocking);
+    }
+
+    template <class Message>
+    static code validate(uint32_t version, reader& source)
+    {
+        Message message;
+        return message.from_data(version, source) ? error::success :
+            error::bad_stream;
+    }
+
+    static const descriptors& built_in();
+
+    void declare(const std::string& command, const descriptor& value);
+    bool find(const std::string& command, descriptor& out) const;
+    entry::ptr find_or_create(const std::string& command, factory create);
 
-#undef DEFINE_SUBSCRIBER_TYPE
-#undef DEFINE_SUBSCRIBER_OVERLOAD
-#undef DECLARE_SUBSCRIBER
+    threadpool& pool_;
+
+    // These are protected by mutex.
+    bool started_;
+    bool stopped_;
+    descriptors declared_;
+    entries entries_;
+    mutable upgrade_mutex mutex_;
+};
 
 } // namespace network
 } // namespace libbitcoin
@@ -23,19 +23,41 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/acceptor.hpp>
+#include <bitcoin/network/address_cache.hpp>
+#include <bitcoin/network/admission.hpp>
+#include <bitcoin/network/anchors.hpp>
+#include <bitcoin/network/announcement_cache.hpp>
+#include <bitcoin/network/blacklist.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/channel_metrics.hpp>
+#include <bitcoin/network/channel_pools.hpp>
+#include <bitcoin/network/channel_registry.hpp>
+#include <bitcoin/network/compact_block_pool.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/eviction.hpp>
 #include <bitcoin/network/hosts.hpp>
+#include <bitcoin/network/pending_set.hpp>
+#include <bitcoin/network/rate_limiter.hpp>
+#include <bitcoin/network/resolver_cache.hpp>
+#include <bitcoin/network/runtime_settings.hpp>
 #include <bitcoin/network/message_subscriber.hpp>
 #include <bitcoin/network/sessions/session_inbound.hpp>
 #include <bitcoin/network/sessions/session_manual.hpp>
 #include <bitcoin/network/sessions/session_outbound.hpp>
 #include <bitcoin/network/sessions/session_seed.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/statistics_emitter.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
+#include <bitcoin/network/work_scheduler.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -54,6 +76,11 @@ public:
     typedef std::function<void(const code&, const address&)> address_handler;
     typedef std::function<void(const code&, channel::ptr)> channel_handler;
     typedef std::function<bool(const code&, channel::ptr)> connect_handler;
+    typedef std::function<bool(channel::ptr)> channel_predicate;
+
+    template <typename Message>
+    using message_factory =
+        std::function<std::shared_ptr<const Message>(channel::ptr)>;
     typedef subscriber<code> stop_subscriber;
     typedef resubscriber<code, channel::ptr> channel_subscriber;
 
@@ -65,17 +92,82 @@ public:
     void broadcast(const Message& message, channel_handler handle_channel,
         result_handler handle_complete)
     {
-        // Safely copy the channel collection.
-        const auto channels = pending_close_.collection();
+        const auto all = [](channel::ptr) { return true; };
+        broadcast(message, all, handle_channel, handle_complete);
+    }
+
+    /// Send message to the connections that satisfy the predicate.
+    /// Excluded connections incur neither serialization nor a write.
+    template <typename Message>
+    void broadcast(const Message& message, channel_predicate predicate,
+        channel_handler handle_channel, result_handler handle_complete)
+    {
+        broadcast(message, predicate, max_size_t, handle_channel,
+            handle_complete);
+    }
+
+    /// Send message to at most maximum connections that satisfy the
+    /// predicate, sampled at random if more connections qualify.
+    template <typename Message>
+    void broadcast(const Message& message, channel_predicate predicate,
+        size_t maximum, channel_handler handle_channel,
+        result_handler handle_complete)
+    {
+        // Serialization completes before return, so the message is not copied.
+        const std::shared_ptr<const Message> shared(&message,
+            [](const Message*) {});
+        const auto same = [shared](channel::ptr) { return shared; };
+        broadcast_each<Message>(same, predicate, maximum, handle_channel,
+            handle_complete);
+    }
+
+    /// Send the message produced for each of at most maximum connections
+    /// that satisfy the predicate (sampled at random if more qualify).
+    /// A null message skips the connection. Serialization is shared by the
+    /// connections given the same message instance and protocol version.
+    template <typename Message>
+    void broadcast_each(message_factory<Message> factory,
+        channel_predicate predicate, size_t maximum,
+        channel_handler handle_channel, result_handler handle_complete)
+    {
+        typedef std::shared_ptr<const Message> message_ptr;
+        typedef std::pair<channel::ptr, message_ptr> target;
+
+        std::vector<target> targets;
+        for (const auto channel: sample(predicate, maximum))
+        {
+            auto message = factory(channel);
+
+            if (message)
+                targets.emplace_back(channel, std::move(message));
+        }
 
         // Invoke the completion handler after send complete on all channels.
-        const auto join_handler = synchronize(handle_complete, channels.size(),
+        const auto join_handler = synchronize(handle_complete, targets.size(),
             "p2p_join", synchronizer_terminate::on_count);
 
-        // No pre-serialize, channels may have different protocol versions.
-        for (const auto channel: channels)
-            channel->send(message, std::bind(&p2p::handle_send, this,
-                std::placeholders::_1, channel, handle_channel, join_handler));
+        // Channels may have different protocol versions, so serialization is
+        // performed once per distinct message and version, and is shared.
+        const auto command = std::make_shared<const std::string>(
+            Message::command);
+        std::map<std::pair<const Message*, uint32_t>, proxy::payload_ptr>
+            payloads;
+
+        for (const auto& item: targets)
+        {
+            const auto& channel = item.first;
+            const auto version = channel->negotiated_version();
+            auto& payload = payloads[{ item.second.get(), version }];
+
+            if (!payload)
+                payload = std::make_shared<const data_chunk>(
+                    message::serialize(version, *item.second,
+                        settings_.identifier));
+
+            channel->send(command, payload, std::bind(&p2p::handle_send,
+                this, std::placeholders::_1, channel, handle_channel,
+                join_handler));
+        }
     }
 
     // Constructors.
@@ -104,6 +196,15 @@ public:
     /// Returns the result of file save operation.
     virtual bool stop();
 
+    /// Stop accepting and creating connections, save anchors, then stop each
+    /// channel as its send queue empties. Remaining channels are stopped at
+    /// the timeout, and the handler is invoked with the result of stop.
+    virtual void drain(const asio::duration& timeout,
+        result_handler handler);
+
+    /// Determine if the network is draining (or drained) since start.
+    virtual bool draining() const;
+
     /// Blocking call to coalesce all work and then terminate all threads.
     /// Call from thread that constructed this class, or don't call at all.
     /// This calls stop, and start may be reinvoked after calling this.
@@ -115,6 +216,13 @@ public:
     /// Network configuration settings.
     virtual const settings& network_settings() const;
 
+    /// The current snapshot of the reloadable settings.
+    virtual runtime_settings::ptr current_settings() const;
+
+    /// Publish the reloadable subset of settings and apply it to the running
+    /// sessions, without restarting or dropping connections.
+    virtual code reload(const settings& settings);
+
     /// Return the current top block identity.
     virtual config::checkpoint top_block() const;
 
@@ -130,6 +238,75 @@ public:
     /// Return a reference to the network threadpool.
     virtual threadpool& thread_pool();
 
+    /// Return a reference to the pools to which channels are assigned.
+    virtual channel_pools& channel_threads();
+
+    /// Return a reference to the inbound admission control.
+    virtual admission& inbound_admission();
+
+    /// Return a reference to the shared upload rate limiter.
+    virtual rate_limiter& upload_limit();
+
+    /// Return a reference to the shared download rate limiter.
+    virtual rate_limiter& download_limit();
+
+    /// Return a reference to the shared channel receive buffer pool.
+    virtual buffer_pool& receive_buffers();
+
+    /// Return a reference to the scheduler of offloaded channel work.
+    virtual work_scheduler& work_threads();
+
+    /// Return a reference to the shared host name resolution cache.
+    virtual resolver_cache& resolver();
+
+    /// Return a reference to the shared channel and protocol timer wheel.
+    virtual timer_wheel& timers();
+
+    // Inventory relay.
+    // ------------------------------------------------------------------------
+
+    /// Queue inventory for batched announcement to all connections.
+    /// Items known to a peer (announced to or by it) are not announced to it.
+    /// Transactions are not announced to peers that have loaded a filter
+    /// (bip37), as the filter requires the transaction (see below).
+    virtual void relay(const message::inventory_vector::list& items);
+
+    /// Queue an inventory item for batched announcement to all connections.
+    virtual void relay(const message::inventory_vector& item);
+
+    /// Queue a transaction inventory item for batched announcement to the
+    /// connections that do not filter below its fee rate (bip133).
+    virtual void relay(const message::inventory_vector& item,
+        uint64_t fee_rate);
+
+    /// Queue a transaction for batched announcement to the connections that
+    /// do not filter below its fee rate (bip133) and, for peers that have
+    /// loaded a filter, match the filter (bip37). Each filter evaluates
+    /// the transaction once.
+    virtual void relay(const chain::transaction& tx, uint64_t fee_rate);
+
+    /// Get at most maximum connections that satisfy the predicate, sampled
+    /// uniformly at random if more connections qualify.
+    virtual channel_registry::list sample(channel_predicate predicate,
+        size_t maximum) const;
+
+    /// A broadcast predicate selecting connections that do not filter
+    /// transactions of the fee rate (satoshis per kilobyte, bip133).
+    static channel_predicate fee_accepted(uint64_t fee_rate);
+
+    /// Announce a new tip to all connections not known to have it, the last
+    /// header being the tip. Peers that asked for headers (bip130) are sent
+    /// the headers, others an inv of the tip. Each form is serialized once
+    /// per protocol version.
+    virtual void announce(headers_const_ptr headers);
+
+    /// Enable compact block relay (bip152) for subsequent connections.
+    /// Without a pool compact blocks are neither requested nor handled.
+    virtual void set_compact_pool(compact_block_pool::ptr pool);
+
+    /// The pool used by compact block relay, null if not enabled.
+    virtual compact_block_pool::ptr compact_pool() const;
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -168,16 +345,56 @@ public:
     /// Get a randomly-selected address.
     virtual code fetch_address(address& out_address) const;
 
+    /// Get a randomly-selected address outside of the excluded groups.
+    virtual code fetch_address(address& out_address,
+        const hosts::groups& excluded) const;
+
     /// Remove an address.
     virtual code remove(const address& address);
 
+    /// Record a successful connection to an address.
+    virtual code promote(const address& address);
+
+    /// Record a failed connection attempt to an address.
+    virtual code demote(const address& address);
+
+    /// Load (and remove) the anchors saved by the last stop.
+    virtual config::authority::list load_anchors();
+
+    /// The get_address response, sampled from the pool once per interval.
+    virtual address_const_ptr cached_addresses();
+
+    /// Forward addresses to two random connections other than the source,
+    /// of those to which any of the addresses is not known.
+    virtual void forward(const address::list& addresses,
+        const config::authority& source);
+
+    // Bans.
+    // ------------------------------------------------------------------------
+
+    /// Ban the address of the authority, effective for new connections.
+    virtual void ban(const config::authority& authority);
+
+    /// Ban a subnet ("address[/prefix]"), fails with error::operation_failed
+    /// if the subnet is invalid.
+    virtual code ban(const std::string& subnet);
+
+    /// Remove a ban on a subnet, fails with error::not_found if not banned.
+    virtual code unban(const std::string& subnet);
+
     // Pending connect collection.
     // ------------------------------------------------------------------------
 
+    /// Create an acceptor for the inbound session.
+    virtual acceptor::ptr create_acceptor();
+
+    /// Obtain an idle connector, reused if available.
+    virtual connector::ptr create_connector();
+
     /// Store a pending connection reference.
     virtual code pend(connector::ptr connector);
 
-    /// Free a pending connection reference.
+    /// Free a pending connection reference, the connector may be reused.
     virtual void unpend(connector::ptr connector);
 
     // Pending handshake collection.
@@ -198,6 +415,35 @@ public:
     /// Get the number of connections.
     virtual size_t connection_count() const;
 
+    /// Connected channels ordered by average ping round trip, fastest first.
+    /// Channels without a round trip sample are ordered last.
+    virtual channel_registry::list ranked_channels() const;
+
+    /// Stop the least valuable inbound channel to make room for another,
+    /// false if there is no unprotected inbound channel.
+    virtual bool evict();
+
+    // Message capture.
+    // ------------------------------------------------------------------------
+    // Authorities are matched by address only, so inbound peers match.
+
+    /// Begin or end the capture of messages to and from the authority,
+    /// applied to connected channels and to subsequent connections.
+    virtual void set_capture(const config::authority& authority,
+        bool enable);
+
+    /// Begin the capture of the channel if its authority is selected.
+    virtual void capture(channel::ptr channel);
+
+    /// Write the capture of a connected channel of the authority to file,
+    /// error::not_found if there is no such capture.
+    virtual code save_capture(const config::authority& authority,
+        const boost::filesystem::path& file) const;
+
+    /// Traffic and latency counters summed over all channels, including
+    /// those that have been removed.
+    virtual channel_metrics::snapshot metrics() const;
+
     /// Store a connection.
     virtual code store(channel::ptr channel);
 
@@ -223,27 +469,85 @@ protected:
     virtual session_outbound::ptr attach_outbound_session();
 
 private:
-    typedef bc::pending<channel> pending_channels;
-    typedef bc::pending<connector> pending_connectors;
+    typedef channel_registry pending_channels;
+    typedef pending_set<connector> pending_connectors;
 
     void handle_manual_started(const code& ec, result_handler handler);
     void handle_inbound_started(const code& ec, result_handler handler);
+    void handle_inbound_running(const code& ec, result_handler handler);
+    void handle_fast_started(const code& ec, result_handler handler);
+    void handle_seeded(const code& ec);
+    void load_hosts(result_handler handler);
     void handle_hosts_loaded(const code& ec, result_handler handler);
     void handle_hosts_saved(const code& ec, result_handler handler);
+    void start_hosts_flush();
+    void handle_hosts_flush(const code& ec);
+    void start_statistics();
+    void handle_statistics(const code& ec);
+    void handle_drain(const code& ec, result_handler handler);
+    void handle_relay(const code& ec, channel::ptr channel);
     void handle_send(const code& ec, channel::ptr channel,
         channel_handler handle_channel, result_handler handle_complete);
 
     void handle_started(const code& ec, result_handler handler);
     void handle_running(const code& ec, result_handler handler);
+    bool valid_versions() const;
+    void preallocate_connectors();
+    void stop_idle_connectors();
+    void save_anchors();
 
     // These are thread safe.
     const settings& settings_;
     std::atomic<bool> stopped_;
+    std::atomic<bool> draining_;
     bc::atomic<config::checkpoint> top_block_;
+    bc::atomic<runtime_settings::ptr> runtime_;
     bc::atomic<session_manual::ptr> manual_;
+    bc::atomic<session_inbound::ptr> inbound_;
+    bc::atomic<session_outbound::ptr> outbound_;
+    bc::atomic<compact_block_pool::ptr> compact_pool_;
     threadpool threadpool_;
+    channel_pools channel_pools_;
+    buffer_pool buffers_;
+    work_scheduler work_scheduler_;
+    timer_wheel timers_;
+    resolver_cache resolver_;
     hosts hosts_;
+    address_cache address_cache_;
+    anchors anchors_;
+    blacklist blacklist_;
+    admission admission_;
+    eviction eviction_;
+    rate_limiter upload_limiter_;
+    rate_limiter download_limiter_;
+    announcement_cache tip_announcement_;
+    deadline::ptr hosts_flush_;
+    deadline::ptr statistics_timer_;
+    deadline::ptr drain_timer_;
     pending_connectors pending_connect_;
+    dispatcher dispatch_;
+
+    // These are protected by idle_mutex_.
+    std::vector<connector::ptr> idle_connectors_;
+    mutable upgrade_mutex idle_mutex_;
+
+    // This serializes reloads.
+    mutable upgrade_mutex reload_mutex_;
+
+    // These are protected by capture_mutex_.
+    std::set<asio::ipv6> captures_;
+    mutable upgrade_mutex capture_mutex_;
+
+    // These are protected by metrics_mutex_.
+    channel_metrics::snapshot retired_metrics_;
+    mutable upgrade_mutex metrics_mutex_;
+
+    // This is protected by statistics timer sequencing.
+    statistics_emitter statistics_;
+
+    // This is protected by drain timer sequencing.
+    asio::time_point drain_deadline_;
+
     pending_channels pending_handshake_;
     pending_channels pending_close_;
     stop_subscriber::ptr stop_subscriber_;
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PENDING_SET_HPP
+#define LIBBITCOIN_NETWORK_PENDING_SET_HPP
+
+#include <cstddef>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A hashed collection of pending objects, with O(1) store and remove.
+/// Element must provide stop(const code&), which is invoked upon stop.
+template <class Element>
+class pending_set
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<Element> element_ptr;
+
+    /// Construct an instance.
+    pending_set(size_t initial_capacity)
+      : stopped_(false)
+    {
+        elements_.reserve(initial_capacity);
+    }
+
+    /// The number of elements in the set.
+    size_t size() const
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(mutex_);
+
+        return elements_.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    /// Store an element, fails if stopped.
+    code store(element_ptr element)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(mutex_);
+
+        if (stopped_)
+            return error::service_stopped;
+
+        elements_.insert(element);
+        return error::success;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    /// Remove an element if it exists.
+    void remove(element_ptr element)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(mutex_);
+
+        elements_.erase(element);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    /// Stop all elements and prevent subsequent store.
+    void stop(const code& ec)
+    {
+        std::vector<element_ptr> stopping;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock();
+
+        stopped_ = true;
+        stopping.assign(elements_.begin(), elements_.end());
+        elements_.clear();
+
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        // Elements are stopped outside of the lock, as stop may remove.
+        for (const auto& element: stopping)
+            element->stop(ec);
+    }
+
+private:
+    // These are protected by mutex.
+    bool stopped_;
+    std::unordered_set<element_ptr> elements_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
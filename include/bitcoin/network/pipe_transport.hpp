@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PIPE_TRANSPORT_HPP
+#define LIBBITCOIN_NETWORK_PIPE_TRANSPORT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/transport.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// One end of an in-memory byte stream, for simulating peers in process.
+/// Writes are buffered by the reading end without limit and complete
+/// immediately. Stopping either end ends the stream of the other.
+class BCT_API pipe_transport
+  : public transport
+{
+public:
+    typedef std::shared_ptr<pipe_transport> ptr;
+    typedef std::pair<ptr, ptr> pair;
+
+    /// Create a connected pair of ends.
+    /// @param[in]  pool    The threadpool on which handlers are invoked.
+    /// @param[in]  first   The authority reported by the first end.
+    /// @param[in]  second  The authority reported by the second end.
+    static pair create(threadpool& pool, const config::authority& first,
+        const config::authority& second);
+
+    /// Construct an unconnected end, use create to obtain connected ends.
+    pipe_transport(threadpool& pool, const config::authority& authority);
+
+    config::authority authority() const override;
+    void read_some(const boost::asio::mutable_buffer& buffer,
+        io_handler handler) override;
+    void read(const boost::asio::mutable_buffer& buffer,
+        io_handler handler) override;
+    void write(const const_buffers& buffers, io_handler handler) override;
+    void stop() override;
+
+private:
+    void start_read(const boost::asio::mutable_buffer& buffer, bool exact,
+        io_handler handler);
+    bool receive(const const_buffers& buffers);
+    void close();
+    void complete(io_handler& handler, boost_code& ec, size_t& size);
+
+    // These are thread safe.
+    const config::authority authority_;
+    mutable dispatcher dispatch_;
+
+    // These are protected by mutex.
+    std::weak_ptr<pipe_transport> peer_;
+    data_chunk inbound_;
+    uint8_t* read_data_;
+    size_t read_size_;
+    size_t read_filled_;
+    bool read_exact_;
+    io_handler read_handler_;
+    bool closed_;
+    bool stopped_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_POOL_ALLOCATOR_HPP
+#define LIBBITCOIN_NETWORK_POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// An allocator of single objects from a free list shared by all allocators
+/// of the type. Used with std::allocate_shared the object and its control
+/// block are recycled as one block, so that a parsed message costs no heap
+/// allocation once the list is warm. Array allocations are not pooled.
+template <typename Type>
+class pool_allocator
+{
+public:
+    typedef Type value_type;
+
+    template <typename Other>
+    struct rebind
+    {
+        typedef pool_allocator<Other> other;
+    };
+
+    pool_allocator()
+    {
+    }
+
+    template <typename Other>
+    pool_allocator(const pool_allocator<Other>&)
+    {
+    }
+
+    Type* allocate(size_t count)
+    {
+        if (count == 1)
+        {
+            auto& list = blocks();
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            list.mutex.lock();
+
+            if (!list.free.empty())
+            {
+                const auto block = list.free.back();
+                list.free.pop_back();
+                list.mutex.unlock();
+                //-------------------------------------------------------------
+                return static_cast<Type*>(block);
+            }
+
+            list.mutex.unlock();
+            ///////////////////////////////////////////////////////////////////
+        }
+
+        return static_cast<Type*>(::operator new(count * sizeof(Type)));
+    }
+
+    void deallocate(Type* pointer, size_t count)
+    {
+        if (count == 1)
+        {
+            auto& list = blocks();
+
+            // Critical Section
+            ///////////////////////////////////////////////////////////////////
+            list.mutex.lock();
+
+            if (list.free.size() < retained)
+            {
+                list.free.push_back(pointer);
+                list.mutex.unlock();
+                //-------------------------------------------------------------
+                return;
+            }
+
+            list.mutex.unlock();
+            ///////////////////////////////////////////////////////////////////
+        }
+
+        ::operator delete(pointer);
+    }
+
+private:
+    // The number of free blocks retained per type.
+    static const size_t retained = 64;
+
+    struct free_list
+    {
+        // Retained blocks are released on process exit.
+        ~free_list()
+        {
+            for (const auto block: free)
+                ::operator delete(block);
+        }
+
+        std::vector<void*> free;
+        upgrade_mutex mutex;
+    };
+
+    static free_list& blocks()
+    {
+        static free_list list;
+        return list;
+    }
+};
+
+template <typename Left, typename Right>
+bool operator==(const pool_allocator<Left>&, const pool_allocator<Right>&)
+{
+    return true;
+}
+
+template <typename Left, typename Right>
+bool operator!=(const pool_allocator<Left>&, const pool_allocator<Right>&)
+{
+    return false;
+}
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
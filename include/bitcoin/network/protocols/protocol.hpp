@@ -24,6 +24,7 @@
 #include <string>
 #include <utility>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/bloom_filter.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
 
@@ -114,9 +115,49 @@ protected:
     /// Set the negotiated protocol version.
     virtual void set_negotiated_version(uint32_t value);
 
-    /// Get the threadpool.
+    /// Get the channel traffic and latency counters.
+    virtual channel_metrics& metrics();
+
+    /// Set the peer preference for block announcement by headers.
+    virtual void set_headers_preferred(bool value);
+
+    /// Set the peer minimum fee rate for transaction relay (bip133).
+    virtual void set_fee_filter(uint64_t value);
+
+    /// Get the peer transaction filter (bip37), null if none.
+    virtual bloom_filter::ptr filter() const;
+
+    /// Set the peer transaction filter (bip37), null to clear.
+    virtual void set_filter(bloom_filter::ptr value);
+
+    /// True if the peer accepts transaction announcements.
+    virtual bool peer_relay() const;
+
+    /// Enable transaction announcements to the peer (bip37).
+    virtual void enable_peer_relay();
+
+    /// Record receipt of novel inventory from the peer (protects the
+    /// channel from inbound eviction).
+    virtual void set_useful();
+
+    /// Get the inventory pending announcement to and known by the peer.
+    virtual inventory_queue& announcements();
+
+    /// Get the get_data requests outstanding to the peer.
+    virtual request_tracker& requests();
+
+    /// Mark addresses as known to the peer, so they are not forwarded to it.
+    virtual void known_addresses(const message::network_address::list& list);
+
+    /// Get the threadpool of the channel.
     virtual threadpool& pool();
 
+    /// True if verbose log statements are evaluated for the channel.
+    virtual bool verbose() const;
+
+    /// Hold sends on the channel until the session releases them.
+    virtual void cork();
+
     /// Stop the channel (and the protocol).
     virtual void stop(const code& ec);
 
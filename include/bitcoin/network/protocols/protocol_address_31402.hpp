@@ -19,6 +19,7 @@
 #ifndef LIBBITCOIN_NETWORK_PROTOCOL_ADDRESS_31402_HPP
 #define LIBBITCOIN_NETWORK_PROTOCOL_ADDRESS_31402_HPP
 
+#include <cstddef>
 #include <memory>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
@@ -63,6 +64,14 @@ protected:
 
     p2p& network_;
     const message::address self_;
+
+private:
+    size_t admit(size_t count);
+
+    // These are protected by mutex.
+    double tokens_;
+    asio::time_point updated_;
+    mutable upgrade_mutex mutex_;
 };
 
 } // namespace network
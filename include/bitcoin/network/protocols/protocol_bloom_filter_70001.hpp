@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PROTOCOL_BLOOM_FILTER_70001_HPP
+#define LIBBITCOIN_NETWORK_PROTOCOL_BLOOM_FILTER_70001_HPP
+
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+class p2p;
+
+/**
+ * Bloom filter protocol (bip37), serving SPV peers.
+ * Installs the filter loaded by the peer on its channel, so that relay of
+ * transactions to the peer is limited to those that match. A filter that
+ * exceeds bip37 limits stops the channel as misbehaving. If the bloom
+ * service is not advertised, filters are not served and a peer of at least
+ * bip111 that sends one is stopped as misbehaving.
+ * Attach this to a channel immediately following handshake completion,
+ * if the negotiated version is at least bip37.
+ */
+class BCT_API protocol_bloom_filter_70001
+  : public protocol_events, track<protocol_bloom_filter_70001>
+{
+public:
+    typedef std::shared_ptr<protocol_bloom_filter_70001> ptr;
+
+    /**
+     * Construct a bloom filter protocol instance.
+     * @param[in]  network   The network interface.
+     * @param[in]  channel   The channel on which to start the protocol.
+     * @param[in]  serve     Serve filters (the bloom service is advertised).
+     */
+    protocol_bloom_filter_70001(p2p& network, channel::ptr channel,
+        bool serve);
+
+    /**
+     * Start the protocol.
+     */
+    virtual void start();
+
+protected:
+    virtual void handle_stop(const code& ec);
+
+    virtual bool handle_receive_filter_load(const code& ec,
+        filter_load_const_ptr message);
+    virtual bool handle_receive_filter_add(const code& ec,
+        filter_add_const_ptr message);
+    virtual bool handle_receive_filter_clear(const code& ec,
+        filter_clear_const_ptr message);
+
+private:
+    bool unserved();
+
+    const bool serve_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PROTOCOL_COMPACT_BLOCK_70014_HPP
+#define LIBBITCOIN_NETWORK_PROTOCOL_COMPACT_BLOCK_70014_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/compact_block_pool.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+class p2p;
+
+/**
+ * Compact block relay protocol (bip152).
+ * Negotiates compact block relay and reconstructs compact blocks from the
+ * pool, requesting missing transactions and falling back to the full block
+ * when short ids collide or the merkle root does not match. Serves the
+ * transactions of stored blocks to the peer on request.
+ * Attach this to a channel immediately following handshake completion,
+ * if the negotiated version is at least bip152.
+ */
+class BCT_API protocol_compact_block_70014
+  : public protocol_events, track<protocol_compact_block_70014>
+{
+public:
+    typedef std::shared_ptr<protocol_compact_block_70014> ptr;
+    typedef std::vector<uint64_t> indexes;
+
+    /**
+     * Construct a compact block protocol instance.
+     * @param[in]  network         The network interface.
+     * @param[in]  channel         The channel on which to start the protocol.
+     * @param[in]  pool            The transaction pool and block store.
+     * @param[in]  high_bandwidth  Ask the peer to push compact blocks
+     *                             before validation (high bandwidth mode),
+     *                             otherwise they are announced and fetched.
+     */
+    protocol_compact_block_70014(p2p& network, channel::ptr channel,
+        compact_block_pool::ptr pool, bool high_bandwidth);
+
+    /**
+     * Start the protocol.
+     */
+    virtual void start();
+
+    /**
+     * Differentially encode transaction indexes (bip152).
+     * @param[in]  values  The strictly ascending indexes to encode.
+     * @return             Each the difference from the previous index + 1.
+     */
+    static indexes encode(const indexes& values);
+
+    /**
+     * Decode differentially encoded transaction indexes (bip152).
+     * @param[out] out          The decoded indexes.
+     * @param[in]  differences  The encoded indexes.
+     * @param[in]  count        The number of transactions indexed.
+     * @return                  False if an index is not below the count.
+     */
+    static bool decode(indexes& out, const indexes& differences,
+        size_t count);
+
+protected:
+    virtual void handle_stop(const code& ec);
+
+    virtual bool handle_receive_send_compact(const code& ec,
+        send_compact_const_ptr message);
+    virtual bool handle_receive_compact_block(const code& ec,
+        compact_block_const_ptr message);
+    virtual bool handle_receive_block_transactions(const code& ec,
+        block_transactions_const_ptr message);
+    virtual bool handle_receive_get_block_transactions(const code& ec,
+        get_block_transactions_const_ptr message);
+
+private:
+    typedef compact_block_pool::transaction_list transaction_list;
+
+    uint64_t compact_version() const;
+    void request_block(const hash_digest& hash);
+    void complete(const chain::header& header,
+        transaction_list&& transactions);
+    void handle_fetch(const code& ec, block_const_ptr block,
+        get_block_transactions_const_ptr request);
+
+    // These are thread safe.
+    const compact_block_pool::ptr pool_;
+    const bool high_bandwidth_;
+    const uint64_t version_;
+    std::atomic<uint64_t> peer_compact_version_;
+
+    // These are protected by mutex.
+    hash_digest pending_hash_;
+    chain::header pending_header_;
+    transaction_list pending_;
+    indexes missing_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
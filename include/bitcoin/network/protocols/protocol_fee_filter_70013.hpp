@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PROTOCOL_FEE_FILTER_70013_HPP
+#define LIBBITCOIN_NETWORK_PROTOCOL_FEE_FILTER_70013_HPP
+
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+class p2p;
+
+/**
+ * Fee filter protocol (bip133).
+ * Sends the configured minimum fee rate (if any) and records the rate sent
+ * by the peer, so that transactions below it are not relayed to the peer.
+ * Attach this to a channel immediately following handshake completion,
+ * if the negotiated version is at least bip133.
+ */
+class BCT_API protocol_fee_filter_70013
+  : public protocol_events, track<protocol_fee_filter_70013>
+{
+public:
+    typedef std::shared_ptr<protocol_fee_filter_70013> ptr;
+
+    /**
+     * Construct a fee filter protocol instance.
+     * @param[in]  network   The network interface.
+     * @param[in]  channel   The channel on which to start the protocol.
+     */
+    protocol_fee_filter_70013(p2p& network, channel::ptr channel);
+
+    /**
+     * Start the protocol.
+     */
+    virtual void start();
+
+protected:
+    virtual void handle_stop(const code& ec);
+
+    virtual bool handle_receive_fee_filter(const code& ec,
+        fee_filter_const_ptr message);
+
+    const uint64_t minimum_fee_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -61,6 +61,9 @@ protected:
 
 private:
     std::atomic<bool> pending_;
+
+    // This is protected by pending_ sequencing.
+    asio::time_point sent_;
 };
 
 } // namespace network
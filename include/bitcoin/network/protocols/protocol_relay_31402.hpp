@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PROTOCOL_RELAY_31402_HPP
+#define LIBBITCOIN_NETWORK_PROTOCOL_RELAY_31402_HPP
+
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+class p2p;
+
+/**
+ * Inventory relay protocol.
+ * Announcements queued by p2p::relay are trickled to the peer in batched
+ * inv messages at exponentially-distributed (Poisson) intervals, so that
+ * the timing of announcements across peers does not reveal their origin.
+ * The trickle has its own timer, as the shared timer wheel is too coarse.
+ * Inventory announced by the peer is marked as known to it.
+ * Attach this to a channel immediately following handshake completion.
+ */
+class BCT_API protocol_relay_31402
+  : public protocol_events, track<protocol_relay_31402>
+{
+public:
+    typedef std::shared_ptr<protocol_relay_31402> ptr;
+
+    /**
+     * Construct a relay protocol instance.
+     * @param[in]  network   The network interface.
+     * @param[in]  channel   The channel on which to start the protocol.
+     */
+    protocol_relay_31402(p2p& network, channel::ptr channel);
+
+    /**
+     * Start the protocol.
+     */
+    virtual void start();
+
+protected:
+    virtual void handle_stop(const code& ec);
+    virtual void send_inventory(const code& ec);
+
+    virtual bool handle_receive_inventory(const code& ec,
+        inventory_const_ptr message);
+
+    const settings& settings_;
+
+private:
+    asio::duration next_trickle() const;
+    void start_trickle();
+
+    deadline::ptr trickle_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PROTOCOL_SEND_HEADERS_70012_HPP
+#define LIBBITCOIN_NETWORK_PROTOCOL_SEND_HEADERS_70012_HPP
+
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+class p2p;
+
+/**
+ * Headers announcement protocol (bip130).
+ * Asks the peer to announce blocks by headers, and records whether the
+ * peer asks the same of us, so that p2p::announce sends it headers rather
+ * than inv. Blocks announced by the peer are marked as known to it.
+ * Attach this to a channel immediately following handshake completion,
+ * if the negotiated version is at least bip130.
+ */
+class BCT_API protocol_send_headers_70012
+  : public protocol_events, track<protocol_send_headers_70012>
+{
+public:
+    typedef std::shared_ptr<protocol_send_headers_70012> ptr;
+
+    /**
+     * Construct a send headers protocol instance.
+     * @param[in]  network   The network interface.
+     * @param[in]  channel   The channel on which to start the protocol.
+     */
+    protocol_send_headers_70012(p2p& network, channel::ptr channel);
+
+    /**
+     * Start the protocol.
+     */
+    virtual void start();
+
+protected:
+    virtual void handle_stop(const code& ec);
+
+    virtual bool handle_receive_send_headers(const code& ec,
+        send_headers_const_ptr message);
+    virtual bool handle_receive_headers(const code& ec,
+        headers_const_ptr message);
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_PROTOCOL_STALL_31402_HPP
+#define LIBBITCOIN_NETWORK_PROTOCOL_STALL_31402_HPP
+
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/protocols/protocol_timer.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+class p2p;
+
+/**
+ * Request stall protocol.
+ * Checks the channel's outstanding get_data requests for stall, stopping
+ * the channel upon stall if so configured (otherwise the requester may
+ * bypass the peer). Items the peer reports as not found are canceled.
+ * Attach this to a channel immediately following handshake completion.
+ */
+class BCT_API protocol_stall_31402
+  : public protocol_timer, track<protocol_stall_31402>
+{
+public:
+    typedef std::shared_ptr<protocol_stall_31402> ptr;
+
+    /**
+     * Construct a stall protocol instance.
+     * @param[in]  network   The network interface.
+     * @param[in]  channel   The channel on which to start the protocol.
+     */
+    protocol_stall_31402(p2p& network, channel::ptr channel);
+
+    /**
+     * Start the protocol.
+     */
+    virtual void start();
+
+protected:
+    virtual void handle_timer(const code& ec);
+
+    virtual bool handle_receive_not_found(const code& ec,
+        not_found_const_ptr message);
+
+    const bool disconnect_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
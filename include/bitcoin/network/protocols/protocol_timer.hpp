@@ -19,11 +19,13 @@
 #ifndef LIBBITCOIN_NETWORK_PROTOCOL_TIMER_HPP
 #define LIBBITCOIN_NETWORK_PROTOCOL_TIMER_HPP
 
+#include <atomic>
 #include <string>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
 #include <bitcoin/network/protocols/protocol_events.hpp>
+#include <bitcoin/network/timer_wheel.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -60,12 +62,17 @@ protected:
 protected:
     void reset_timer();
 
+    /// Reset the timer with a new period, call from the event handler.
+    void reset_timer(const asio::duration& timeout);
+
 private:
     void handle_timer(const code& ec);
     void handle_notify(const code& ec, event_handler handler);
 
     const bool perpetual_;
-    deadline::ptr timer_;
+    timer_wheel& timers_;
+    asio::duration timeout_;
+    std::atomic<timer_wheel::token> timer_;
 };
 
 } // namespace network
@@ -19,6 +19,7 @@
 #ifndef LIBBITCOIN_NETWORK_PROTOCOL_VERSION_31402_HPP
 #define LIBBITCOIN_NETWORK_PROTOCOL_VERSION_31402_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -62,7 +63,10 @@ public:
 
     /**
      * Start the protocol.
-     * @param[in]  handler  Invoked upon stop or receipt of version and verack.
+     * The handshake completes upon acceptance of the peer's version, so that
+     * post-handshake messages are pipelined behind the verack. The peer's
+     * verack remains required within the handshake period.
+     * @param[in]  handler  Invoked upon stop or acceptance of version.
      */
     virtual void start(event_handler handler);
 
@@ -75,11 +79,16 @@ protected:
     virtual bool handle_receive_verack(const code& ec, verack_const_ptr);
 
     p2p& network_;
+    std::atomic<bool> version_accepted_;
+    std::atomic<bool> verack_received_;
     const uint32_t own_version_;
     const uint64_t own_services_;
     const uint64_t invalid_services_;
     const uint32_t minimum_version_;
     const uint64_t minimum_services_;
+
+private:
+    void handle_event(const code& ec, event_handler complete);
 };
 
 } // namespace network
@@ -19,32 +19,45 @@
 #ifndef LIBBITCOIN_NETWORK_PROXY_HPP
 #define LIBBITCOIN_NETWORK_PROXY_HPP
 
+#include <array>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/buffer_pool.hpp>
+#include <bitcoin/network/channel_metrics.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/message_capture.hpp>
 #include <bitcoin/network/message_subscriber.hpp>
+#include <bitcoin/network/rate_limiter.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/transport.hpp>
+#include <bitcoin/network/work_scheduler.hpp>
 
 namespace libbitcoin {
 namespace network {
 
-/// Manages all socket communication, thread safe.
+/// Manages all communication over a transport, thread safe.
 class BCT_API proxy
   : public enable_shared_from_base<proxy>, noncopyable
 {
 public:
     typedef std::shared_ptr<proxy> ptr;
+    typedef std::shared_ptr<const std::string> command_ptr;
+    typedef std::shared_ptr<const data_chunk> payload_ptr;
     typedef std::function<void(const code&)> result_handler;
     typedef subscriber<code> stop_subscriber;
+    typedef subscriber<code> writable_subscriber;
 
     /// Construct an instance.
-    proxy(threadpool& pool, socket::ptr socket, const settings& settings);
+    proxy(threadpool& pool, buffer_pool& buffers, transport::ptr transport,
+        const settings& settings);
 
     /// Validate proxy stopped.
     ~proxy();
@@ -54,15 +67,40 @@ public:
     void send(const Message& message, result_handler handler)
     {
         auto data = message::serialize(version_, message, protocol_magic_);
-        const auto payload = std::make_shared<data_chunk>(std::move(data));
-        const auto command = std::make_shared<std::string>(message.command);
-
-        // Sequential dispatch is required because write may occur in multiple
-        // asynchronous steps invoked on different threads, causing deadlocks.
-        dispatch_.lock(&proxy::do_send,
-            shared_from_this(), command, payload, handler);
+        const auto payload = std::make_shared<const data_chunk>(
+            std::move(data));
+        const auto command = std::make_shared<const std::string>(
+            message.command);
+        send(command, payload, handler);
     }
 
+    /// Send a serialized message (heading and payload) on the socket.
+    /// The payload is not copied and may be shared with other channels.
+    /// Messages queued while a write is in progress are written together.
+    /// Control messages are written ahead of announcements and announcements
+    /// ahead of bulk data, so a response is not held behind queued blocks.
+    virtual void send(command_ptr command, payload_ptr payload,
+        result_handler handler);
+
+    /// The number of messages queued or being written to the socket.
+    virtual size_t send_queue_messages() const;
+
+    /// The number of bytes queued or being written to the socket.
+    virtual size_t send_queue_bytes() const;
+
+    /// False if a send has been rejected and the queue has not yet drained.
+    virtual bool writable() const;
+
+    /// Subscribe to notification that the send queue has drained.
+    /// The handler is invoked immediately if the channel is writable.
+    virtual void subscribe_writable(result_handler handler);
+
+    /// Hold sends in the queue, so that a burst is written together.
+    virtual void cork();
+
+    /// Release held sends, writing any queued messages.
+    virtual void uncork();
+
     /// Subscribe to messages of the specified type on the socket.
     template <class Message>
     void subscribe(message_handler<Message>&& handler)
@@ -71,12 +109,35 @@ public:
             std::forward<message_handler<Message>>(handler));
     }
 
+    /// Pace reads and writes to the configured channel and shared budgets.
+    /// Channels that are not limited (such as manual peers) are unthrottled.
+    /// Call before start, the shared limiters must outlive the channel.
+    virtual void set_rate_limits(rate_limiter& upload,
+        rate_limiter& download);
+
+    /// Parse large payloads on the scheduler, in order for this channel.
+    /// Call before start, the scheduler must outlive the channel.
+    virtual void set_scheduler(work_scheduler& scheduler);
+
     /// Subscribe to the stop event.
     virtual void subscribe_stop(result_handler handler);
 
+    /// Capture the messages of this socket, null to end the capture.
+    virtual void set_capture(message_capture::ptr capture);
+
+    /// The message capture of this socket, null if not capturing.
+    virtual message_capture::ptr capture() const;
+
+    /// The traffic and latency counters of this socket.
+    virtual channel_metrics& metrics();
+    virtual const channel_metrics& metrics() const;
+
     /// Get the authority of the far end of this socket.
     virtual const config::authority& authority() const;
 
+    /// Get the threadpool to which this channel is assigned.
+    virtual threadpool& pool();
+
     /// Get the negotiated protocol version of this socket.
     /// The value should be the lesser of own max and peer min.
     uint32_t negotiated_version() const;
@@ -84,6 +145,9 @@ public:
     /// Save the negotiated protocol version.
     virtual void set_negotiated_version(uint32_t value);
 
+    /// True if verbose log statements are evaluated for this socket.
+    bool verbose() const;
+
     /// Read messages from this socket.
     virtual void start(result_handler handler);
 
@@ -96,45 +160,124 @@ protected:
     virtual void handle_stopping() = 0;
 
 private:
-    typedef byte_source<data_chunk> payload_source;
-    typedef boost::iostreams::stream<payload_source> payload_stream;
-    typedef std::shared_ptr<std::string> command_ptr;
-    typedef std::shared_ptr<data_chunk> payload_ptr;
-
-    static config::authority authority_factory(socket::ptr socket);
-
     void do_close();
     void stop(const boost_code& ec);
 
-    void read_heading();
-    void handle_read_heading(const boost_code& ec, size_t payload_size);
+    void read_more();
+    void handle_read_more(const boost_code& ec, size_t bytes);
+    void handle_read_delay(const code& ec);
+    void read_frames();
+    bool validate_heading(const message::heading& head);
+    bool handle_frame(const message::heading& head,
+        const data_slice& payload);
 
     void read_payload(const message::heading& head);
     void handle_read_payload(const boost_code& ec, size_t,
         const message::heading& head);
 
-    void do_send(command_ptr command, payload_ptr payload,
-        result_handler handler);
-    void handle_send(const boost_code& ec, size_t bytes, command_ptr command,
-        payload_ptr payload, result_handler handler);
+    typedef pooled_buffer::ptr shared_payload;
+
+    bool offloading(size_t payload_size) const;
+    bool verify(const message::heading& head, shared_payload payload);
+    void post_verify(const message::heading& head, shared_payload payload);
+    void handle_verify(const message::heading& head, shared_payload payload);
+    bool handle_payload(const message::heading& head,
+        const data_slice& payload);
+
+    struct queued_message
+    {
+        command_ptr command;
+        payload_ptr payload;
+        result_handler handler;
+        asio::time_point queued;
+    };
+
+    /// Send priority classes, in order of precedence.
+    enum priority : size_t
+    {
+        control,
+        announcement,
+        bulk,
+        priority_count
+    };
+
+    typedef std::vector<queued_message> send_batch;
+    typedef std::shared_ptr<send_batch> send_batch_ptr;
+    typedef std::array<std::deque<queued_message>, priority_count>
+        send_queues;
+
+    static priority classify(const std::string& command);
+
+    void handle_flush(const code& ec);
+    void start_send();
+    asio::duration send_delay() const;
+    void do_send();
+    void handle_send(const boost_code& ec, size_t bytes,
+        send_batch_ptr batch);
+    void clear_send_queue(const code& ec);
+    bool exceeds_limits(size_t size) const;
+    bool below_low_water() const;
+    bool send_queue_empty() const;
+    asio::duration throttle(rate_limiter& own, rate_limiter* shared,
+        size_t bytes);
 
     const config::authority authority_;
 
-    // These are protected by read header/payload ordering.
+    // These are protected by read ordering.
     data_chunk heading_buffer_;
-    data_chunk payload_buffer_;
-    socket::ptr socket_;
+    data_chunk read_buffer_;
+    size_t read_begin_;
+    size_t read_end_;
+    pooled_buffer::ptr payload_buffer_;
+    asio::duration read_delay_;
+    transport::ptr transport_;
 
     // These are thread safe.
+    threadpool& pool_;
+    buffer_pool& buffers_;
     std::atomic<bool> stopped_;
     const uint32_t protocol_magic_;
     const size_t maximum_payload_;
     const bool validate_checksum_;
+    const bool validate_unsubscribed_;
+    const bool thread_affinity_;
     const bool verbose_;
     std::atomic<uint32_t> version_;
+    const asio::duration send_coalesce_;
+    const size_t send_queue_message_limit_;
+    const size_t send_queue_byte_limit_;
+    const overflow_policy send_queue_overflow_;
     message_subscriber message_subscriber_;
+    channel_metrics metrics_;
     stop_subscriber::ptr stop_subscriber_;
+    writable_subscriber::ptr writable_subscriber_;
     dispatcher dispatch_;
+    rate_limiter upload_;
+    rate_limiter download_;
+
+    // The flag avoids loading the capture for each message when not set.
+    std::atomic<bool> capturing_;
+    bc::atomic<message_capture::ptr> capture_;
+
+    // These are set before start.
+    rate_limiter* shared_upload_;
+    rate_limiter* shared_download_;
+    work_scheduler::serial::ptr serial_;
+
+    // These are protected by send_mutex_.
+    send_queues send_queue_;
+    size_t send_queue_messages_;
+    size_t send_queue_bytes_;
+    bool sending_;
+    bool corked_;
+    bool throttled_;
+    asio::time_point send_allowed_;
+    mutable upgrade_mutex send_mutex_;
+
+    // These are protected by verify_mutex_.
+    size_t verifying_;
+    bool reading_;
+    mutable upgrade_mutex verify_mutex_;
 };
 
 } // namespace network
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_RATE_LIMITER_HPP
+#define LIBBITCOIN_NETWORK_RATE_LIMITER_HPP
+
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A token bucket of bytes, holding up to one second of the rate.
+/// Consumption is never refused, it may take the bucket into debt, and the
+/// returned delay is the time until the debt is repaid.
+class BCT_API rate_limiter
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    /// @param[in]  bytes_per_second  The rate, zero is unlimited.
+    rate_limiter(size_t bytes_per_second);
+
+    /// True if the rate is limited.
+    virtual bool enabled() const;
+
+    /// Consume bytes, returning the delay before further use within rate.
+    virtual asio::duration consume(size_t bytes);
+
+    /// The delay before further use within rate, without consuming.
+    virtual asio::duration delay() const;
+
+private:
+    // These are thread safe.
+    const double rate_;
+
+    // These are protected by mutex.
+    double tokens_;
+    asio::time_point updated_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_REQUEST_TRACKER_HPP
+#define LIBBITCOIN_NETWORK_REQUEST_TRACKER_HPP
+
+#include <cstddef>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The get_data requests outstanding to a peer. The window of outstanding
+/// requests grows by one for each window of timely deliveries and halves on
+/// stall. A stall is the lack of any delivery, while requests are
+/// outstanding, for the time the outstanding requests should take at the
+/// observed throughput (bounded by the configured minimum and maximum).
+/// The requester records requests and deliveries, and may bypass a stalled
+/// peer by canceling its requests for reassignment.
+class BCT_API request_tracker
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    /// @param[in]  minimum_window   The smallest request window (at least 1).
+    /// @param[in]  maximum_window   The largest request window.
+    /// @param[in]  minimum_timeout  The smallest stall timeout.
+    /// @param[in]  maximum_timeout  The largest stall timeout.
+    request_tracker(size_t minimum_window, size_t maximum_window,
+        const asio::duration& minimum_timeout,
+        const asio::duration& maximum_timeout);
+
+    /// The current number of requests allowed to be outstanding.
+    size_t window() const;
+
+    /// The number of requests that may be made within the window.
+    size_t available() const;
+
+    /// The number of outstanding requests.
+    size_t outstanding() const;
+
+    /// The observed delivery throughput in bytes per second.
+    double rate() const;
+
+    /// The current stall timeout.
+    asio::duration timeout() const;
+
+    /// True if requests are outstanding without delivery beyond timeout.
+    bool stalled() const;
+
+    /// Record a request, false if already outstanding or beyond window.
+    bool request(const hash_digest& hash);
+
+    /// Record a delivery of bytes, false if the hash was not outstanding.
+    bool deliver(const hash_digest& hash, size_t bytes);
+
+    /// Remove an outstanding request (e.g. upon not_found).
+    bool cancel(const hash_digest& hash);
+
+    /// Remove all outstanding requests, returning them for reassignment.
+    /// The window is halved if the requests had stalled.
+    hash_list cancel();
+
+private:
+    typedef std::unordered_map<hash_digest, asio::time_point> requests;
+
+    asio::duration expected() const;
+    bool is_stalled(const asio::time_point& now) const;
+
+    const size_t minimum_window_;
+    const size_t maximum_window_;
+    const asio::duration minimum_timeout_;
+    const asio::duration maximum_timeout_;
+
+    // These are protected by mutex.
+    size_t window_;
+    size_t credit_;
+    double rate_;
+    double item_size_;
+    asio::time_point progress_;
+    requests requests_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_RESOLVER_CACHE_HPP
+#define LIBBITCOIN_NETWORK_RESOLVER_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A shared cache of resolved host names, cached for resolve_cache_seconds.
+/// Concurrent requests for the same name and port share a single query.
+/// System resolution does not expose record TTLs, so expiry is configured.
+/// Numeric hosts are not queried or cached, and the cache size is bounded.
+class BCT_API resolver_cache
+  : noncopyable
+{
+public:
+    typedef std::vector<asio::endpoint> endpoints;
+    typedef std::shared_ptr<const endpoints> endpoints_ptr;
+    typedef std::function<void(const code&, endpoints_ptr)> resolve_handler;
+
+    /// Construct an instance.
+    resolver_cache(threadpool& pool, const settings& settings);
+
+    /// Resolve the host name and port, from cache if not expired.
+    /// The handler may be invoked on the calling thread.
+    virtual void resolve(const std::string& hostname, uint16_t port,
+        resolve_handler handler);
+
+    /// Discard all cached results.
+    virtual void clear();
+
+    /// The number of cached results, including any expired.
+    virtual size_t size() const;
+
+private:
+    typedef std::shared_ptr<asio::resolver> resolver_ptr;
+    typedef std::vector<resolve_handler> handlers;
+
+    struct record
+    {
+        endpoints_ptr hosts;
+        asio::time_point expiry;
+    };
+
+    static bool numeric(const std::string& hostname, uint16_t port,
+        endpoints& out);
+    void prune(asio::time_point now);
+    void handle_resolve(const boost_code& ec, asio::iterator iterator,
+        const std::string& key, asio::time_point start,
+        resolver_ptr resolver);
+
+    // These are thread safe.
+    threadpool& pool_;
+    const asio::duration lifetime_;
+
+    // These are protected by mutex.
+    std::unordered_map<std::string, record> cache_;
+    std::unordered_map<std::string, handlers> pending_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_ROLLING_BLOOM_HPP
+#define LIBBITCOIN_NETWORK_ROLLING_BLOOM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is not thread safe.
+/// A bloom filter of hashes that forgets the oldest entries as it fills.
+/// Entries are inserted into the current of two generations, and when it
+/// has taken half of the capacity the previous generation is discarded, so
+/// that at least half and at most all of the capacity is remembered.
+/// False positives occur at about two per million, there are no false
+/// negatives for remembered entries.
+class BCT_API rolling_bloom
+{
+public:
+    /// Construct an instance.
+    /// @param[in]  capacity  The number of entries remembered, zero disables.
+    rolling_bloom(size_t capacity);
+
+    /// True if the hash was (probably) inserted and is remembered.
+    bool contains(const hash_digest& hash) const;
+
+    /// Insert the hash, possibly discarding the oldest generation.
+    void insert(const hash_digest& hash);
+
+    /// Forget all entries.
+    void clear();
+
+private:
+    typedef std::vector<uint64_t> bits;
+
+    size_t position(const hash_digest& hash, size_t function) const;
+    bool test(const bits& generation, const hash_digest& hash) const;
+
+    const size_t generation_capacity_;
+    const size_t bit_count_;
+    const uint64_t seed_;
+    size_t inserted_;
+    bits current_;
+    bits previous_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
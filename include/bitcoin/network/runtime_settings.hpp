@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_RUNTIME_SETTINGS_HPP
+#define LIBBITCOIN_NETWORK_RUNTIME_SETTINGS_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// The subset of settings that may be replaced while the network runs.
+/// An instance is immutable once published, a reload publishes a new one,
+/// so readers hold a consistent snapshot without locking the members.
+class BCT_API runtime_settings
+{
+public:
+    typedef std::shared_ptr<const runtime_settings> ptr;
+
+    /// Construct an instance from the reloadable members of settings.
+    runtime_settings(const settings& settings);
+
+    /// Properties.
+    const uint32_t inbound_connections;
+    const uint32_t outbound_connections;
+    const uint32_t connect_timeout_seconds;
+    const uint32_t channel_handshake_seconds;
+    const uint32_t channel_inactivity_minutes;
+    const uint32_t channel_expiration_minutes;
+    const config::authority::list blacklists;
+    const std::vector<std::string> blacklist_subnets;
+
+    /// Helpers.
+    asio::duration connect_timeout() const;
+    asio::duration channel_handshake() const;
+    asio::duration channel_inactivity() const;
+    asio::duration channel_expiration() const;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
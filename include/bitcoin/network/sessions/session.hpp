@@ -27,9 +27,14 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/acceptor.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/compact_block_pool.hpp>
 #include <bitcoin/network/connector.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/hosts.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
 #include <bitcoin/network/proxy.hpp>
+#include <bitcoin/network/resolver_cache.hpp>
+#include <bitcoin/network/runtime_settings.hpp>
 #include <bitcoin/network/settings.hpp>
 
 namespace libbitcoin {
@@ -83,11 +88,12 @@ protected:
     // ------------------------------------------------------------------------
 
     /// Attach a protocol to a channel, caller must start the channel.
+    /// Protocol instances are recycled by type across channels.
     template <class Protocol, typename... Args>
     typename Protocol::ptr attach(channel::ptr channel, Args&&... args)
     {
-        return std::make_shared<Protocol>(network_, channel,
-            std::forward<Args>(args)...);
+        return std::allocate_shared<Protocol>(pool_allocator<Protocol>(),
+            network_, channel, std::forward<Args>(args)...);
     }
 
     /// Bind a method in the derived class.
@@ -117,7 +123,7 @@ protected:
     inline asio::duration cycle_delay(const code& ec)
     {
         return (ec == error::channel_timeout || ec == error::service_stopped) ?
-            asio::seconds(0) : settings_.connect_timeout();
+            asio::seconds(0) : current_settings()->connect_timeout();
     }
 
     /// Properties.
@@ -125,8 +131,18 @@ protected:
 
     virtual size_t address_count() const;
     virtual size_t connection_count() const;
+    virtual runtime_settings::ptr current_settings() const;
+    virtual bool evict_inbound();
     virtual code fetch_address(address& out_address) const;
+    virtual code fetch_address(address& out_address,
+        const hosts::groups& excluded) const;
+    virtual code promote_address(const authority& host);
+    virtual code demote_address(const authority& host);
+    virtual void resolve(const config::endpoint& host,
+        resolver_cache::resolve_handler handler);
     virtual bool blacklisted(const authority& authority) const;
+    virtual compact_block_pool::ptr compact_pool() const;
+    virtual authority::list load_anchors();
     virtual bool stopped() const;
     virtual bool stopped(const code& ec) const;
 
@@ -136,6 +152,12 @@ protected:
     virtual acceptor::ptr create_acceptor();
     virtual connector::ptr create_connector();
 
+    /// Release the admission slot of an accepted connection.
+    virtual void release_admission();
+
+    /// Override to exempt the session's channels from bandwidth limits.
+    virtual bool rate_limited() const;
+
     // Pending connect.
     // ------------------------------------------------------------------------
 
@@ -219,6 +241,8 @@ private:
     bind<CLASS>(&CLASS::method, p1, p2, p3, p4, p5, p6)
 #define BIND7(method, p1, p2, p3, p4, p5, p6, p7) \
     bind<CLASS>(&CLASS::method, p1, p2, p3, p4, p5, p6, p7)
+#define BIND8(method, p1, p2, p3, p4, p5, p6, p7, p8) \
+    bind<CLASS>(&CLASS::method, p1, p2, p3, p4, p5, p6, p7, p8)
 
 #define CONCURRENT_DELEGATE2(method, p1, p2) \
     concurrent_delegate<CLASS>(&CLASS::method, p1, p2)
@@ -19,10 +19,16 @@
 #ifndef LIBBITCOIN_NETWORK_SESSION_BATCH_HPP
 #define LIBBITCOIN_NETWORK_SESSION_BATCH_HPP
 
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/connector.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/hosts.hpp>
+#include <bitcoin/network/pending_set.hpp>
 #include <bitcoin/network/sessions/session.hpp>
 #include <bitcoin/network/settings.hpp>
 
@@ -41,17 +47,57 @@ protected:
     session_batch(p2p& network, bool notify_on_connect);
 
     /// Create a channel from the configured number of concurrent attempts.
+    /// Attempts start at the configured delay from one another, alternating
+    /// address families, and the remainder are canceled on first success.
     virtual void connect(channel_handler handler);
 
+    /// Create a channel to the specified host in a single attempt.
+    virtual void connect(const authority& host, channel_handler handler);
+
+    /// The number of concurrent attempts for the next batch.
+    virtual size_t batch_size() const;
+
+    /// Override to exclude network groups from the hosts of a batch.
+    virtual hosts::groups excluded_groups() const;
+
+    /// Override to observe the outcome of each completed attempt.
+    virtual void attempted(const code& ec);
+
 private:
+    struct candidate
+    {
+        code ec;
+        address host;
+    };
+
+    typedef std::vector<candidate> candidates;
+
+    // The state of one batch, shared by its attempts.
+    struct race
+    {
+        race(size_t size);
+
+        candidates hosts;
+        std::atomic<bool> won;
+        pending_set<connector> connectors;
+    };
+
+    typedef std::shared_ptr<race> race_ptr;
+
+    static void interleave(candidates& hosts);
+
     // Connect sequence
-    void new_connect(channel_handler handler);
-    void start_connect(const code& ec, const authority& host,
+    void handle_delay(const code& ec, race_ptr racer, size_t attempt,
         channel_handler handler);
+    void new_connect(race_ptr racer, size_t attempt, channel_handler handler);
+    void start_connect(const code& ec, const authority& host,
+        race_ptr racer, channel_handler handler);
     void handle_connect(const code& ec, channel::ptr channel,
-        connector::ptr connector, channel_handler handler);
+        const authority& host, connector::ptr connector, race_ptr racer,
+        channel_handler handler);
 
     const size_t batch_size_;
+    const asio::duration batch_delay_;
 };
 
 } // namespace network
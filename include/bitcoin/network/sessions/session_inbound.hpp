@@ -47,6 +47,9 @@ public:
     /// Start the session.
     void start(result_handler handler) override;
 
+    /// Stop accepting connections, existing channels are unaffected.
+    virtual void drain();
+
 protected:
     /// Overridden to implement pending test for inbound channels.
     void handshake_complete(channel::ptr channel,
@@ -56,18 +59,19 @@ protected:
     virtual void attach_protocols(channel::ptr channel);
 
 private:
-    void start_accept(const code& ec);
+    size_t connection_limit() const;
+    void start_accept(const code& ec, acceptor::ptr acceptor);
 
     void handle_stop(const code& ec);
     void handle_started(const code& ec, result_handler handler);
-    void handle_accept(const code& ec, channel::ptr channel);
+    void handle_accept(const code& ec, channel::ptr channel,
+        acceptor::ptr acceptor);
 
     void handle_channel_start(const code& ec, channel::ptr channel);
     void handle_channel_stop(const code& ec);
 
     // These are thread safe.
-    acceptor::ptr acceptor_;
-    const size_t connection_limit_;
+    std::vector<acceptor::ptr> acceptors_;
 };
 
 } // namespace network
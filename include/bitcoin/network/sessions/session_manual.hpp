@@ -21,6 +21,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <bitcoin/bitcoin.hpp>
@@ -60,19 +61,39 @@ protected:
     /// Override to attach specialized protocols upon channel start.
     virtual void attach_protocols(channel::ptr channel);
 
+    /// Manual peers are exempt from bandwidth limits.
+    bool rate_limited() const override;
+
 private:
+    // The retry state of a peer, which survives its channel drops.
+    // Access is sequential, as the peer has one connection cycle at a time.
+    struct retry
+    {
+        typedef std::shared_ptr<retry> ptr;
+
+        retry();
+
+        uint32_t failures;
+        asio::time_point started;
+    };
+
+    asio::duration backoff(retry::ptr state) const;
+    void retry_connect(const code& ec, const std::string& hostname,
+        uint16_t port, retry::ptr state, channel_handler handler);
     void start_connect(const code& ec, const std::string& hostname,
-        uint16_t port, uint32_t attempts, channel_handler handler);
+        uint16_t port, uint32_t attempts, retry::ptr state,
+        channel_handler handler);
 
     void handle_started(const code& ec, result_handler handler);
     void handle_connect(const code& ec, channel::ptr channel,
         const std::string& hostname, uint16_t port, uint32_t remaining,
-        connector::ptr connector, channel_handler handler);
+        connector::ptr connector, retry::ptr state, channel_handler handler);
 
     void handle_channel_start(const code& ec, const std::string& hostname,
-        uint16_t port, channel::ptr channel, channel_handler handler);
+        uint16_t port, channel::ptr channel, retry::ptr state,
+        channel_handler handler);
     void handle_channel_stop(const code& ec, const std::string& hostname,
-        uint16_t port);
+        uint16_t port, retry::ptr state);
 };
 
 } // namespace network
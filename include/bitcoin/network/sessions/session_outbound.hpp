@@ -21,8 +21,10 @@
 
 #include <cstddef>
 #include <memory>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/connect_scheduler.hpp>
 #include <bitcoin/network/define.hpp>
 #include <bitcoin/network/sessions/session_batch.hpp>
 #include <bitcoin/network/settings.hpp>
@@ -45,6 +47,11 @@ public:
     /// Start the session.
     void start(result_handler handler) override;
 
+    /// Apply the current outbound connection count. Added slots connect
+    /// immediately, the channels of removed slots are stopped and removed
+    /// slots do not reconnect.
+    virtual void reload();
+
 protected:
     /// Overridden to implement pending outbound channels.
     void start_channel(channel::ptr channel,
@@ -57,17 +64,48 @@ protected:
     /// Override to attach specialized protocols upon channel start.
     virtual void attach_protocols(channel::ptr channel);
 
+    /// Overridden to scale the batch size with the attempt failure rate.
+    size_t batch_size() const override;
+
+    /// Overridden to exclude the network groups already connected.
+    hosts::groups excluded_groups() const override;
+
+    /// Overridden to track the attempt success rate.
+    void attempted(const code& ec) override;
+
 private:
-    void new_connection(const code&);
+    struct slot_state
+    {
+        bool running;
+        channel::ptr channel;
+        bool high_bandwidth;
+    };
+
+    bool retire(size_t slot);
+    bool retain(size_t slot, channel::ptr channel);
+    void release(size_t slot);
+    bool claim_high_bandwidth(channel::ptr channel);
+
+    void new_connection(const code&, size_t slot);
+    void anchor_connection(const authority& host, size_t slot);
+    void retry_connection(const code& ec, size_t slot);
 
     void handle_started(const code& ec, result_handler handler);
-    void handle_connect(const code& ec, channel::ptr channel);
+    void handle_connect(const code& ec, channel::ptr channel, size_t slot);
 
     void do_unpend(const code& ec, channel::ptr channel,
         result_handler handle_started);
 
-    void handle_channel_stop(const code& ec, channel::ptr channel);
-    void handle_channel_start(const code& ec, channel::ptr channel);
+    void handle_channel_stop(const code& ec, channel::ptr channel,
+        size_t slot);
+    void handle_channel_start(const code& ec, channel::ptr channel,
+        size_t slot);
+
+    connect_scheduler scheduler_;
+
+    // These are protected by mutex.
+    std::vector<slot_state> slots_;
+    mutable upgrade_mutex mutex_;
 };
 
 } // namespace network
@@ -19,6 +19,7 @@
 #ifndef LIBBITCOIN_NETWORK_SESSION_SEED_HPP
 #define LIBBITCOIN_NETWORK_SESSION_SEED_HPP
 
+#include <atomic>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -26,6 +27,7 @@
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/connector.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/pending_set.hpp>
 #include <bitcoin/network/sessions/session.hpp>
 #include <bitcoin/network/settings.hpp>
 
@@ -57,17 +59,34 @@ protected:
         result_handler handler);
 
 private:
+    // The state of one seeding, shared by its seeds.
+    struct race
+    {
+        race(size_t target, size_t seeds);
+
+        const size_t target;
+        std::atomic<bool> won;
+        pending_set<connector> connectors;
+        pending_set<channel> channels;
+    };
+
+    typedef std::shared_ptr<race> race_ptr;
+
     void start_seeding(size_t start_size, result_handler handler);
-    void start_seed(const config::endpoint& seed, result_handler handler);
+    void start_seed(const config::endpoint& seed, race_ptr racer,
+        result_handler handler);
     void handle_started(const code& ec, result_handler handler);
     void handle_connect(const code& ec, channel::ptr channel,
         const config::endpoint& seed, connector::ptr connector,
+        race_ptr racer, result_handler handler);
+    void handle_seed(const code& ec, race_ptr racer, result_handler join,
         result_handler handler);
-    void handle_complete(size_t start_size, result_handler handler);
+    void handle_complete(race_ptr racer, result_handler handler);
 
     void handle_channel_start(const code& ec, channel::ptr channel,
         result_handler handler);
-    void handle_channel_stop(const code& ec);
+    void handle_channel_stop(const code& ec, channel::ptr channel,
+        race_ptr racer);
 };
 
 } // namespace network
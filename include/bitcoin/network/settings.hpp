@@ -21,12 +21,29 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <string>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/define.hpp>
 
 namespace libbitcoin {
 namespace network {
 
+/// The action taken when a message would exceed a channel send queue limit.
+enum class overflow_policy
+{
+    /// Drop low priority (inventory and address) messages. All others are
+    /// queued beyond the limits without notice, so for them the limits do
+    /// not bound the queue (this is the default).
+    drop,
+
+    /// Reject all messages until the channel signals that it is writable.
+    stall,
+
+    /// Stop the channel.
+    disconnect
+};
+
 /// Common database configuration settings, properties not thread safe.
 class BCT_API settings
 {
@@ -36,28 +53,75 @@ public:
 
     /// Properties.
     uint32_t threads;
+    bool thread_affinity;
+    uint32_t work_stealing_threads;
     uint32_t protocol_maximum;
     uint32_t protocol_minimum;
     uint64_t services;
     uint64_t invalid_services;
     bool relay_transactions;
     bool validate_checksum;
+    bool validate_unsubscribed;
     uint32_t identifier;
     uint16_t inbound_port;
     uint32_t inbound_connections;
+    uint32_t inbound_listeners;
+    uint32_t inbound_backlog;
+    uint32_t inbound_address_rate_per_minute;
+    uint32_t inbound_subnet_rate_per_minute;
+    uint32_t inbound_handshake_limit;
+    bool tcp_no_delay;
+    bool tcp_keepalive;
+    bool tcp_quick_ack;
+    uint32_t tcp_not_sent_low_water;
+    uint32_t ip_type_of_service;
+    uint32_t socket_receive_buffer;
+    uint32_t socket_send_buffer;
+    uint32_t upload_rate_limit;
+    uint32_t download_rate_limit;
+    uint32_t channel_upload_rate_limit;
+    uint32_t channel_download_rate_limit;
     uint32_t outbound_connections;
     uint32_t manual_attempt_limit;
+    uint32_t manual_backoff_base_milliseconds;
+    uint32_t manual_backoff_maximum_seconds;
     uint32_t connect_batch_size;
+    uint32_t connect_batch_delay_milliseconds;
+    uint32_t connect_backoff_seconds;
+    uint32_t resolve_cache_seconds;
+    bool prefetch_seeds;
+    bool fast_start;
+    uint32_t fast_start_minimum_hosts;
     uint32_t connect_timeout_seconds;
     uint32_t channel_handshake_seconds;
     uint32_t channel_heartbeat_minutes;
     uint32_t channel_inactivity_minutes;
     uint32_t channel_expiration_minutes;
     uint32_t channel_germination_seconds;
+    uint32_t channel_latency_limit_milliseconds;
+    uint32_t send_coalesce_milliseconds;
+    uint32_t relay_trickle_milliseconds;
+    uint32_t relay_known_inventory;
+    uint64_t minimum_fee_filter;
+    uint32_t request_window_minimum;
+    uint32_t request_window_maximum;
+    uint32_t request_timeout_minimum_seconds;
+    uint32_t request_timeout_maximum_seconds;
+    bool request_stall_disconnect;
+    uint32_t send_queue_message_limit;
+    uint32_t send_queue_byte_limit;
+    overflow_policy send_queue_overflow;
     uint32_t host_pool_capacity;
+    uint32_t host_pool_flush_seconds;
+    uint32_t address_cache_minutes;
     boost::filesystem::path hosts_file;
+    boost::filesystem::path anchors_file;
+    uint32_t anchor_connections;
+    bool hosts_file_text;
     config::authority self;
     config::authority::list blacklists;
+    std::vector<std::string> blacklist_subnets;
+    bool ban_misbehaving;
     config::endpoint::list peers;
     config::endpoint::list seeds;
 
@@ -70,16 +134,31 @@ public:
     size_t maximum_archive_size;
     size_t maximum_archive_files;
     config::authority statistics_server;
+    uint32_t statistics_interval_seconds;
+    uint32_t capture_buffer_bytes;
     bool verbose;
 
     /// Helpers.
     size_t minimum_connections() const;
     asio::duration connect_timeout() const;
+    asio::duration connect_batch_delay() const;
+    asio::duration connect_backoff() const;
+    asio::duration manual_backoff_base() const;
+    asio::duration manual_backoff_maximum() const;
+    asio::duration resolve_cache() const;
     asio::duration channel_handshake() const;
     asio::duration channel_heartbeat() const;
     asio::duration channel_inactivity() const;
     asio::duration channel_expiration() const;
     asio::duration channel_germination() const;
+    asio::duration channel_latency_limit() const;
+    asio::duration send_coalesce() const;
+    asio::duration relay_trickle() const;
+    asio::duration request_timeout_minimum() const;
+    asio::duration request_timeout_maximum() const;
+    asio::duration host_pool_flush() const;
+    asio::duration address_cache() const;
+    asio::duration statistics_interval() const;
 };
 
 } // namespace network
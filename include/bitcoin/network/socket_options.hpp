@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_SOCKET_OPTIONS_HPP
+#define LIBBITCOIN_NETWORK_SOCKET_OPTIONS_HPP
+
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The tcp options applied to each socket when its channel is created.
+/// Options that are unset keep the kernel default and options that the
+/// platform does not support are skipped. Failures are not fatal.
+class BCT_API socket_options
+{
+public:
+    /// Construct an instance.
+    socket_options(const settings& settings);
+
+    /// Apply the options to a connected socket.
+    virtual void apply(asio::socket& socket) const;
+
+private:
+    // These are thread safe.
+    const bool no_delay_;
+    const bool keepalive_;
+    const bool quick_ack_;
+    const uint32_t receive_buffer_;
+    const uint32_t send_buffer_;
+    const uint32_t not_sent_low_water_;
+    const uint32_t type_of_service_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
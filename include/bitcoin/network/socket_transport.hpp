@@ -0,0 +1,57 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_SOCKET_TRANSPORT_HPP
+#define LIBBITCOIN_NETWORK_SOCKET_TRANSPORT_HPP
+
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/transport.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A transport over a connected tcp socket.
+class BCT_API socket_transport
+  : public transport
+{
+public:
+    typedef std::shared_ptr<socket_transport> ptr;
+
+    /// Construct an instance.
+    socket_transport(socket::ptr socket);
+
+    config::authority authority() const override;
+    void read_some(const boost::asio::mutable_buffer& buffer,
+        io_handler handler) override;
+    void read(const boost::asio::mutable_buffer& buffer,
+        io_handler handler) override;
+    void write(const const_buffers& buffers, io_handler handler) override;
+    void stop() override;
+
+private:
+    // This is thread safe.
+    socket::ptr socket_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_STATISTICS_EMITTER_HPP
+#define LIBBITCOIN_NETWORK_STATISTICS_EMITTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <boost/asio.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel_metrics.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is not thread safe.
+/// Writes metrics snapshots to the statistics server as statsd gauges over
+/// udp. Delivery is best effort, failures are logged and otherwise ignored.
+class BCT_API statistics_emitter
+  : noncopyable
+{
+public:
+    /// Construct an instance.
+    statistics_emitter(threadpool& pool, const settings& settings);
+
+    /// True if a statistics server is configured.
+    bool enabled() const;
+
+    /// Write the snapshot to the statistics server.
+    void emit(const channel_metrics::snapshot& metrics, size_t connections);
+
+
+private:
+    typedef boost::asio::ip::udp udp;
+
+    void add(const std::string& name, uint64_t value);
+    void flush();
+
+    const bool enabled_;
+    const udp::endpoint server_;
+    udp::socket socket_;
+    std::string datagram_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
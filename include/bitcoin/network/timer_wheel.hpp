@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_TIMER_WHEEL_HPP
+#define LIBBITCOIN_NETWORK_TIMER_WHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A hashed timer wheel for coarse timeouts shared by all channels.
+/// A single deadline drives the wheel, so scheduling and cancellation do not
+/// create, cancel or insert asio timers. Timeouts never fire early, and fire
+/// up to two resolutions late. Handlers are invoked with success on expiry
+/// and are dropped on cancel or stop.
+class BCT_API timer_wheel
+  : noncopyable
+{
+public:
+    typedef uint64_t token;
+    typedef std::function<void(const code&)> timeout_handler;
+
+    /// Construct an instance.
+    /// @param[in]  pool        The threadpool on which handlers are invoked.
+    /// @param[in]  resolution  The tick period of the wheel.
+    /// @param[in]  slots       The number of slots in the wheel.
+    timer_wheel(threadpool& pool, const asio::duration& resolution,
+        size_t slots);
+
+    /// Begin ticking.
+    virtual void start();
+
+    /// Stop ticking and drop all scheduled handlers.
+    virtual void stop();
+
+    /// Schedule a handler to fire after the delay, returns a cancel token.
+    virtual token schedule(const asio::duration& delay,
+        timeout_handler handler);
+
+    /// Cancel a scheduled handler, no effect if fired or canceled.
+    virtual void cancel(token id);
+
+private:
+    struct entry
+    {
+        size_t rounds;
+        timeout_handler handler;
+    };
+
+    typedef std::unordered_map<token, entry> entries;
+    typedef std::vector<std::vector<token>> slot_list;
+
+    void start_tick();
+    void handle_tick(const code& ec);
+
+    // These are thread safe.
+    const asio::duration resolution_;
+    deadline::ptr timer_;
+
+    // These are protected by mutex.
+    bool stopped_;
+    token next_token_;
+    size_t current_;
+    entries entries_;
+    slot_list slots_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_TRANSPORT_HPP
+#define LIBBITCOIN_NETWORK_TRANSPORT_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// The byte stream under a proxy, such as a tcp socket or an in-memory pipe.
+/// Handlers are never invoked from within the initiating call. Only one read
+/// and one write may be outstanding at a time.
+class BCT_API transport
+  : noncopyable
+{
+public:
+    typedef std::shared_ptr<transport> ptr;
+    typedef std::vector<boost::asio::const_buffer> const_buffers;
+    typedef std::function<void(const boost_code&, size_t)> io_handler;
+
+    virtual ~transport() {}
+
+    /// The authority of the far end of the stream.
+    virtual config::authority authority() const = 0;
+
+    /// Read at least one byte into the buffer.
+    virtual void read_some(const boost::asio::mutable_buffer& buffer,
+        io_handler handler) = 0;
+
+    /// Read until the buffer is full.
+    virtual void read(const boost::asio::mutable_buffer& buffer,
+        io_handler handler) = 0;
+
+    /// Write all bytes of the buffers.
+    virtual void write(const const_buffers& buffers, io_handler handler) = 0;
+
+    /// Cancel outstanding work, pending handlers are invoked with an error.
+    virtual void stop() = 0;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NETWORK_WORK_SCHEDULER_HPP
+#define LIBBITCOIN_NETWORK_WORK_SCHEDULER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/define.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+/// This class is thread safe.
+/// A set of worker threads, each with its own queue, for cpu-bound channel
+/// work such as payload parsing. A worker takes the newest job from its own
+/// queue and, when that is empty, steals the oldest job of another queue, so
+/// that a burst from one channel spreads across otherwise idle cores.
+/// Jobs that must retain order are posted through a serial.
+class BCT_API work_scheduler
+  : noncopyable
+{
+public:
+    typedef std::function<void()> job;
+
+    /// This class is thread safe.
+    /// Jobs of a serial run one at a time in the order posted, on any worker.
+    class BCT_API serial
+      : public std::enable_shared_from_this<serial>, noncopyable
+    {
+    public:
+        typedef std::shared_ptr<serial> ptr;
+
+        /// Construct an instance, jobs are queued first to the home worker.
+        serial(work_scheduler& scheduler, size_t home);
+
+        /// Queue the job to run after all previously posted jobs.
+        void post(job&& work);
+
+        /// Drop queued jobs and any posted later, releasing what they retain.
+        void stop();
+
+    private:
+        void run();
+
+        work_scheduler& scheduler_;
+        const size_t home_;
+
+        // These are protected by mutex.
+        std::deque<job> jobs_;
+        bool running_;
+        bool stopped_;
+        mutable upgrade_mutex mutex_;
+    };
+
+    /// Construct an instance, zero workers disables the scheduler.
+    work_scheduler(size_t workers);
+
+    /// Shut down and join the workers.
+    ~work_scheduler();
+
+    /// True if the scheduler is configured with workers.
+    virtual bool enabled() const;
+
+    /// Create a serial, homes are assigned to workers in rotation.
+    virtual serial::ptr make_serial();
+
+    /// Queue the job to the home worker, the job is dropped if stopped.
+    virtual void post(size_t home, job&& work);
+
+    /// Start the workers.
+    virtual void spawn();
+
+    /// Signal the workers to stop, queued jobs are dropped.
+    virtual void shutdown();
+
+    /// Block until all workers have stopped.
+    virtual void join();
+
+private:
+    struct worker_queue
+    {
+        std::deque<job> jobs;
+        upgrade_mutex mutex;
+    };
+
+    typedef std::unique_ptr<worker_queue> queue_ptr;
+
+    bool pop(size_t index, job& out);
+    bool steal(size_t index, job& out);
+    void work(size_t index);
+    void clear();
+
+    const size_t workers_;
+    std::vector<queue_ptr> queues_;
+    std::atomic<size_t> next_;
+    std::atomic<size_t> queued_;
+    std::atomic<bool> stopped_;
+
+    // These are protected by idle_mutex_.
+    std::condition_variable idle_;
+    std::mutex idle_mutex_;
+
+    // This is protected by thread_mutex_.
+    std::vector<std::thread> threads_;
+    mutable upgrade_mutex thread_mutex_;
+};
+
+} // namespace network
+} // namespace libbitcoin
+
+#endif
@@ -18,14 +18,18 @@
  */
 #include <bitcoin/network/acceptor.hpp>
 
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
 #include <bitcoin/network/proxy.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/socket_options.hpp>
+#include <bitcoin/network/socket_transport.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -36,11 +40,34 @@ using namespace std::placeholders;
 
 static const auto reuse_address = asio::acceptor::reuse_address(true);
 
-acceptor::acceptor(threadpool& pool, const settings& settings)
+#ifdef SO_REUSEPORT
+// Allows multiple listeners to share the port, the kernel balances accepts.
+typedef boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>
+    reuse_port;
+#endif
+
+// Sharding requires SO_REUSEPORT, otherwise only one listener may bind.
+size_t acceptor::maximum_listeners()
+{
+#ifdef SO_REUSEPORT
+    return max_size_t;
+#else
+    return 1;
+#endif
+}
+
+acceptor::acceptor(threadpool& pool, channel_pools& pools,
+    buffer_pool& buffers, timer_wheel& timers, admission& admission,
+    const settings& settings)
   : stopped_(true),
     pool_(pool),
+    pools_(pools),
+    buffers_(buffers),
+    timers_(timers),
+    admission_(admission),
     settings_(settings),
     dispatch_(pool, NAME),
+    options_(settings),
     acceptor_(pool_.service()),
     CONSTRUCT_TRACK(acceptor)
 {
@@ -96,7 +123,9 @@ code acceptor::listen(uint16_t port)
     }
 
     boost_code error;
-    asio::endpoint endpoint(asio::tcp::v6(), settings_.inbound_port);
+    asio::endpoint endpoint(asio::tcp::v6(), port);
+    const auto backlog = settings_.inbound_backlog == 0 ?
+        asio::max_connections : settings_.inbound_backlog;
 
     mutex_.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -105,11 +134,26 @@ code acceptor::listen(uint16_t port)
     if (!error)
         acceptor_.set_option(reuse_address, error);
 
+#ifdef SO_REUSEPORT
+    if (!error && settings_.inbound_listeners > 1)
+        acceptor_.set_option(reuse_port(true), error);
+#endif
+
+    // Buffer sizes are inherited by accepted sockets, and must be set before
+    // the handshake for the window scale to reflect them.
+    if (!error && settings_.socket_receive_buffer != 0)
+        acceptor_.set_option(asio::socket::receive_buffer_size(
+            settings_.socket_receive_buffer), error);
+
+    if (!error && settings_.socket_send_buffer != 0)
+        acceptor_.set_option(asio::socket::send_buffer_size(
+            settings_.socket_send_buffer), error);
+
     if (!error)
         acceptor_.bind(endpoint, error);
 
     if (!error)
-        acceptor_.listen(asio::max_connections, error);
+        acceptor_.listen(backlog, error);
 
     stopped_ = false;
 
@@ -133,7 +177,10 @@ void acceptor::accept(accept_handler handler)
         return;
     }
 
-    const auto socket = std::make_shared<bc::socket>(pool_);
+    // The socket is created on the pool to which the channel is assigned.
+    auto& pool = pools_.select();
+    const auto socket = std::allocate_shared<bc::socket>(
+        pool_allocator<bc::socket>(), pool);
 
     mutex_.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -144,7 +191,7 @@ void acceptor::accept(accept_handler handler)
     // to the thread of the socket, then this is unnecessary.
     acceptor_.async_accept(socket->get(),
         std::bind(&acceptor::handle_accept,
-            shared_from_this(), _1, socket, handler));
+            shared_from_this(), _1, socket, std::ref(pool), handler));
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -152,7 +199,7 @@ void acceptor::accept(accept_handler handler)
 
 // private:
 void acceptor::handle_accept(const boost_code& ec, socket::ptr socket,
-    accept_handler handler)
+    threadpool& pool, accept_handler handler)
 {
     if (ec)
     {
@@ -160,8 +207,33 @@ void acceptor::handle_accept(const boost_code& ec, socket::ptr socket,
         return;
     }
 
+    // Rejected connections are closed before a channel is created for them,
+    // and accepting continues without invoking the handler.
+    boost_code endpoint_ec;
+    const auto endpoint = socket->get().remote_endpoint(endpoint_ec);
+    const auto admitted = endpoint_ec ? code(error::bad_stream) :
+        admission_.admit(config::authority(endpoint));
+
+    if (admitted)
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Rejected inbound connection from [" << socket->authority()
+            << "] " << admitted.message();
+        socket->stop();
+        accept(handler);
+        return;
+    }
+
+    options_.apply(socket->get());
+
+    // Channel objects are recycled by type, limiting churn fragmentation.
+    const auto transport = std::allocate_shared<socket_transport>(
+        pool_allocator<socket_transport>(), socket);
+
     // Ensure that channel is not passed as an r-value.
-    const auto created = std::make_shared<channel>(pool_, socket, settings_);
+    const auto created = std::allocate_shared<channel>(
+        pool_allocator<channel>(), pool, buffers_, timers_, transport,
+        settings_);
     handler(error::success, created);
 }
 
@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/address_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/hosts.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::message;
+
+// The protocol limit on the number of addresses in an address message.
+static const size_t maximum_addresses = 1000;
+
+// The response is limited to this percentage of the pool.
+static const size_t pool_percentage = 23;
+
+address_cache::address_cache(hosts& pool, const settings& settings)
+  : hosts_(pool),
+    interval_(settings.address_cache()),
+    expiry_(asio::steady_clock::now())
+{
+}
+
+// private
+address_const_ptr address_cache::generate() const
+{
+    const auto share = hosts_.count() * pool_percentage / 100;
+    const auto maximum = std::min(std::max(share, size_t(1)),
+        maximum_addresses);
+
+    address::list sample;
+    hosts_.fetch(sample, maximum);
+    return std::make_shared<const address>(std::move(sample));
+}
+
+// Regeneration is under the lock, so concurrent requests sample once.
+address_const_ptr address_cache::get()
+{
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (response_ && now < expiry_)
+    {
+        const auto response = response_;
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return response;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    // An empty pool is sampled again on the next request.
+    response_ = generate();
+    expiry_ = response_->addresses().empty() ? now : now + interval_;
+    const auto response = response_;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return response;
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,196 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/admission.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <boost/functional/hash.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// Each bucket table is bounded to this size, evicting the least recently used.
+static const size_t maximum_buckets = 16384;
+
+// At most this many refilled buckets are pruned per admission.
+static const size_t prune_limit = 8;
+
+// An ipv4 subnet is a /24 and an ipv6 subnet is a /64.
+static const size_t ipv4_subnet_bytes = 15;
+static const size_t ipv6_subnet_bytes = 8;
+
+static const double seconds_per_minute = 60.0;
+
+admission::admission(blacklist& blacklist, const settings& settings)
+  : address_capacity_(settings.inbound_address_rate_per_minute),
+    address_rate_(address_capacity_ / seconds_per_minute),
+    subnet_capacity_(settings.inbound_subnet_rate_per_minute),
+    subnet_rate_(subnet_capacity_ / seconds_per_minute),
+    handshake_limit_(settings.inbound_handshake_limit),
+    blacklist_(blacklist),
+    handshakes_(0)
+{
+}
+
+// private
+size_t admission::key_hash::operator()(const key& value) const
+{
+    return boost::hash_range(value.begin(), value.end());
+}
+
+// private
+admission::key admission::subnet(const asio::ipv6& ip)
+{
+    auto value = ip.to_bytes();
+    const auto prefix = ip.is_v4_mapped() ? ipv4_subnet_bytes :
+        ipv6_subnet_bytes;
+
+    std::fill(value.begin() + prefix, value.end(), 0);
+    return value;
+}
+
+// private
+// The tokens of the bucket as refilled to now.
+double admission::tokens(const bucket& entry, double capacity, double rate,
+    const asio::time_point& now)
+{
+    const auto elapsed = std::chrono::duration<double>(
+        now - entry.updated).count();
+
+    return std::min(capacity, entry.tokens + elapsed * rate);
+}
+
+// private
+// Remove the least recently used buckets that have refilled, as they are
+// equivalent to new buckets. The scan is bounded, so the cost of pruning is
+// spread across admissions, and it stops at the first unrefilled bucket.
+void admission::prune(table& buckets, double capacity, double rate,
+    const asio::time_point& now)
+{
+    for (size_t count = 0; count < prune_limit && !buckets.order.empty();
+        ++count)
+    {
+        const auto it = buckets.buckets.find(buckets.order.front());
+
+        if (tokens(it->second, capacity, rate, now) < capacity)
+            return;
+
+        buckets.buckets.erase(it);
+        buckets.order.pop_front();
+    }
+}
+
+// private
+// A zero capacity is unlimited. New buckets start full.
+bool admission::available(const table& buckets, const key& value,
+    double capacity, double rate, const asio::time_point& now)
+{
+    if (capacity == 0)
+        return true;
+
+    const auto it = buckets.buckets.find(value);
+    return it == buckets.buckets.end() ||
+        tokens(it->second, capacity, rate, now) >= 1;
+}
+
+// private
+// Call only if available. A full table evicts its least recently used
+// bucket, which forgives that key but bounds memory under a flood.
+void admission::take(table& buckets, const key& value, double capacity,
+    double rate, const asio::time_point& now)
+{
+    if (capacity == 0)
+        return;
+
+    prune(buckets, capacity, rate, now);
+    const auto it = buckets.buckets.find(value);
+
+    if (it == buckets.buckets.end())
+    {
+        if (buckets.buckets.size() >= maximum_buckets)
+        {
+            buckets.buckets.erase(buckets.order.front());
+            buckets.order.pop_front();
+        }
+
+        const auto position = buckets.order.insert(buckets.order.end(),
+            value);
+        buckets.buckets.emplace(value, bucket{ capacity - 1, now, position });
+        return;
+    }
+
+    auto& entry = it->second;
+    entry.tokens = tokens(entry, capacity, rate, now) - 1;
+    entry.updated = now;
+    buckets.order.splice(buckets.order.end(), buckets.order, entry.position);
+}
+
+bool admission::blacklisted(const config::authority& authority) const
+{
+    return blacklist_.contains(authority.ip());
+}
+
+code admission::admit(const config::authority& authority)
+{
+    if (blacklisted(authority))
+        return error::address_blocked;
+
+    const auto ip = authority.ip();
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (handshake_limit_ != 0 && handshakes_ >= handshake_limit_)
+        return error::peer_throttling;
+
+    const auto address = ip.to_bytes();
+    const auto network = subnet(ip);
+
+    // Both limits are checked before either token is taken, so a rejection
+    // by one limit does not consume the other.
+    if (!available(addresses_, address, address_capacity_, address_rate_,
+        now) ||
+        !available(subnets_, network, subnet_capacity_, subnet_rate_, now))
+        return error::peer_throttling;
+
+    take(addresses_, address, address_capacity_, address_rate_, now);
+    take(subnets_, network, subnet_capacity_, subnet_rate_, now);
+    ++handshakes_;
+    return error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void admission::release()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (handshakes_ != 0)
+        --handshakes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
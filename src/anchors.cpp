@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/anchors.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+anchors::anchors(const settings& settings)
+  : capacity_(settings.anchor_connections),
+    file_path_(settings.anchors_file)
+{
+}
+
+anchors::list anchors::load()
+{
+    list peers;
+
+    if (capacity_ == 0 || file_path_.empty())
+        return peers;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    {
+        bc::ifstream file(file_path_.string());
+
+        if (!file.good())
+            return peers;
+
+        std::string line;
+
+        while (std::getline(file, line) && peers.size() < capacity_)
+        {
+            config::authority peer(line);
+
+            if (peer.port() != 0)
+                peers.push_back(peer);
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::remove(file_path_, ec);
+    return peers;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+code anchors::save(const list& peers)
+{
+    if (capacity_ == 0 || file_path_.empty() || peers.empty())
+        return error::success;
+
+    std::ostringstream stream;
+    const auto count = std::min(peers.size(), capacity_);
+
+    for (size_t index = 0; index < count; ++index)
+        stream << peers[index] << std::endl;
+
+    const auto text = stream.str();
+    const auto temporary = file_path_.string() + ".tmp";
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    {
+        bc::ofstream file(temporary);
+
+        if (!file.good())
+            return error::file_system;
+
+        file << text;
+
+        if (!file.good())
+            return error::file_system;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, file_path_, ec);
+    return ec ? error::file_system : error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
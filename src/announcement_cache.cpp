@@ -0,0 +1,113 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/announcement_cache.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::message;
+
+announcement_cache::announcement_cache(uint32_t identifier)
+  : identifier_(identifier),
+    tip_(null_hash)
+{
+}
+
+bool announcement_cache::set(headers_const_ptr announcement)
+{
+    if (!announcement || announcement->elements().empty())
+        return false;
+
+    const auto tip = announcement->elements().back().hash();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    announcement_ = announcement;
+    tip_ = tip;
+    headers_.clear();
+    inventory_.clear();
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+hash_digest announcement_cache::tip() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return tip_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Serialization is under the lock, so that it is performed once.
+announcement_cache::payload_ptr announcement_cache::headers(uint32_t version)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!announcement_)
+        return nullptr;
+
+    auto& payload = headers_[version];
+
+    if (!payload)
+        payload = std::make_shared<const data_chunk>(
+            message::serialize(version, *announcement_, identifier_));
+
+    return payload;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+announcement_cache::payload_ptr announcement_cache::inventory(
+    uint32_t version)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!announcement_)
+        return nullptr;
+
+    auto& payload = inventory_[version];
+
+    if (!payload)
+    {
+        const message::inventory announcement(
+        {
+            { inventory_vector::type_id::block, tip_ }
+        });
+
+        payload = std::make_shared<const data_chunk>(
+            message::serialize(version, announcement, identifier_));
+    }
+
+    return payload;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,213 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/blacklist.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/runtime_settings.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+const uint8_t blacklist::address_prefix;
+
+static const uint8_t ipv4_mapped_bits = 96;
+static const uint8_t ipv4_address_bits = 32;
+
+bool blacklist::parse(const std::string& subnet, asio::ipv6& out_ip,
+    uint8_t& out_prefix)
+{
+    const auto slash = subnet.find('/');
+    const auto host = subnet.substr(0, slash);
+
+    boost_code ec;
+    const auto ip = boost::asio::ip::address::from_string(host, ec);
+
+    if (ec)
+        return false;
+
+    const auto bits = ip.is_v4() ? ipv4_address_bits : address_prefix;
+    uint32_t prefix = bits;
+
+    if (slash != std::string::npos)
+    {
+        const auto text = subnet.substr(slash + 1);
+
+        if (text.empty() || text.size() > 3 ||
+            !std::all_of(text.begin(), text.end(), ::isdigit))
+            return false;
+
+        prefix = std::stoul(text);
+
+        if (prefix > bits)
+            return false;
+    }
+
+    if (ip.is_v4())
+    {
+        out_ip = asio::ipv6::v4_mapped(ip.to_v4());
+        out_prefix = static_cast<uint8_t>(ipv4_mapped_bits + prefix);
+    }
+    else
+    {
+        out_ip = ip.to_v6();
+        out_prefix = static_cast<uint8_t>(prefix);
+    }
+
+    return true;
+}
+
+blacklist::blacklist(const settings& settings)
+  : size_(0)
+{
+    configure(settings.blacklists, settings.blacklist_subnets, true);
+}
+
+// private
+void blacklist::configure(const config::authority::list& blacklists,
+    const std::vector<std::string>& subnets, bool add)
+{
+    for (const auto& blocked: blacklists)
+    {
+        if (add)
+            insert(blocked.ip(), address_prefix);
+        else
+            erase(blocked.ip(), address_prefix);
+    }
+
+    asio::ipv6 ip;
+    uint8_t prefix;
+
+    for (const auto& subnet: subnets)
+    {
+        if (!parse(subnet, ip, prefix))
+        {
+            if (add)
+                LOG_WARNING(LOG_NETWORK)
+                    << "Ignoring invalid blacklist subnet (" << subnet << ").";
+        }
+        else if (add)
+            insert(ip, prefix);
+        else
+            erase(ip, prefix);
+    }
+}
+
+// Each entry takes the lock, so a concurrent match may observe a partially
+// reconfigured set, which is immaterial for admission.
+void blacklist::reconfigure(const runtime_settings& prior,
+    const runtime_settings& next)
+{
+    configure(prior.blacklists, prior.blacklist_subnets, false);
+    configure(next.blacklists, next.blacklist_subnets, true);
+}
+
+// private
+size_t blacklist::key_hash::operator()(const key& value) const
+{
+    return boost::hash_range(value.begin(), value.end());
+}
+
+// private
+blacklist::key blacklist::mask(const asio::ipv6& ip, uint8_t prefix)
+{
+    auto value = ip.to_bytes();
+    const size_t bits = std::min(prefix, address_prefix);
+    const auto whole = bits / 8;
+    const auto partial = bits % 8;
+
+    if (partial != 0)
+        value[whole] &= static_cast<uint8_t>(0xff << (8 - partial));
+
+    std::fill(value.begin() + whole + (partial != 0 ? 1 : 0), value.end(), 0);
+    return value;
+}
+
+bool blacklist::contains(const asio::ipv6& ip) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    for (const auto& entry: prefixes_)
+    {
+        const auto& keys = entry.second;
+
+        if (keys.find(mask(ip, entry.first)) != keys.end())
+            return true;
+    }
+
+    return false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void blacklist::insert(const asio::ipv6& ip, uint8_t prefix)
+{
+    prefix = std::min(prefix, address_prefix);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (prefixes_[prefix].insert(mask(ip, prefix)).second)
+        ++size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool blacklist::erase(const asio::ipv6& ip, uint8_t prefix)
+{
+    prefix = std::min(prefix, address_prefix);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto it = prefixes_.find(prefix);
+
+    if (it == prefixes_.end() || it->second.erase(mask(ip, prefix)) == 0)
+        return false;
+
+    // Empty prefix lengths are dropped so that lookups skip them.
+    if (it->second.empty())
+        prefixes_.erase(it);
+
+    --size_;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t blacklist::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,353 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/bloom_filter.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::chain;
+using namespace bc::machine;
+using namespace bc::message;
+
+// Seeds of successive hash functions are spaced by this constant (bip37).
+static const uint32_t seed_multiplier = 0xfba4c795;
+
+// Bound the memory of cached match results, which are cleared when full.
+static const size_t maximum_results = 50000;
+
+static inline uint32_t rotate_left(uint32_t value, uint8_t shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+bloom_filter::bloom_filter(const filter_load& message)
+  : hash_functions_(message.hash_functions()),
+    tweak_(message.tweak()),
+    flags_(message.flags()),
+    data_(message.filter())
+{
+}
+
+bool bloom_filter::valid(const filter_load& message)
+{
+    return message.filter().size() <= maximum_size &&
+        message.hash_functions() <= maximum_hash_functions;
+}
+
+uint32_t bloom_filter::murmur3(uint32_t seed, const data_slice& data)
+{
+    static const uint32_t c1 = 0xcc9e2d51;
+    static const uint32_t c2 = 0x1b873593;
+
+    const auto size = data.size();
+    const auto bytes = data.data();
+    const auto blocks = size / 4;
+    auto hash = seed;
+
+    for (size_t block = 0; block < blocks; ++block)
+    {
+        const auto chunk = bytes + block * 4;
+        auto k1 = uint32_t(chunk[0]) | (uint32_t(chunk[1]) << 8) |
+            (uint32_t(chunk[2]) << 16) | (uint32_t(chunk[3]) << 24);
+
+        k1 *= c1;
+        k1 = rotate_left(k1, 15);
+        k1 *= c2;
+
+        hash ^= k1;
+        hash = rotate_left(hash, 13);
+        hash = hash * 5 + 0xe6546b64;
+    }
+
+    const auto tail = bytes + blocks * 4;
+    uint32_t k1 = 0;
+
+    switch (size & 3)
+    {
+        case 3:
+            k1 ^= uint32_t(tail[2]) << 16;
+            // fall through
+        case 2:
+            k1 ^= uint32_t(tail[1]) << 8;
+            // fall through
+        case 1:
+            k1 ^= uint32_t(tail[0]);
+            k1 *= c1;
+            k1 = rotate_left(k1, 15);
+            k1 *= c2;
+            hash ^= k1;
+    }
+
+    hash ^= static_cast<uint32_t>(size);
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6b;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+// private, call under mutex.
+// An empty filter matches everything (bip37).
+bool bloom_filter::test(const data_slice& element) const
+{
+    if (data_.empty())
+        return true;
+
+    const auto bits = data_.size() * 8;
+
+    for (uint32_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto seed = function * seed_multiplier + tweak_;
+        const auto bit = murmur3(seed, element) % bits;
+
+        if ((data_[bit >> 3] & (1 << (bit & 7))) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+// private, call under mutex.
+void bloom_filter::set(const data_slice& element)
+{
+    if (data_.empty())
+        return;
+
+    const auto bits = data_.size() * 8;
+
+    for (uint32_t function = 0; function < hash_functions_; ++function)
+    {
+        const auto seed = function * seed_multiplier + tweak_;
+        const auto bit = murmur3(seed, element) % bits;
+        data_[bit >> 3] |= (1 << (bit & 7));
+    }
+}
+
+void bloom_filter::insert(const data_slice& element)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    set(element);
+
+    // An added element may match transactions that did not match before.
+    results_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool bloom_filter::contains(const data_slice& element) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return test(element);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private, call under mutex.
+// This is the matching and update of bip37, outputs are tested first so
+// that outpoints inserted for them match spends within the same block.
+bool bloom_filter::evaluate(const transaction& tx, bool& updated)
+{
+    updated = false;
+    const auto hash = tx.hash();
+    auto found = test(hash);
+    const auto& outputs = tx.outputs();
+
+    for (uint32_t index = 0; index < outputs.size(); ++index)
+    {
+        const auto& script = outputs[index].script();
+
+        for (const auto& op: script.operations())
+        {
+            const auto& data = op.data();
+
+            if (data.empty() || !test(data))
+                continue;
+
+            found = true;
+            const auto pattern = script.output_pattern();
+
+            if (flags_ == update::all ||
+                (flags_ == update::pay_public_key_only &&
+                (pattern == script_pattern::pay_public_key ||
+                    pattern == script_pattern::pay_multisig)))
+            {
+                set(output_point(hash, index).to_data());
+                updated = true;
+            }
+
+            break;
+        }
+    }
+
+    if (found)
+        return true;
+
+    for (const auto& input: tx.inputs())
+    {
+        if (test(input.previous_output().to_data()))
+            return true;
+
+        for (const auto& op: input.script().operations())
+        {
+            const auto& data = op.data();
+
+            if (!data.empty() && test(data))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+bool bloom_filter::matches(const transaction& tx)
+{
+    const auto hash = tx.hash();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // A filter updated by matching may later match a spend that did not
+    // match before its funding transaction, so its results are not cached.
+    if (flags_ != update::none)
+    {
+        bool updated;
+        const auto result = evaluate(tx, updated);
+
+        if (updated)
+            results_.clear();
+
+        return result;
+    }
+
+    const auto cached = results_.find(hash);
+
+    if (cached != results_.end())
+        return cached->second;
+
+    if (results_.size() >= maximum_results)
+        results_.clear();
+
+    bool updated;
+    const auto result = evaluate(tx, updated);
+    results_.emplace(hash, result);
+    return result;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Partial merkle tree.
+// ----------------------------------------------------------------------------
+
+static size_t tree_width(size_t count, size_t height)
+{
+    return (count + (size_t(1) << height) - 1) >> height;
+}
+
+static hash_digest tree_hash(const hash_list& leaves, size_t height,
+    size_t position)
+{
+    if (height == 0)
+        return leaves[position];
+
+    const auto left = tree_hash(leaves, height - 1, position * 2);
+    const auto right = position * 2 + 1 < tree_width(leaves.size(),
+        height - 1) ? tree_hash(leaves, height - 1, position * 2 + 1) : left;
+
+    return bitcoin_hash(build_chunk({ left, right }));
+}
+
+// Depth-first, a node is descended only if it is the parent of a match.
+static void traverse(const hash_list& leaves, const std::vector<bool>& hits,
+    size_t height, size_t position, std::vector<bool>& bits,
+    hash_list& hashes)
+{
+    const auto count = leaves.size();
+    const auto begin = position << height;
+    const auto end = std::min((position + 1) << height, count);
+    const auto parent = std::any_of(hits.begin() + begin, hits.begin() + end,
+        [](bool hit) { return hit; });
+
+    bits.push_back(parent);
+
+    if (height == 0 || !parent)
+    {
+        hashes.push_back(tree_hash(leaves, height, position));
+        return;
+    }
+
+    traverse(leaves, hits, height - 1, position * 2, bits, hashes);
+
+    if (position * 2 + 1 < tree_width(count, height - 1))
+        traverse(leaves, hits, height - 1, position * 2 + 1, bits, hashes);
+}
+
+merkle_block bloom_filter::filter(const block& block,
+    std::vector<size_t>& matched)
+{
+    const auto& transactions = block.transactions();
+    hash_list leaves;
+    std::vector<bool> hits;
+    leaves.reserve(transactions.size());
+    hits.reserve(transactions.size());
+    matched.clear();
+
+    for (size_t index = 0; index < transactions.size(); ++index)
+    {
+        const auto& tx = transactions[index];
+        const auto hit = matches(tx);
+        leaves.push_back(tx.hash());
+        hits.push_back(hit);
+
+        if (hit)
+            matched.push_back(index);
+    }
+
+    if (leaves.empty())
+        return merkle_block(block.header(), 0, {}, {});
+
+    size_t height = 0;
+    while (tree_width(leaves.size(), height) > 1)
+        ++height;
+
+    std::vector<bool> bits;
+    hash_list hashes;
+    traverse(leaves, hits, height, 0, bits, hashes);
+
+    // Flag bits are packed least significant first.
+    data_chunk flags((bits.size() + 7) / 8, 0);
+    for (size_t bit = 0; bit < bits.size(); ++bit)
+        if (bits[bit])
+            flags[bit / 8] |= (1 << (bit % 8));
+
+    return merkle_block(block.header(), leaves.size(), hashes, flags);
+}
+
+} // namespace network
+} // namespace libbitcoin
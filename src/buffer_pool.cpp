@@ -0,0 +1,157 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/buffer_pool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// The smallest class covers nearly all non-block messages (4KiB).
+static const size_t minimum_class_bits = 12;
+
+// Classes run up to 2GiB, beyond any valid payload size.
+static const size_t class_count = 20;
+
+// Limit the memory retained by each class, independent of buffer count.
+static const size_t maximum_class_bytes = 16 * 1024 * 1024;
+
+buffer_pool::buffer_pool(size_t retained)
+  : retained_(retained),
+    classes_(class_count),
+    retained_bytes_(0)
+{
+}
+
+// private
+size_t buffer_pool::class_index(size_t size)
+{
+    size_t index = 0;
+
+    while (index < class_count - 1 && class_size(index) < size)
+        ++index;
+
+    return index;
+}
+
+// private
+size_t buffer_pool::class_size(size_t index)
+{
+    return size_t(1) << (minimum_class_bits + index);
+}
+
+// private
+size_t buffer_pool::class_limit(size_t index) const
+{
+    const auto by_size = maximum_class_bytes / class_size(index);
+    return std::max(std::min(retained_, by_size), size_t(1));
+}
+
+data_chunk buffer_pool::acquire(size_t size)
+{
+    const auto index = class_index(size);
+    data_chunk buffer;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    auto& available = classes_[index];
+
+    if (!available.empty())
+    {
+        buffer = std::move(available.back());
+        available.pop_back();
+        retained_bytes_ -= buffer.capacity();
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Allocate the full class size so that the buffer is reusable by class.
+    if (buffer.capacity() < size)
+        buffer.reserve(std::max(class_size(index), size));
+
+    // This does not cause a reallocation.
+    buffer.resize(size);
+    return buffer;
+}
+
+void buffer_pool::release(data_chunk&& buffer)
+{
+    const auto capacity = buffer.capacity();
+
+    // Buffers smaller than the minimum class are not worth retaining.
+    if (capacity < class_size(0))
+        return;
+
+    // Classify by capacity, rounding down so acquire never reallocates.
+    auto index = class_index(capacity);
+    if (class_size(index) > capacity)
+        --index;
+
+    buffer.clear();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    auto& available = classes_[index];
+
+    if (available.size() < class_limit(index))
+    {
+        retained_bytes_ += capacity;
+        available.push_back(std::move(buffer));
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t buffer_pool::retained_bytes() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return retained_bytes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+pooled_buffer::pooled_buffer(buffer_pool& pool, size_t size)
+  : pool_(pool),
+    buffer_(pool.acquire(size))
+{
+}
+
+pooled_buffer::~pooled_buffer()
+{
+    pool_.release(std::move(buffer_));
+}
+
+data_chunk& pooled_buffer::data()
+{
+    return buffer_;
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -24,7 +24,9 @@
 #include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/proxy.hpp>
 #include <bitcoin/network/settings.hpp>
 
@@ -34,20 +36,41 @@ namespace network {
 using namespace bc::message;
 using namespace std::placeholders;
 
-// Factory for deadline timer pointer construction.
-static deadline::ptr alarm(threadpool& pool, const asio::duration& duration)
+// Channel ids are unique within the process.
+static std::atomic<uint64_t> next_id(0);
+
+// The number of addresses remembered as known to the peer.
+static const size_t known_address_capacity = 5000;
+
+static int64_t now()
 {
-    // TODO: don't apply this to inactivity.
-    return std::make_shared<deadline>(pool, pseudo_randomize(duration));
+    return asio::steady_clock::now().time_since_epoch().count();
 }
 
-channel::channel(threadpool& pool, socket::ptr socket,
-    const settings& settings)
-  : proxy(pool, socket, settings),
+channel::channel(threadpool& pool, buffer_pool& buffers, timer_wheel& timers,
+    transport::ptr transport, const settings& settings)
+  : proxy(pool, buffers, transport, settings),
+    id_(++next_id),
     notify_(false),
+    outbound_(false),
+    inbound_(false),
+    started_(asio::steady_clock::now()),
+    last_useful_(0),
+    headers_preferred_(false),
+    fee_filter_(0),
+    relay_enabled_(false),
     nonce_(0),
-    expiration_(alarm(pool, settings.channel_expiration())),
-    inactivity_(alarm(pool, settings.channel_inactivity())),
+    announcements_(settings.relay_known_inventory),
+    requests_(settings.request_window_minimum,
+        settings.request_window_maximum, settings.request_timeout_minimum(),
+        settings.request_timeout_maximum()),
+    timers_(timers),
+    known_addresses_(known_address_capacity),
+    expiration_(pseudo_randomize(settings.channel_expiration())),
+    inactivity_(settings.channel_inactivity()),
+    last_activity_(now()),
+    expiration_timer_(0),
+    inactivity_timer_(0),
     CONSTRUCT_TRACK(channel)
 {
 }
@@ -67,13 +90,25 @@ void channel::start(result_handler handler)
 void channel::do_start(const code& ec, result_handler handler)
 {
     start_expiration();
-    start_inactivity();
+    start_inactivity(inactivity_);
     handler(error::success);
 }
 
 // Properties.
 // ----------------------------------------------------------------------------
 
+uint64_t channel::id() const
+{
+    return id_;
+}
+
+void channel::set_timeouts(const asio::duration& expiration,
+    const asio::duration& inactivity)
+{
+    expiration_ = pseudo_randomize(expiration);
+    inactivity_ = inactivity;
+}
+
 bool channel::notify() const
 {
     return notify_;
@@ -84,6 +119,83 @@ void channel::set_notify(bool value)
     notify_ = value;
 }
 
+bool channel::outbound() const
+{
+    return outbound_;
+}
+
+void channel::set_outbound(bool value)
+{
+    outbound_ = value;
+}
+
+bool channel::inbound() const
+{
+    return inbound_;
+}
+
+void channel::set_inbound(bool value)
+{
+    inbound_ = value;
+}
+
+asio::time_point channel::started() const
+{
+    return started_;
+}
+
+asio::time_point channel::last_useful() const
+{
+    const auto ticks = last_useful_.load();
+    return ticks == 0 ? asio::time_point() :
+        asio::time_point(asio::duration(ticks));
+}
+
+void channel::set_useful()
+{
+    last_useful_ = now();
+}
+
+bool channel::headers_preferred() const
+{
+    return headers_preferred_;
+}
+
+void channel::set_headers_preferred(bool value)
+{
+    headers_preferred_ = value;
+}
+
+uint64_t channel::fee_filter() const
+{
+    return fee_filter_;
+}
+
+void channel::set_fee_filter(uint64_t value)
+{
+    fee_filter_ = value;
+}
+
+bloom_filter::ptr channel::filter() const
+{
+    return filter_.load();
+}
+
+void channel::set_filter(bloom_filter::ptr value)
+{
+    filter_.store(value);
+}
+
+bool channel::peer_relay() const
+{
+    return relay_enabled_ || peer_version()->relay();
+}
+
+void channel::enable_peer_relay()
+{
+    relay_enabled_ = true;
+}
+
 uint64_t channel::nonce() const
 {
     return nonce_;
@@ -106,19 +218,102 @@ void channel::set_peer_version(version_const_ptr value)
     peer_version_.store(value);
 }
 
+inventory_queue& channel::announcements()
+{
+    return announcements_;
+}
+
+request_tracker& channel::requests()
+{
+    return requests_;
+}
+
+// Known addresses.
+// ----------------------------------------------------------------------------
+// Addresses are identified by ip and port, independent of timestamp.
+
+static hash_digest address_hash(const message::network_address& address)
+{
+    return sha256_hash(address.to_data(message::version::level::minimum,
+        false));
+}
+
+void channel::known_addresses(const message::network_address::list& list)
+{
+    std::vector<hash_digest> hashes;
+    hashes.reserve(list.size());
+
+    for (const auto& address: list)
+        hashes.push_back(address_hash(address));
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(address_mutex_);
+
+    for (const auto& hash: hashes)
+        known_addresses_.insert(hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool channel::unknown_addresses(
+    const message::network_address::list& list) const
+{
+    std::vector<hash_digest> hashes;
+    hashes.reserve(list.size());
+
+    for (const auto& address: list)
+        hashes.push_back(address_hash(address));
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(address_mutex_);
+
+    for (const auto& hash: hashes)
+        if (!known_addresses_.contains(hash))
+            return true;
+
+    return false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+message::network_address::list channel::mark_addresses(
+    const message::network_address::list& list)
+{
+    message::network_address::list unknown;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(address_mutex_);
+
+    for (const auto& address: list)
+    {
+        const auto hash = address_hash(address);
+
+        if (known_addresses_.contains(hash))
+            continue;
+
+        known_addresses_.insert(hash);
+        unknown.push_back(address);
+    }
+
+    return unknown;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // Proxy pure virtual protected and ordered handlers.
 // ----------------------------------------------------------------------------
 
 // It is possible that this may be called multiple times.
 void channel::handle_stopping()
 {
-    expiration_->stop();
-    inactivity_->stop();
+    timers_.cancel(expiration_timer_);
+    timers_.cancel(inactivity_timer_);
 }
 
+// Activity only records the time, the inactivity timer checks it lazily.
 void channel::signal_activity()
 {
-    start_inactivity();
+    last_activity_ = now();
 }
 
 bool channel::stopped(const code& ec) const
@@ -135,9 +330,13 @@ void channel::start_expiration()
     if (proxy::stopped())
         return;
 
-    expiration_->start(
+    expiration_timer_ = timers_.schedule(expiration_,
         std::bind(&channel::handle_expiration,
             shared_from_base<channel>(), _1));
+
+    // Do not retain the channel in the wheel if stopped during schedule.
+    if (proxy::stopped())
+        timers_.cancel(expiration_timer_);
 }
 
 void channel::handle_expiration(const code& ec)
@@ -145,20 +344,24 @@ void channel::handle_expiration(const code& ec)
     if (stopped(ec))
         return;
 
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Channel lifetime expired [" << authority() << "]";
 
     stop(error::channel_timeout);
 }
 
-void channel::start_inactivity()
+void channel::start_inactivity(const asio::duration& delay)
 {
     if (proxy::stopped())
         return;
 
-    inactivity_->start(
+    inactivity_timer_ = timers_.schedule(delay,
         std::bind(&channel::handle_inactivity,
             shared_from_base<channel>(), _1));
+
+    // Do not retain the channel in the wheel if stopped during schedule.
+    if (proxy::stopped())
+        timers_.cancel(inactivity_timer_);
 }
 
 void channel::handle_inactivity(const code& ec)
@@ -166,7 +369,16 @@ void channel::handle_inactivity(const code& ec)
     if (stopped(ec))
         return;
 
-    LOG_DEBUG(LOG_NETWORK)
+    const asio::duration idle(now() - last_activity_);
+
+    // Activity occurred since scheduling, so wait out the remainder.
+    if (idle < inactivity_)
+    {
+        start_inactivity(inactivity_ - idle);
+        return;
+    }
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Channel inactivity timeout [" << authority() << "]";
 
     stop(error::channel_timeout);
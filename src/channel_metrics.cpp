@@ -0,0 +1,217 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/channel_metrics.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::message;
+
+// Smoothing as rfc6298 (retransmission timer), gains of 1/8 and 1/4.
+static const int64_t average_gain = 8;
+static const int64_t jitter_gain = 4;
+
+// Counters are independent, so no ordering is required.
+static const auto relaxed = std::memory_order_relaxed;
+
+static uint64_t to_microseconds(const asio::duration& value)
+{
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<microseconds>(value).count());
+}
+
+const std::vector<std::string>& channel_metrics::commands()
+{
+    static const std::vector<std::string> list
+    {
+        address::command,
+        alert::command,
+        block::command,
+        block_transactions::command,
+        compact_block::command,
+        fee_filter::command,
+        filter_add::command,
+        filter_clear::command,
+        filter_load::command,
+        get_address::command,
+        get_blocks::command,
+        get_block_transactions::command,
+        get_data::command,
+        get_headers::command,
+        headers::command,
+        inventory::command,
+        memory_pool::command,
+        merkle_block::command,
+        not_found::command,
+        ping::command,
+        pong::command,
+        reject::command,
+        send_compact::command,
+        send_headers::command,
+        transaction::command,
+        verack::command,
+        version::command,
+        "other"
+    };
+
+    return list;
+}
+
+// private
+size_t channel_metrics::index(const std::string& command)
+{
+    typedef std::unordered_map<std::string, size_t> index_map;
+
+    static const auto map = []()
+    {
+        index_map out;
+        const auto& list = commands();
+
+        for (size_t position = 0; position < list.size() - 1; ++position)
+            out.emplace(list[position], position);
+
+        return out;
+    }();
+
+    const auto it = map.find(command);
+    return it == map.end() ? commands().size() - 1 : it->second;
+}
+
+channel_metrics::snapshot::snapshot()
+  : types(commands().size(), counters{ 0, 0, 0, 0, 0, 0 }),
+    pings(0),
+    ping_microseconds(0)
+{
+}
+
+void channel_metrics::snapshot::add(const snapshot& other)
+{
+    for (size_t position = 0; position < types.size(); ++position)
+    {
+        auto& to = types[position];
+        const auto& from = other.types[position];
+        to.messages_in += from.messages_in;
+        to.bytes_in += from.bytes_in;
+        to.parse_microseconds += from.parse_microseconds;
+        to.messages_out += from.messages_out;
+        to.bytes_out += from.bytes_out;
+        to.send_wait_microseconds += from.send_wait_microseconds;
+    }
+
+    pings += other.pings;
+    ping_microseconds += other.ping_microseconds;
+}
+
+// Value initialization zeroes the atomic counters.
+channel_metrics::channel_metrics()
+  : types_(commands().size()),
+    pings_(0),
+    ping_microseconds_(0),
+    latency_{ 0, asio::duration::zero(), asio::duration::zero(),
+        asio::duration::zero() }
+{
+}
+
+void channel_metrics::received(const std::string& command, size_t bytes,
+    const asio::duration& parse)
+{
+    auto& type = types_[index(command)];
+    type.messages_in.fetch_add(1, relaxed);
+    type.bytes_in.fetch_add(bytes, relaxed);
+    type.parse_microseconds.fetch_add(to_microseconds(parse), relaxed);
+}
+
+void channel_metrics::sent(const std::string& command, size_t bytes,
+    const asio::duration& wait)
+{
+    auto& type = types_[index(command)];
+    type.messages_out.fetch_add(1, relaxed);
+    type.bytes_out.fetch_add(bytes, relaxed);
+    type.send_wait_microseconds.fetch_add(to_microseconds(wait), relaxed);
+}
+
+void channel_metrics::pinged(const asio::duration& sample)
+{
+    pings_.fetch_add(1, relaxed);
+    ping_microseconds_.fetch_add(to_microseconds(sample), relaxed);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (latency_.samples++ == 0)
+    {
+        latency_.minimum = sample;
+        latency_.average = sample;
+        latency_.jitter = sample / 2;
+        return;
+    }
+
+    const auto deviation = sample > latency_.average ?
+        sample - latency_.average : latency_.average - sample;
+
+    latency_.minimum = std::min(latency_.minimum, sample);
+    latency_.jitter += (deviation - latency_.jitter) / jitter_gain;
+    latency_.average += (sample - latency_.average) / average_gain;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+channel_metrics::round_trip channel_metrics::latency() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return latency_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+channel_metrics::snapshot channel_metrics::collect() const
+{
+    snapshot out;
+
+    for (size_t position = 0; position < types_.size(); ++position)
+    {
+        const auto& from = types_[position];
+        auto& to = out.types[position];
+        to.messages_in = from.messages_in.load(relaxed);
+        to.bytes_in = from.bytes_in.load(relaxed);
+        to.parse_microseconds = from.parse_microseconds.load(relaxed);
+        to.messages_out = from.messages_out.load(relaxed);
+        to.bytes_out = from.bytes_out.load(relaxed);
+        to.send_wait_microseconds = from.send_wait_microseconds.load(relaxed);
+    }
+
+    out.pings = pings_.load(relaxed);
+    out.ping_microseconds = ping_microseconds_.load(relaxed);
+    return out;
+}
+
+} // namespace network
+} // namespace libbitcoin
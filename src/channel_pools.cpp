@@ -0,0 +1,74 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/channel_pools.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// private
+channel_pools::pools channel_pools::create(size_t count)
+{
+    pools result;
+    result.reserve(count);
+
+    for (size_t index = 0; index < count; ++index)
+        result.push_back(std::make_shared<threadpool>(0));
+
+    return result;
+}
+
+channel_pools::channel_pools(threadpool& shared, size_t count)
+  : shared_(shared),
+    pools_(create(count)),
+    next_(0)
+{
+}
+
+void channel_pools::spawn()
+{
+    for (const auto pool: pools_)
+        pool->spawn(1, thread_priority::normal);
+}
+
+void channel_pools::shutdown()
+{
+    for (const auto pool: pools_)
+        pool->shutdown();
+}
+
+void channel_pools::join()
+{
+    for (const auto pool: pools_)
+        pool->join();
+}
+
+threadpool& channel_pools::select()
+{
+    if (pools_.empty())
+        return shared_;
+
+    return *pools_[next_++ % pools_.size()];
+}
+
+} // namespace network
+} // namespace libbitcoin
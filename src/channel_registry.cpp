@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/channel_registry.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/functional/hash.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+channel_registry::channel_registry(size_t initial_capacity)
+  : stopped_(false),
+    snapshot_(std::make_shared<const list>())
+{
+    channels_.reserve(initial_capacity);
+    authorities_.reserve(initial_capacity);
+    nonces_.reserve(initial_capacity);
+}
+
+size_t channel_registry::authority_hash::operator()(
+    const config::authority& authority) const
+{
+    const auto bytes = authority.ip().to_bytes();
+    auto seed = boost::hash_range(bytes.begin(), bytes.end());
+    boost::hash_combine(seed, authority.port());
+    return seed;
+}
+
+// private, call under exclusive lock.
+// Iteration is far more frequent than registration, so the snapshot is
+// rebuilt on change rather than copied on each iteration.
+void channel_registry::update_snapshot()
+{
+    const auto channels = std::make_shared<list>();
+    channels->reserve(channels_.size());
+
+    for (const auto& entry: channels_)
+        channels->push_back(entry.second);
+
+    std::atomic_store(&snapshot_, list_ptr(channels));
+}
+
+size_t channel_registry::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return channels_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+code channel_registry::store(channel::ptr channel, bool unique_authority)
+{
+    const auto authority = channel->authority();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (stopped_)
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return error::service_stopped;
+    }
+
+    if (unique_authority && authorities_.find(authority) != authorities_.end())
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return error::address_in_use;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    if (channels_.emplace(channel->id(), channel).second)
+    {
+        ++authorities_[authority];
+        ++nonces_[channel->nonce()];
+        update_snapshot();
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return error::success;
+}
+
+void channel_registry::remove(channel::ptr channel)
+{
+    // The nonce is fixed before the channel is registered.
+    const auto authority = channel->authority();
+    const auto nonce = channel->nonce();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (channels_.erase(channel->id()) == 0)
+        return;
+
+    const auto by_authority = authorities_.find(authority);
+
+    if (by_authority != authorities_.end() && --by_authority->second == 0)
+        authorities_.erase(by_authority);
+
+    const auto by_nonce = nonces_.find(nonce);
+
+    if (by_nonce != nonces_.end() && --by_nonce->second == 0)
+        nonces_.erase(by_nonce);
+
+    update_snapshot();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool channel_registry::exists(const config::authority& authority) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return authorities_.find(authority) != authorities_.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool channel_registry::exists(uint64_t nonce) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return nonces_.find(nonce) != nonces_.end();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+channel::ptr channel_registry::find(uint64_t id) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    const auto it = channels_.find(id);
+    return it == channels_.end() ? nullptr : it->second;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+channel_registry::list_ptr channel_registry::snapshot() const
+{
+    return std::atomic_load(&snapshot_);
+}
+
+void channel_registry::stop(const code& ec)
+{
+    list_ptr stopping;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    stopped_ = true;
+    stopping = std::atomic_load(&snapshot_);
+    channels_.clear();
+    authorities_.clear();
+    nonces_.clear();
+    update_snapshot();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Channels are stopped outside of the lock, as stop handlers may remove.
+    for (const auto& channel: *stopping)
+        channel->stop(ec);
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,176 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/connect_scheduler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/hosts.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::asio;
+using namespace bc::config;
+
+// The weight of each attempt in the moving success rate.
+static const double rate_weight = 0.05;
+
+// The success rate below which the batch size stops growing.
+static const double minimum_rate = 0.2;
+
+// The batch grows to at most this multiple of the configured size.
+static const size_t batch_multiple = 4;
+
+// The backoff of the first consecutive failure, doubling thereafter.
+static const auto backoff_base = seconds(1);
+
+connect_scheduler::connect_scheduler(size_t slots, size_t batch_size,
+    const duration& maximum)
+  : batch_size_(std::max(batch_size, size_t(1))),
+    maximum_(std::max(maximum, duration(backoff_base))),
+    success_rate_(1.0),
+    slots_(slots, { 0, false, 0 })
+{
+}
+
+uint32_t connect_scheduler::group(const authority& host)
+{
+    return hosts::group(host.to_network_address());
+}
+
+// Jitter keeps failing peers from retrying in lockstep (e.g. on partition).
+duration connect_scheduler::backoff(size_t failures, const duration& base,
+    const duration& maximum)
+{
+    if (failures == 0)
+        return duration::zero();
+
+    // Limit the shift to avoid overflow, the maximum bounds the result.
+    const auto shift = std::min(failures - 1, size_t(16));
+    const auto delay = base * (size_t(1) << shift);
+    return pseudo_randomize(std::min(delay, maximum));
+}
+
+// A pool of mostly dead addresses requires more attempts per connection.
+size_t connect_scheduler::batch_size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    const auto rate = std::max(success_rate_, minimum_rate);
+    const auto scaled = static_cast<size_t>(std::ceil(batch_size_ / rate));
+    return std::min(scaled, batch_size_ * batch_multiple);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+duration connect_scheduler::delay(size_t slot) const
+{
+    size_t failures;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    failures = slot < slots_.size() ? slots_[slot].failures : 0;
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return backoff(failures, backoff_base, maximum_);
+}
+
+hosts::groups connect_scheduler::groups() const
+{
+    hosts::groups out;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    for (const auto& state: slots_)
+        if (state.connected)
+            out.insert(state.group);
+
+    return out;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void connect_scheduler::attempted(bool success)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    success_rate_ += rate_weight * ((success ? 1.0 : 0.0) - success_rate_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void connect_scheduler::failed(size_t slot)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slot < slots_.size())
+    {
+        ++slots_[slot].failures;
+        slots_[slot].connected = false;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void connect_scheduler::connected(size_t slot, const authority& host)
+{
+    const auto key = group(host);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slot < slots_.size())
+        slots_[slot] = { 0, true, key };
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void connect_scheduler::disconnected(size_t slot)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slot < slots_.size())
+        slots_[slot].connected = false;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void connect_scheduler::resize(size_t slots)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slots > slots_.size())
+        slots_.resize(slots, { 0, false, 0 });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -25,8 +25,11 @@
 #include <string>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
 #include <bitcoin/network/proxy.hpp>
 #include <bitcoin/network/settings.hpp>
+#include <bitcoin/network/socket_options.hpp>
+#include <bitcoin/network/socket_transport.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -36,12 +39,20 @@ namespace network {
 using namespace bc::config;
 using namespace std::placeholders;
 
-connector::connector(threadpool& pool, const settings& settings)
+connector::connector(threadpool& pool, channel_pools& pools,
+    buffer_pool& buffers, timer_wheel& timers, resolver_cache& resolver,
+    const settings& settings)
   : stopped_(false),
     pool_(pool),
+    pools_(pools),
+    buffers_(buffers),
+    timers_(timers),
     settings_(settings),
     dispatch_(pool, NAME),
-    resolver_(pool.service()),
+    resolver_(resolver),
+    options_(settings),
+    timer_(std::make_shared<deadline>(pool, settings.connect_timeout())),
+    timeout_(settings.connect_timeout()),
     CONSTRUCT_TRACK(connector)
 {
 }
@@ -62,11 +73,8 @@ void connector::stop(const code&)
         mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
-        // This will asynchronously invoke the handler of the pending resolve.
-        resolver_.cancel();
-
-        if (timer_)
-            timer_->stop();
+        // A shared resolve is not canceled, its completion is ignored.
+        timer_->stop();
 
         stopped_ = true;
         //---------------------------------------------------------------------
@@ -78,6 +86,32 @@ void connector::stop(const code&)
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void connector::set_timeout(const asio::duration& timeout)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    timeout_ = timeout;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Each attempt binds its own join handler, so completions of the prior
+// attempt (such as a canceled timer) cannot reach a subsequent attempt.
+bool connector::recycle()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (stopped())
+        return false;
+
+    timer_->stop();
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // private
 bool connector::stopped() const
 {
@@ -109,21 +143,16 @@ void connector::connect(const std::string& hostname, uint16_t port,
         return;
     }
 
-    query_ = std::make_shared<asio::query>(hostname, std::to_string(port));
-
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
 
-    // async_resolve will not invoke the handler within this function.
-    resolver_.async_resolve(*query_,
+    // Resolution is shared and cached, this may invoke the handler directly.
+    resolver_.resolve(hostname, port,
         std::bind(&connector::handle_resolve,
             shared_from_this(), _1, _2, handler));
-
-    mutex_.unlock();
-    ///////////////////////////////////////////////////////////////////////////
 }
 
-void connector::handle_resolve(const boost_code& ec, asio::iterator iterator,
+void connector::handle_resolve(const code& ec, endpoints_ptr hosts,
     connect_handler handler)
 {
     using namespace boost::asio;
@@ -148,8 +177,10 @@ void connector::handle_resolve(const boost_code& ec, asio::iterator iterator,
         return;
     }
 
-    const auto socket = std::make_shared<bc::socket>(pool_);
-    timer_ = std::make_shared<deadline>(pool_, settings_.connect_timeout());
+    // The socket is created on the pool to which the channel is assigned.
+    auto& pool = pools_.select();
+    const auto socket = std::allocate_shared<bc::socket>(
+        pool_allocator<bc::socket>(), pool);
 
     // Manage the timer-connect race, returning upon first completion.
     const auto join_handler = synchronize(handler, 1, NAME,
@@ -158,21 +189,23 @@ void connector::handle_resolve(const boost_code& ec, asio::iterator iterator,
     // timer.async_wait will not invoke the handler within this function.
     timer_->start(
         std::bind(&connector::handle_timer,
-            shared_from_this(), _1, socket, join_handler));
+            shared_from_this(), _1, socket, join_handler), timeout_);
 
     // async_connect will not invoke the handler within this function.
     // The bound delegate ensures handler completion before loss of scope.
-    async_connect(socket->get(), iterator,
+    async_connect(socket->get(), hosts->begin(), hosts->end(),
         std::bind(&connector::handle_connect,
-            shared_from_this(), _1, _2, socket, join_handler));
+            shared_from_this(), _1, _2, hosts, socket, std::ref(pool),
+                join_handler));
 
     mutex_.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 }
 
 // private:
-void connector::handle_connect(const boost_code& ec, asio::iterator,
-    socket::ptr socket, connect_handler handler)
+void connector::handle_connect(const boost_code& ec,
+    endpoints::const_iterator, endpoints_ptr, socket::ptr socket,
+    threadpool& pool, connect_handler handler)
 {
     if (ec)
     {
@@ -180,8 +213,16 @@ void connector::handle_connect(const boost_code& ec, asio::iterator,
         return;
     }
 
+    options_.apply(socket->get());
+
+    // Channel objects are recycled by type, limiting churn fragmentation.
+    const auto transport = std::allocate_shared<socket_transport>(
+        pool_allocator<socket_transport>(), socket);
+
     // Ensure that channel is not passed as an r-value.
-    const auto created = std::make_shared<channel>(pool_, socket, settings_);
+    const auto created = std::allocate_shared<channel>(
+        pool_allocator<channel>(), pool, buffers_, timers_, transport,
+        settings_);
     handler(error::success, created);
 }
 
@@ -0,0 +1,144 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/eviction.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <boost/functional/hash.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/connect_scheduler.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// Protections are applied in this order, each to the survivors of the last.
+static const size_t protected_groups = 4;
+static const size_t protected_pings = 8;
+static const size_t protected_relays = 4;
+
+eviction::eviction()
+  : key_(pseudo_random())
+{
+}
+
+// private
+// Remove up to count candidates ranked first by the comparison.
+template <typename Compare>
+void eviction::protect(candidates& values, size_t count, Compare compare)
+{
+    count = std::min(count, values.size());
+    std::sort(values.begin(), values.end(), compare);
+    values.erase(values.begin(), values.begin() + count);
+}
+
+channel::ptr eviction::select(const channel_registry::list& channels) const
+{
+    candidates remaining;
+    remaining.reserve(channels.size());
+
+    for (const auto channel: channels)
+    {
+        const auto group = connect_scheduler::group(channel->authority());
+        const auto latency = channel->metrics().latency();
+        auto keyed_group = static_cast<size_t>(key_);
+        boost::hash_combine(keyed_group, group);
+
+        remaining.push_back(
+        {
+            channel,
+            group,
+            keyed_group,
+            latency.samples == 0 ? asio::duration::max() : latency.minimum,
+            channel->last_useful(),
+            channel->started()
+        });
+    }
+
+    protect(remaining, protected_groups,
+        [](const candidate& left, const candidate& right)
+        {
+            return left.keyed_group > right.keyed_group;
+        });
+
+    protect(remaining, protected_pings,
+        [](const candidate& left, const candidate& right)
+        {
+            return left.ping < right.ping;
+        });
+
+    // Channels that have never relayed anything useful are not protected.
+    const auto relayed = std::count_if(remaining.begin(), remaining.end(),
+        [](const candidate& value)
+        {
+            return value.useful != asio::time_point();
+        });
+
+    protect(remaining, std::min(protected_relays, size_t(relayed)),
+        [](const candidate& left, const candidate& right)
+        {
+            return left.useful > right.useful;
+        });
+
+    protect(remaining, remaining.size() / 2,
+        [](const candidate& left, const candidate& right)
+        {
+            return left.started < right.started;
+        });
+
+    if (remaining.empty())
+        return nullptr;
+
+    // Tally the groups, tracking the youngest channel of each.
+    struct tally
+    {
+        size_t count;
+        const candidate* youngest;
+    };
+
+    std::map<uint32_t, tally> groups;
+
+    for (const auto& value: remaining)
+    {
+        auto& entry = groups[value.group];
+
+        if (entry.count++ == 0 || value.started > entry.youngest->started)
+            entry.youngest = &value;
+    }
+
+    // Select the largest group, breaking ties by the youngest member.
+    const auto largest = std::max_element(groups.begin(), groups.end(),
+        [](const std::pair<const uint32_t, tally>& left,
+            const std::pair<const uint32_t, tally>& right)
+        {
+            if (left.second.count != right.second.count)
+                return left.second.count < right.second.count;
+
+            return left.second.youngest->started <
+                right.second.youngest->started;
+        });
+
+    return largest->second.youngest->channel;
+}
+
+} // namespace network
+} // namespace libbitcoin
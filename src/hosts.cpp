@@ -20,8 +20,15 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <ctime>
+#include <iterator>
+#include <random>
+#include <sstream>
 #include <string>
 #include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost/thread/tss.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/settings.hpp>
 
@@ -32,56 +39,616 @@ using namespace bc::config;
 
 #define NAME "hosts"
 
-// TODO: change to network_address bimap hash table with services and age.
+// Small pools are not worth dividing (buckets are at least this large).
+static const size_t minimum_bucket_capacity = 256;
+
+// Limit the bucket count so that count and stop remain cheap.
+static const size_t maximum_buckets = 64;
+
+// The tried table is one fifth of the pool, as with satoshi addrman.
+static const size_t tried_divisor = 5;
+
+// A new address is evicted after this many consecutive failures, and a
+// tried address is moved back to new.
+static const size_t maximum_attempts = 3;
+
+// Identifies the binary hosts file format ("bchg" little-endian).
+static const uint32_t binary_file_magic = 0x67686362;
+
+// Binary records use the wire format of the address message with timestamp.
+static const uint32_t binary_file_version = version::level::minimum;
+
+// Each thread has its own generator so concurrent fetches do not contend.
+static size_t random_index(size_t size)
+{
+    static boost::thread_specific_ptr<std::mt19937> twister;
+
+    if (twister.get() == nullptr)
+        twister.reset(new std::mt19937(std::random_device()()));
+
+    std::uniform_int_distribution<size_t> distribution(0, size - 1);
+    return distribution(*twister);
+}
+
+static uint32_t now()
+{
+    return static_cast<uint32_t>(std::time(nullptr));
+}
+
 hosts::hosts(const settings& settings)
-  : buffer_(std::max(settings.host_pool_capacity, 1u)),
+  : key_(pseudo_random()),
+    capacity_(std::max(settings.host_pool_capacity, 1u)),
+    tried_capacity_(std::max(bucket_capacity(capacity_) / tried_divisor,
+        size_t(1))),
+    fresh_capacity_(std::max(bucket_capacity(capacity_) - tried_capacity_,
+        size_t(1))),
+    buckets_(make_buckets(capacity_)),
     stopped_(true),
+    dirty_(false),
     file_path_(settings.hosts_file),
+    text_file_(settings.hosts_file_text),
     disabled_(settings.host_pool_capacity == 0)
 {
 }
 
 // private
-hosts::iterator hosts::find(const address& host)
+size_t hosts::bucket_count(size_t capacity)
+{
+    const auto count = capacity / minimum_bucket_capacity;
+    return std::max(std::min(count, maximum_buckets), size_t(1));
+}
+
+// private
+size_t hosts::bucket_capacity(size_t capacity)
+{
+    const auto count = bucket_count(capacity);
+    return (capacity + count - 1) / count;
+}
+
+// private
+hosts::buckets hosts::make_buckets(size_t capacity)
 {
-    const auto found = [&host](const address& entry)
+    buckets parts;
+    const auto count = bucket_count(capacity);
+    parts.reserve(count);
+
+    for (size_t part = 0; part < count; ++part)
     {
-        return entry.port() == host.port() && entry.ip() == host.ip();
-    };
+        parts.emplace_back(new bucket);
+        parts.back()->next_fresh = 0;
+        parts.back()->next_tried = 0;
+        parts.back()->table.reserve(bucket_capacity(capacity));
+    }
 
-    return std::find_if(buffer_.begin(), buffer_.end(), found);
+    return parts;
 }
 
-size_t hosts::count() const
+// Hosts are identified by ip and port, other fields are ignored.
+size_t hosts::address_hash::operator()(const address& host) const
+{
+    const auto& ip = host.ip();
+    auto seed = boost::hash_range(ip.begin(), ip.end());
+    boost::hash_combine(seed, host.port());
+    return seed;
+}
+
+bool hosts::address_equal::operator()(const address& left,
+    const address& right) const
+{
+    return left.port() == right.port() && left.ip() == right.ip();
+}
+
+// The network group is the /16 of an ipv4 address or the /32 of ipv6.
+// Mapped ipv4 groups are flagged so they cannot collide with ipv6 groups.
+uint32_t hosts::group(const address& host)
+{
+    static const size_t ipv4_offset = 12;
+    const auto& ip = host.ip();
+    const auto mapped = std::all_of(ip.begin(), ip.begin() + 10,
+        [](uint8_t byte) { return byte == 0x00; }) &&
+        ip[10] == 0xff && ip[11] == 0xff;
+
+    const auto start = mapped ? ipv4_offset : 0;
+    const auto size = mapped ? 2 : 4;
+
+    uint32_t value = mapped ? 1 : 0;
+    for (auto index = start; index < start + size; ++index)
+        value = (value << 8) | ip[index];
+
+    return value;
+}
+
+// private, call under bucket mutex.
+void hosts::count(bucket& part, const address& host)
+{
+    ++part.groups[group(host)];
+}
+
+// private, call under bucket mutex.
+void hosts::uncount(bucket& part, const address& host)
+{
+    const auto it = part.groups.find(group(host));
+
+    if (it != part.groups.end() && --it->second == 0)
+        part.groups.erase(it);
+}
+
+// private
+// Buckets are keyed by network group, salted so placement is unpredictable.
+size_t hosts::group_hash(const address& host) const
 {
+    auto seed = static_cast<size_t>(key_);
+    boost::hash_combine(seed, group(host));
+    return seed;
+}
+
+// private
+hosts::bucket& hosts::select(const address& host) const
+{
+    return *buckets_[group_hash(host) % buckets_.size()];
+}
+
+// private, call under bucket mutex.
+// Once a table is full its oldest (approximately) entry is replaced. A
+// replaced tried entry is moved to new, a replaced new entry is discarded.
+void hosts::add(bucket& part, const entry& item, bool tried)
+{
+    auto& table = tried ? part.tried : part.fresh;
+    auto& next = tried ? part.next_tried : part.next_fresh;
+    const auto limit = tried ? tried_capacity_ : fresh_capacity_;
+
+    if (table.size() < limit)
+    {
+        part.table[item.host] = { tried, table.size() };
+        table.push_back(item);
+        count(part, item.host);
+        dirty_ = true;
+        return;
+    }
+
+    next %= table.size();
+    const auto displaced = table[next];
+    part.table.erase(displaced.host);
+    uncount(part, displaced.host);
+    part.table[item.host] = { tried, next };
+    count(part, item.host);
+    table[next++] = item;
+    dirty_ = true;
+
+    if (tried)
+        add(part, { displaced.host, 0 }, false);
+}
+
+// private, call under bucket mutex.
+// Move the last entry into the vacated position to keep the table dense.
+void hosts::drop(bucket& part, const location& item)
+{
+    auto& table = item.tried ? part.tried : part.fresh;
+    part.table.erase(table[item.position].host);
+    uncount(part, table[item.position].host);
+
+    if (item.position != table.size() - 1)
+    {
+        table[item.position] = table.back();
+        part.table[table[item.position].host] = item;
+    }
+
+    table.pop_back();
+    dirty_ = true;
+}
+
+// private
+bool hosts::insert(const address& host)
+{
+    return insert({ host, 0, 0 }, false);
+}
+
+// private
+bool hosts::insert(const entry& item, bool tried)
+{
+    auto& part = select(item.host);
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
+    unique_lock lock(part.mutex);
+
+    if (part.table.find(item.host) != part.table.end())
+        return false;
+
+    add(part, item, tried);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+bool hosts::erase(const address& host)
+{
+    auto& part = select(host);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(part.mutex);
 
-    return buffer_.size();
+    const auto it = part.table.find(host);
+
+    if (it == part.table.end())
+        return false;
+
+    drop(part, it->second);
+    return true;
     ///////////////////////////////////////////////////////////////////////////
 }
 
+// private
+void hosts::clear()
+{
+    for (const auto& part: buckets_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(part->mutex);
+
+        part->fresh.clear();
+        part->tried.clear();
+        part->table.clear();
+        part->groups.clear();
+        part->next_fresh = 0;
+        part->next_tried = 0;
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+size_t hosts::count() const
+{
+    size_t total = 0;
+
+    for (const auto& part: buckets_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(part->mutex);
+
+        total += part->fresh.size() + part->tried.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return total;
+}
+
+// private
+// An unknown latency is not compared, so unrated addresses are not starved.
+const hosts::entry& hosts::better(const entry& one, const entry& two)
+{
+    if (one.attempts != two.attempts)
+        return two.attempts < one.attempts ? two : one;
+
+    if (one.latency == 0 || two.latency == 0)
+        return one;
+
+    return two.latency < one.latency ? two : one;
+}
+
+// This does not take the pool mutex, so it never waits on start, stop or
+// writes to other buckets. Empty buckets are skipped in order.
+// Tried and new tables are equally likely, and of two random candidates the
+// one with fewer failed attempts (then lower latency) is selected.
 code hosts::fetch(address& out) const
 {
     if (disabled_)
         return error::not_found;
 
-    // Critical Section
-    ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
+    if (stopped_)
+        return error::service_stopped;
+
+    const auto count = buckets_.size();
+    const auto first = random_index(count);
+    const auto prefer_tried = random_index(2) == 0;
+
+    for (size_t offset = 0; offset < count; ++offset)
+    {
+        const auto& part = *buckets_[(first + offset) % count];
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(part.mutex);
+
+        const auto& preferred = prefer_tried ? part.tried : part.fresh;
+        const auto& other = prefer_tried ? part.fresh : part.tried;
+        const auto& table = preferred.empty() ? other : preferred;
+
+        if (table.empty())
+            continue;
+
+        const auto& one = table[random_index(table.size())];
+        const auto& two = table[random_index(table.size())];
+        out = better(one, two).host;
+        return error::success;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return error::not_found;
+}
+
+// private, call under bucket mutex.
+// The first eligible entry from a random position, null if there is none.
+const hosts::entry* hosts::eligible(const list& table,
+    const groups& excluded)
+{
+    const auto size = table.size();
+
+    if (size == 0)
+        return nullptr;
+
+    const auto start = random_index(size);
+
+    for (size_t offset = 0; offset < size; ++offset)
+    {
+        const auto& item = table[(start + offset) % size];
+
+        if (excluded.find(group(item.host)) == excluded.end())
+            return &item;
+    }
+
+    return nullptr;
+}
+
+// private, call under bucket mutex.
+// True if the bucket has an address outside of the excluded groups.
+bool hosts::eligible(const bucket& part, const groups& excluded)
+{
+    size_t ineligible = 0;
+
+    for (const auto key: excluded)
+    {
+        const auto it = part.groups.find(key);
+
+        if (it != part.groups.end())
+            ineligible += it->second;
+    }
+
+    return ineligible < part.fresh.size() + part.tried.size();
+}
+
+// As fetch, but buckets holding only excluded groups are skipped by count
+// and each candidate is the first eligible entry from a random position.
+code hosts::fetch(address& out, const groups& excluded) const
+{
+    if (excluded.empty())
+        return fetch(out);
+
+    if (disabled_)
+        return error::not_found;
 
     if (stopped_)
         return error::service_stopped;
 
-    if (buffer_.empty())
+    const auto count = buckets_.size();
+    const auto first = random_index(count);
+    const auto prefer_tried = random_index(2) == 0;
+
+    for (size_t offset = 0; offset < count; ++offset)
+    {
+        const auto& part = *buckets_[(first + offset) % count];
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(part.mutex);
+
+        if (!eligible(part, excluded))
+            continue;
+
+        const auto& preferred = prefer_tried ? part.tried : part.fresh;
+        const auto& other = prefer_tried ? part.fresh : part.tried;
+        auto one = eligible(preferred, excluded);
+        const auto& table = one == nullptr ? other : preferred;
+
+        if (one == nullptr)
+            one = eligible(table, excluded);
+
+        // The bucket is eligible, so both candidates exist.
+        const auto two = eligible(table, excluded);
+        out = better(*one, *two).host;
+        return error::success;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return error::not_found;
+}
+
+// Each bucket contributes its share, starting from a random position in each
+// table, so that the sample spans network groups without a shuffle.
+code hosts::fetch(address::list& out, size_t maximum) const
+{
+    out.clear();
+
+    if (disabled_)
         return error::not_found;
 
-    // Randomly select an address from the buffer.
-    const auto random = pseudo_random(0, buffer_.size() - 1);
-    const auto index = static_cast<size_t>(random);
-    out = buffer_[index];
-    return error::success;
+    if (stopped_)
+        return error::service_stopped;
+
+    const auto count = buckets_.size();
+    const auto share = std::max(maximum / count, size_t(1));
+    const auto first = random_index(count);
+    out.reserve(maximum);
+
+    for (size_t offset = 0; offset < count && out.size() < maximum; ++offset)
+    {
+        const auto& part = *buckets_[(first + offset) % count];
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(part.mutex);
+
+        for (const auto table: { &part.tried, &part.fresh })
+        {
+            const auto size = table->size();
+            const auto take = std::min({ size, share, maximum - out.size() });
+
+            if (take == 0)
+                continue;
+
+            const auto start = random_index(size);
+
+            for (size_t index = 0; index < take; ++index)
+                out.push_back((*table)[(start + index) % size].host);
+        }
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return out.empty() ? error::not_found : error::success;
+}
+
+// Persistence.
+// ----------------------------------------------------------------------------
+
+// private
+void hosts::load_text(const data_chunk& data)
+{
+    std::istringstream stream(std::string(data.begin(), data.end()));
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        config::authority host(line);
+
+        if (host.port() != 0)
+            insert(host.to_network_address());
+    }
+}
+
+// private
+// A truncated final record (such as from a crash during write) is ignored.
+void hosts::load_binary(const data_chunk& data)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    source.skip(sizeof(binary_file_magic));
+    address host;
+
+    while (!source.is_exhausted())
+    {
+        if (!host.from_data(binary_file_version, source, true))
+            break;
+
+        const auto tried = source.read_byte() != 0;
+        const size_t attempts = source.read_byte();
+
+        if (!source)
+            break;
+
+        if (host.port() != 0)
+            insert({ host, attempts, 0 }, tried);
+    }
+}
+
+// private
+void hosts::load_file()
+{
+    bc::ifstream file(file_path_.string(), std::ifstream::binary);
+
+    if (!file.good())
+        return;
+
+    const data_chunk data((std::istreambuf_iterator<char>(file)),
+        std::istreambuf_iterator<char>());
+
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    const auto magic = source.read_4_bytes_little_endian();
+
+    // Either format is accepted, which allows import of a text file.
+    if (source && magic == binary_file_magic)
+        load_binary(data);
+    else
+        load_text(data);
+}
+
+// private
+data_chunk hosts::to_text() const
+{
+    std::ostringstream stream;
+
+    const auto write = [&stream](const list& table)
+    {
+        for (const auto& item: table)
+            stream << config::authority(item.host) << std::endl;
+    };
+
+    for (const auto& part: buckets_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(part->mutex);
+
+        write(part->tried);
+        write(part->fresh);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    const auto text = stream.str();
+    return data_chunk(text.begin(), text.end());
+}
+
+// private
+data_chunk hosts::to_binary() const
+{
+    // Each record is the address followed by table and attempt bytes.
+    const auto record = address::satoshi_fixed_size(binary_file_version,
+        true) + 2;
+
+    auto data = to_chunk(to_little_endian(binary_file_magic));
+    data.reserve(data.size() + record * capacity_);
+
+    const auto write = [&data](const list& table, bool tried)
+    {
+        for (const auto& item: table)
+        {
+            const auto attempts = std::min(item.attempts, size_t(max_uint8));
+            extend_data(data, item.host.to_data(binary_file_version, true));
+            data.push_back(tried ? 1 : 0);
+            data.push_back(static_cast<uint8_t>(attempts));
+        }
+    };
+
+    for (const auto& part: buckets_)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        shared_lock lock(part->mutex);
+
+        write(part->tried, true);
+        write(part->fresh, false);
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return data;
+}
+
+// private
+// The file is replaced by rename so that a failed write does not lose it.
+code hosts::save_file() const
+{
+    const auto data = text_file_ ? to_text() : to_binary();
+    const auto temporary = file_path_.string() + ".tmp";
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(file_mutex_);
+
+    {
+        bc::ofstream file(temporary, std::ofstream::binary);
+
+        if (!file.good())
+            return error::file_system;
+
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+        if (!file.good())
+            return error::file_system;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, file_path_, ec);
+    return ec ? error::file_system : error::success;
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -105,38 +672,16 @@ code hosts::start()
     mutex_.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     stopped_ = false;
-    bc::ifstream file(file_path_.string());
-    const auto file_error = file.bad();
-
-    if (!file_error)
-    {
-        std::string line;
-
-        while (std::getline(file, line))
-        {
-            // TODO: create full space-delimited network_address serialization.
-            // Use to/from string format as opposed to wire serialization.
-            config::authority host(line);
-
-            if (host.port() != 0)
-                buffer_.push_back(host.to_network_address());
-        }
-    }
+    load_file();
+    dirty_ = false;
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
-    if (file_error)
-    {
-        LOG_DEBUG(LOG_NETWORK)
-            << "Failed to save hosts file.";
-        return error::file_system;
-    }
-
     return error::success;
 }
 
-// load
+// save
 code hosts::stop()
 {
     if (disabled_)
@@ -156,67 +701,67 @@ code hosts::stop()
     mutex_.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     stopped_ = true;
-    bc::ofstream file(file_path_.string());
-    const auto file_error = file.bad();
-
-    if (!file_error)
-    {
-        for (const auto& entry: buffer_)
-        {
-            // TODO: create full space-delimited network_address serialization.
-            // Use to/from string format as opposed to wire serialization.
-            file << config::authority(entry) << std::endl;
-        }
+    const auto ec = save_file();
 
-        buffer_.clear();
-    }
+    if (!ec)
+        clear();
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
-    if (file_error)
+    if (ec)
     {
         LOG_DEBUG(LOG_NETWORK)
-            << "Failed to load hosts file.";
-        return error::file_system;
+            << "Failed to save hosts file.";
+        return ec;
     }
 
     return error::success;
 }
 
-code hosts::remove(const address& host)
+// Writers are not blocked, so the file is a snapshot per bucket.
+code hosts::save()
 {
     if (disabled_)
-        return error::not_found;
+        return error::success;
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_upgrade();
+    shared_lock lock(mutex_);
 
     if (stopped_)
-    {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
         return error::service_stopped;
-    }
 
-    auto it = find(host);
+    if (!dirty_.exchange(false))
+        return error::success;
 
-    if (it != buffer_.end())
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        buffer_.erase(it);
+    const auto ec = save_file();
 
-        mutex_.unlock();
-        //---------------------------------------------------------------------
-        return error::success;
+    if (ec)
+    {
+        dirty_ = true;
+        LOG_DEBUG(LOG_NETWORK)
+            << "Failed to save hosts file.";
     }
 
-    mutex_.unlock_upgrade();
+    return ec;
     ///////////////////////////////////////////////////////////////////////////
+}
 
-    return error::not_found;
+code hosts::remove(const address& host)
+{
+    if (disabled_)
+        return error::not_found;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (stopped_)
+        return error::service_stopped;
+
+    return erase(host) ? error::success : error::not_found;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 code hosts::store(const address& host)
@@ -235,27 +780,12 @@ code hosts::store(const address& host)
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_upgrade();
+    shared_lock lock(mutex_);
 
     if (stopped_)
-    {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
         return error::service_stopped;
-    }
-
-    if (find(host) == buffer_.end())
-    {
-        mutex_.unlock_upgrade_and_lock();
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        buffer_.push_back(host);
-
-        mutex_.unlock();
-        //---------------------------------------------------------------------
-        return error::success;
-    }
 
-    mutex_.unlock_upgrade();
+    insert(host);
     ///////////////////////////////////////////////////////////////////////////
 
     ////// We don't treat redundant address as an error, just log it.
@@ -275,32 +805,29 @@ void hosts::store(const address::list& hosts, result_handler handler)
 
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    mutex_.lock_upgrade();
+    mutex_.lock_shared();
 
     if (stopped_)
     {
-        mutex_.unlock_upgrade();
+        mutex_.unlock_shared();
         //---------------------------------------------------------------------
         handler(error::service_stopped);
         return;
     }
 
     // Accept between 1 and all of this peer's addresses up to capacity.
-    const auto capacity = buffer_.capacity();
+    const auto capacity = capacity_;
     const auto usable = std::min(hosts.size(), capacity);
     const auto random = static_cast<size_t>(pseudo_random(1, usable));
 
     // But always accept at least the amount we are short if available.
-    const auto gap = capacity - buffer_.size();
+    const auto gap = capacity - std::min(count(), capacity);
     const auto accept = std::max(gap, random);
 
     // Convert minimum desired to step for iteration, no less than 1.
     const auto step = std::max(usable / accept, size_t(1));
     size_t accepted = 0;
 
-    mutex_.unlock_upgrade_and_lock();
-    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-
     for (size_t index = 0; index < usable; index = ceiling_add(index, step))
     {
         const auto& host = hosts[index];
@@ -314,14 +841,11 @@ void hosts::store(const address::list& hosts, result_handler handler)
         }
 
         // Do not allow duplicates in the host cache.
-        if (find(host) == buffer_.end())
-        {
+        if (insert(host))
             ++accepted;
-            buffer_.push_back(host);
-        }
     }
 
-    mutex_.unlock();
+    mutex_.unlock_shared();
     ///////////////////////////////////////////////////////////////////////////
 
     LOG_DEBUG(LOG_NETWORK)
@@ -331,5 +855,110 @@ void hosts::store(const address::list& hosts, result_handler handler)
     handler(error::success);
 }
 
+// Connection feedback.
+// ----------------------------------------------------------------------------
+
+// An unknown address is added directly to tried, as with manual peers.
+code hosts::promote(const address& host)
+{
+    if (disabled_)
+        return error::success;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (stopped_)
+        return error::service_stopped;
+
+    auto& part = select(host);
+    unique_lock part_lock(part.mutex);
+
+    entry item{ host, 0, 0 };
+    item.host.set_timestamp(now());
+    const auto it = part.table.find(host);
+
+    if (it != part.table.end())
+    {
+        const auto& table = it->second.tried ? part.tried : part.fresh;
+        const auto& found = table[it->second.position];
+        item.host.set_services(found.host.services());
+        item.latency = found.latency;
+        drop(part, it->second);
+    }
+
+    add(part, item, true);
+    return error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+code hosts::demote(const address& host)
+{
+    if (disabled_)
+        return error::not_found;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (stopped_)
+        return error::service_stopped;
+
+    auto& part = select(host);
+    unique_lock part_lock(part.mutex);
+
+    const auto it = part.table.find(host);
+
+    if (it == part.table.end())
+        return error::not_found;
+
+    const auto item = it->second;
+    auto& table = item.tried ? part.tried : part.fresh;
+    auto& found = table[item.position];
+    dirty_ = true;
+
+    if (++found.attempts < maximum_attempts)
+        return error::success;
+
+    // A failing tried address gets a fresh set of attempts in new.
+    const auto demoted = found.host;
+    drop(part, item);
+
+    if (item.tried)
+        add(part, { demoted, 0, 0 }, false);
+
+    return error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The latency is not persisted, so this does not dirty the pool.
+code hosts::rate(const address& host, uint32_t milliseconds)
+{
+    if (disabled_)
+        return error::not_found;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    if (stopped_)
+        return error::service_stopped;
+
+    auto& part = select(host);
+    unique_lock part_lock(part.mutex);
+
+    const auto it = part.table.find(host);
+
+    if (it == part.table.end())
+        return error::not_found;
+
+    auto& table = it->second.tried ? part.tried : part.fresh;
+
+    // Zero is reserved for unknown.
+    table[it->second.position].latency = std::max(milliseconds, uint32_t(1));
+    return error::success;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 } // namespace network
 } // namespace libbitcoin
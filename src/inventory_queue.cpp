@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/inventory_queue.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+inventory_queue::inventory_queue(size_t known_capacity)
+  : known_(known_capacity)
+{
+}
+
+size_t inventory_queue::enqueue(const list& items)
+{
+    size_t queued = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (const auto& item: items)
+    {
+        if (known_.contains(item.hash()))
+            continue;
+
+        known_.insert(item.hash());
+        pending_.push_back(item);
+        ++queued;
+    }
+
+    return queued;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void inventory_queue::known(const list& items)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    for (const auto& item: items)
+        known_.insert(item.hash());
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool inventory_queue::is_known(const hash_digest& hash) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return known_.contains(hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+inventory_queue::list inventory_queue::dequeue(size_t maximum)
+{
+    list items;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // The common case takes the whole queue without copying.
+    if (pending_.size() <= maximum)
+    {
+        items.swap(pending_);
+        return items;
+    }
+
+    const auto end = pending_.begin() + maximum;
+    items.reserve(maximum);
+    std::move(pending_.begin(), end, std::back_inserter(items));
+    pending_.erase(pending_.begin(), end);
+    return items;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t inventory_queue::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return pending_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
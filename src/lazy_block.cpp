@@ -0,0 +1,234 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/lazy_block.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// The segregated witness serialization flag, following the empty marker.
+static const uint8_t witness_flag = 0x01;
+
+// A transaction has at least one input (41 bytes) and one output (9 bytes),
+// with its version, counts and lock time.
+static const size_t minimum_transaction_size = 60;
+
+// Guard against allocation by count, as no block exceeds its weight in size.
+static const size_t maximum_transactions =
+    max_block_weight / minimum_transaction_size;
+
+const std::string lazy_block::command = message::block::command;
+const uint32_t lazy_block::version_minimum = message::block::version_minimum;
+const uint32_t lazy_block::version_maximum = message::block::version_maximum;
+
+lazy_block::lazy_block()
+  : count_(0),
+    valid_(false),
+    indexed_(false),
+    index_valid_(false)
+{
+}
+
+// The version is not used, as with message::block.
+bool lazy_block::from_data(uint32_t, reader& source)
+{
+    valid_ = header_.from_data(source);
+    count_ = source.read_size_little_endian();
+
+    if (count_ > maximum_transactions)
+        source.invalidate();
+
+    // The transactions cannot be smaller than their count would imply.
+    body_ = source ? source.read_bytes() : data_chunk{};
+    valid_ = valid_ && source &&
+        count_ <= body_.size() / minimum_transaction_size;
+    return valid_;
+}
+
+bool lazy_block::is_valid() const
+{
+    return valid_;
+}
+
+const chain::header& lazy_block::header() const
+{
+    return header_;
+}
+
+size_t lazy_block::transaction_count() const
+{
+    return count_;
+}
+
+const data_chunk& lazy_block::transactions_data() const
+{
+    return body_;
+}
+
+// private
+// Advance past one transaction (with or without witness), without allocation.
+// Returns the number of bytes consumed, meaningful only if source is valid.
+size_t lazy_block::skip_transaction(reader& source)
+{
+    size_t size = 0;
+
+    // Read a variable length integer, accumulating its size.
+    const auto read_size = [&]()
+    {
+        const auto value = source.read_size_little_endian();
+        size += variable_uint_size(value);
+        return value;
+    };
+
+    // Skip a number of bytes, accumulating the size.
+    const auto skip = [&](size_t bytes)
+    {
+        source.skip(bytes);
+        size += bytes;
+    };
+
+    skip(sizeof(uint32_t));
+    auto inputs = read_size();
+    const auto witness = (inputs == 0);
+
+    if (witness)
+    {
+        if (source.read_byte() != witness_flag)
+        {
+            source.invalidate();
+            return size;
+        }
+
+        ++size;
+        inputs = read_size();
+    }
+
+    for (size_t input = 0; input < inputs && source; ++input)
+    {
+        skip(hash_size + sizeof(uint32_t));
+        skip(read_size());
+        skip(sizeof(uint32_t));
+    }
+
+    const auto outputs = read_size();
+
+    for (size_t output = 0; output < outputs && source; ++output)
+    {
+        skip(sizeof(uint64_t));
+        skip(read_size());
+    }
+
+    if (witness)
+    {
+        for (size_t input = 0; input < inputs && source; ++input)
+        {
+            const auto items = read_size();
+
+            for (size_t item = 0; item < items && source; ++item)
+                skip(read_size());
+        }
+    }
+
+    skip(sizeof(uint32_t));
+    return size;
+}
+
+bool lazy_block::index() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (indexed_ || !valid_)
+    {
+        const auto result = valid_ && index_valid_;
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return result;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+    auto source = make_safe_deserializer(body_.begin(), body_.end());
+    offsets_.reserve(count_);
+
+    size_t offset = 0;
+
+    for (size_t position = 0; position < count_ && source; ++position)
+    {
+        offsets_.push_back(offset);
+        offset += skip_transaction(source);
+    }
+
+    indexed_ = true;
+    index_valid_ = source && source.is_exhausted();
+
+    if (!index_valid_)
+        offsets_.clear();
+
+    const auto result = index_valid_;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return result;
+}
+
+bool lazy_block::transaction(size_t position, chain::transaction& out) const
+{
+    if (position >= count_ || !index())
+        return false;
+
+    // Offsets are immutable once indexed.
+    const auto begin = body_.begin() + offsets_[position];
+    const auto end = position + 1 < count_ ?
+        body_.begin() + offsets_[position + 1] : body_.end();
+
+    auto source = make_safe_deserializer(begin, end);
+    return out.from_data(source, true, true) && source.is_exhausted();
+}
+
+message::block::ptr lazy_block::block() const
+{
+    if (!valid_)
+        return nullptr;
+
+    chain::transaction::list transactions(count_);
+    auto source = make_safe_deserializer(body_.begin(), body_.end());
+
+    for (auto& tx: transactions)
+        if (!tx.from_data(source, true, true))
+            return nullptr;
+
+    if (!source.is_exhausted())
+        return nullptr;
+
+    return std::make_shared<message::block>(chain::header(header_),
+        std::move(transactions));
+}
+
+} // namespace network
+} // namespace libbitcoin
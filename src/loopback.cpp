@@ -0,0 +1,165 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/loopback.hpp>
+
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/pipe_transport.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "loopback"
+
+// Connecting ends are numbered from the start of the dynamic port range, so
+// that each connection has a distinct authority on the accepting node.
+static const uint16_t first_dynamic_port = 49152;
+static const auto loopback_host = "127.0.0.1";
+
+loopback::loopback(threadpool& pool)
+  : pool_(pool),
+    dispatch_(pool, NAME),
+    next_port_(first_dynamic_port)
+{
+}
+
+code loopback::listen(uint16_t port)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    return listeners_.emplace(port, listener{}).second ? error::success :
+        error::address_in_use;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void loopback::unlisten(uint16_t port)
+{
+    listener removed;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = listeners_.find(port);
+
+    if (it != listeners_.end())
+    {
+        removed = std::move(it->second);
+        listeners_.erase(it);
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Connections that were never accepted are closed.
+    for (const auto connection: removed.connections)
+        connection->stop();
+
+    if (removed.handler)
+        dispatch_.concurrent(removed.handler, error::service_stopped,
+            nullptr);
+}
+
+void loopback::accept(uint16_t port, transport_handler handler)
+{
+    transport::ptr connection;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = listeners_.find(port);
+
+    if (it == listeners_.end() || it->second.handler)
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        dispatch_.concurrent(handler, error::service_stopped, nullptr);
+        return;
+    }
+
+    auto& connections = it->second.connections;
+
+    if (connections.empty())
+    {
+        it->second.handler = handler;
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    connection = connections.front();
+    connections.pop_front();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    dispatch_.concurrent(handler, error::success, connection);
+}
+
+void loopback::connect(uint16_t port, transport_handler handler)
+{
+    transport_handler accepted;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = listeners_.find(port);
+
+    if (it == listeners_.end())
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        dispatch_.concurrent(handler, error::network_unreachable, nullptr);
+        return;
+    }
+
+    const auto local = next_port_;
+    next_port_ = local == max_uint16 ? first_dynamic_port : local + 1;
+
+    // Each end reports the authority of the other.
+    const auto ends = pipe_transport::create(pool_,
+        config::authority(loopback_host, port),
+        config::authority(loopback_host, local));
+
+    if (it->second.handler)
+    {
+        accepted = std::move(it->second.handler);
+        it->second.handler = nullptr;
+    }
+    else
+    {
+        it->second.connections.push_back(ends.second);
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (accepted)
+        dispatch_.concurrent(accepted, error::success,
+            transport::ptr(ends.second));
+
+    dispatch_.concurrent(handler, error::success, transport::ptr(ends.first));
+}
+
+} // namespace network
+} // namespace libbitcoin
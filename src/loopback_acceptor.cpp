@@ -0,0 +1,121 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/loopback_acceptor.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace std::placeholders;
+
+loopback_acceptor::loopback_acceptor(loopback& network, threadpool& pool,
+    channel_pools& pools, buffer_pool& buffers, timer_wheel& timers,
+    admission& admission, const settings& settings)
+  : acceptor(pool, pools, buffers, timers, admission, settings),
+    network_(network),
+    listening_(false),
+    port_(0)
+{
+}
+
+loopback_acceptor::~loopback_acceptor()
+{
+    BITCOIN_ASSERT_MSG(stopped(), "The acceptor was not stopped.");
+}
+
+code loopback_acceptor::listen(uint16_t port)
+{
+    if (listening_)
+        return error::operation_failed;
+
+    const auto ec = network_.listen(port);
+
+    if (ec)
+        return ec;
+
+    port_ = port;
+    listening_ = true;
+    return error::success;
+}
+
+void loopback_acceptor::accept(accept_handler handler)
+{
+    if (stopped())
+    {
+        dispatch_.concurrent(handler, error::service_stopped, nullptr);
+        return;
+    }
+
+    network_.accept(port_,
+        std::bind(&loopback_acceptor::handle_accept,
+            shared_from_base<loopback_acceptor>(), _1, _2, handler));
+}
+
+// This will asynchronously invoke the handler of the pending accept.
+void loopback_acceptor::stop(const code&)
+{
+    if (listening_.exchange(false))
+        network_.unlisten(port_);
+}
+
+// protected
+bool loopback_acceptor::stopped() const
+{
+    return !listening_;
+}
+
+// private:
+void loopback_acceptor::handle_accept(const code& ec,
+    transport::ptr transport, accept_handler handler)
+{
+    if (ec)
+    {
+        handler(ec, nullptr);
+        return;
+    }
+
+    // Rejected connections are closed before a channel is created for them.
+    const auto admitted = admission_.admit(transport->authority());
+
+    if (admitted)
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Rejected inbound connection from [" << transport->authority()
+            << "] " << admitted.message();
+        transport->stop();
+        accept(handler);
+        return;
+    }
+
+    // Ensure that channel is not passed as an r-value.
+    const auto created = std::allocate_shared<channel>(
+        pool_allocator<channel>(), pools_.select(), buffers_, timers_,
+        transport, settings_);
+    handler(error::success, created);
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,82 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/loopback_connector.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace std::placeholders;
+
+loopback_connector::loopback_connector(loopback& network, threadpool& pool,
+    channel_pools& pools, buffer_pool& buffers, timer_wheel& timers,
+    resolver_cache& resolver, const settings& settings)
+  : connector(pool, pools, buffers, timers, resolver, settings),
+    network_(network)
+{
+}
+
+void loopback_connector::connect(const std::string&, uint16_t port,
+    connect_handler handler)
+{
+    if (stopped())
+    {
+        dispatch_.concurrent(handler, error::service_stopped, nullptr);
+        return;
+    }
+
+    network_.connect(port,
+        std::bind(&loopback_connector::handle_connect,
+            shared_from_base<loopback_connector>(), _1, _2, handler));
+}
+
+// private:
+void loopback_connector::handle_connect(const code& ec,
+    transport::ptr transport, connect_handler handler)
+{
+    if (ec)
+    {
+        handler(ec, nullptr);
+        return;
+    }
+
+    if (stopped())
+    {
+        transport->stop();
+        handler(error::service_stopped, nullptr);
+        return;
+    }
+
+    // Ensure that channel is not passed as an r-value.
+    const auto created = std::allocate_shared<channel>(
+        pool_allocator<channel>(), pools_.select(), buffers_, timers_,
+        transport, settings_);
+    handler(error::success, created);
+}
+
+} // namespace network
+} // namespace libbitcoin
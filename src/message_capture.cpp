@@ -0,0 +1,170 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/message_capture.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::message;
+
+static const uint32_t capture_file_magic = 0x70616362;
+
+// Wall clock time, so that captures correlate with logs of other hosts.
+static uint64_t now()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(
+        system_clock::now().time_since_epoch()).count();
+}
+
+message_capture::message_capture(size_t capacity, uint32_t magic)
+  : capacity_(capacity),
+    magic_(magic),
+    bytes_(0)
+{
+}
+
+void message_capture::received(const std::string& command,
+    const data_slice& payload)
+{
+    push(
+    {
+        now(),
+        direction::received,
+        std::make_shared<const std::string>(command),
+        std::make_shared<const data_chunk>(payload.begin(), payload.end())
+    });
+}
+
+void message_capture::sent(command_ptr command, payload_ptr payload)
+{
+    push({ now(), direction::sent, command, payload });
+}
+
+// private
+void message_capture::push(entry&& item)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    bytes_ += item.payload->size();
+    entries_.push_back(std::move(item));
+
+    // The newest message is retained even if it alone exceeds capacity.
+    while (bytes_ > capacity_ && entries_.size() > 1)
+    {
+        bytes_ -= entries_.front().payload->size();
+        entries_.pop_front();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t message_capture::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The entries are copied out so that serialization does not hold the lock.
+code message_capture::save(const boost::filesystem::path& file) const
+{
+    mutex_.lock_shared();
+    const std::deque<entry> entries(entries_);
+    const auto bytes = bytes_;
+    mutex_.unlock_shared();
+
+    const auto record_size = sizeof(uint64_t) + 1 + heading::maximum_size();
+    auto data = to_chunk(to_little_endian(capture_file_magic));
+    data.reserve(data.size() + entries.size() * record_size + bytes);
+
+    for (const auto& item: entries)
+    {
+        const auto& payload = *item.payload;
+        const heading head(magic_, *item.command,
+            static_cast<uint32_t>(payload.size()), bitcoin_checksum(payload));
+
+        extend_data(data, to_little_endian(item.timestamp));
+        data.push_back(static_cast<uint8_t>(item.direction));
+        extend_data(data, head.to_data());
+        extend_data(data, payload);
+    }
+
+    bc::ofstream stream(file.string(), std::ofstream::binary);
+
+    if (!stream.good())
+        return error::file_system;
+
+    stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+    return stream.good() ? error::success : error::file_system;
+}
+
+bool message_capture::load(const boost::filesystem::path& file,
+    record::list& out)
+{
+    out.clear();
+    bc::ifstream stream(file.string(), std::ifstream::binary);
+
+    if (!stream.good())
+        return false;
+
+    const data_chunk data((std::istreambuf_iterator<char>(stream)),
+        std::istreambuf_iterator<char>());
+
+    auto source = make_safe_deserializer(data.begin(), data.end());
+
+    if (source.read_4_bytes_little_endian() != capture_file_magic || !source)
+        return false;
+
+    while (!source.is_exhausted())
+    {
+        record item;
+        item.timestamp = source.read_8_bytes_little_endian();
+        item.direction = static_cast<direction>(source.read_byte());
+
+        if (!item.heading.from_data(source))
+            return false;
+
+        item.payload = source.read_bytes(item.heading.payload_size());
+
+        if (!source)
+            return false;
+
+        out.push_back(std::move(item));
+    }
+
+    return true;
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -19,6 +19,7 @@
 #include <bitcoin/network/p2p.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -50,6 +51,13 @@ namespace network {
 using namespace bc::config;
 using namespace std::placeholders;
 
+// Channel and protocol timeouts are coarse, typically seconds to hours.
+static const asio::duration timer_resolution = asio::seconds(1);
+static const size_t timer_slots = 512;
+
+// The period at which a drain stops channels with empty send queues.
+static const asio::duration drain_interval = asio::milliseconds(100);
+
 // This can be exceeded due to manual connection calls and race conditions.
 inline size_t nominal_connecting(const settings& settings)
 {
@@ -67,9 +75,31 @@ inline size_t nominal_connected(const settings& settings)
 p2p::p2p(const settings& settings)
   : settings_(settings),
     stopped_(true),
+    draining_(false),
     top_block_({ null_hash, 0 }),
+    runtime_(std::make_shared<const runtime_settings>(settings_)),
+    channel_pools_(threadpool_, settings_.thread_affinity ?
+        thread_default(settings_.threads) : 0),
+    buffers_(nominal_connected(settings_)),
+    work_scheduler_(settings_.work_stealing_threads),
+    timers_(threadpool_, timer_resolution, timer_slots),
+    resolver_(threadpool_, settings_),
     hosts_(settings_),
+    address_cache_(hosts_, settings_),
+    anchors_(settings_),
+    blacklist_(settings_),
+    admission_(blacklist_, settings_),
+    upload_limiter_(settings_.upload_rate_limit),
+    download_limiter_(settings_.download_rate_limit),
+    tip_announcement_(settings_.identifier),
+    hosts_flush_(std::make_shared<deadline>(threadpool_,
+        settings_.host_pool_flush())),
+    statistics_timer_(std::make_shared<deadline>(threadpool_,
+        settings_.statistics_interval())),
+    drain_timer_(std::make_shared<deadline>(threadpool_, drain_interval)),
     pending_connect_(nominal_connecting(settings_)),
+    dispatch_(threadpool_, NAME "_dispatch"),
+    statistics_(threadpool_, settings_),
     pending_handshake_(nominal_connected(settings_)),
     pending_close_(nominal_connected(settings_)),
     stop_subscriber_(std::make_shared<stop_subscriber>(threadpool_,
@@ -96,23 +126,113 @@ void p2p::start(result_handler handler)
         return;
     }
 
+    // Configured versions are validated once, not upon each handshake.
+    if (!valid_versions())
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
     threadpool_.join();
     threadpool_.spawn(thread_default(settings_.threads),
         thread_priority::normal);
+    channel_pools_.join();
+    channel_pools_.spawn();
+    work_scheduler_.join();
+    work_scheduler_.spawn();
 
     stopped_ = false;
+    draining_ = false;
     stop_subscriber_->start();
     channel_subscriber_->start();
+    timers_.start();
+    preallocate_connectors();
 
     // This instance is retained by stop handler and member reference.
     manual_.store(attach_manual_session());
 
+    if (settings_.fast_start)
+    {
+        // The hosts file is loaded concurrently with the manual session.
+        const auto join_handler = synchronize(
+            std::bind(&p2p::handle_fast_started,
+                this, _1, handler), 2, NAME "_start",
+            synchronizer_terminate::on_error);
+
+        dispatch_.concurrent(
+            std::bind(&p2p::load_hosts,
+                this, join_handler));
+
+        manual_.load()->start(join_handler);
+        return;
+    }
+
     // This is invoked on a new thread.
     manual_.load()->start(
         std::bind(&p2p::handle_manual_started,
             this, _1, handler));
 }
 
+void p2p::load_hosts(result_handler handler)
+{
+    handler(hosts_.start());
+}
+
+// Start completes once hosts are loaded, without waiting on seeding, which
+// runs concurrently with the run sequence if the pool is below the minimum.
+void p2p::handle_fast_started(const code& ec, result_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped);
+        return;
+    }
+
+    if (ec)
+    {
+        LOG_ERROR(LOG_NETWORK)
+            << "Error starting network: " << ec.message();
+        handler(ec);
+        return;
+    }
+
+    start_hosts_flush();
+    start_statistics();
+
+    const auto count = hosts_.count();
+
+    if (count < settings_.fast_start_minimum_hosts)
+    {
+        LOG_INFO(LOG_NETWORK)
+            << "Seeding concurrently, there are only " << count
+            << " cached addresses.";
+
+        // The instance is retained by the stop handler (until shutdown).
+        attach_seed_session()->start(
+            std::bind(&p2p::handle_seeded,
+                this, _1));
+    }
+
+    // This is the end of the start sequence.
+    handler(error::success);
+}
+
+void p2p::handle_seeded(const code& ec)
+{
+    if (stopped())
+        return;
+
+    if (ec)
+    {
+        LOG_WARNING(LOG_NETWORK)
+            << "Error seeding host addresses: " << ec.message();
+        return;
+    }
+
+    LOG_INFO(LOG_NETWORK)
+        << "Seeding complete with " << hosts_.count() << " addresses.";
+}
+
 void p2p::handle_manual_started(const code& ec, result_handler handler)
 {
     if (stopped())
@@ -148,6 +268,9 @@ void p2p::handle_hosts_loaded(const code& ec, result_handler handler)
         return;
     }
 
+    start_hosts_flush();
+    start_statistics();
+
     // The instance is retained by the stop handler (until shutdown).
     const auto seed = attach_seed_session();
 
@@ -157,6 +280,68 @@ void p2p::handle_hosts_loaded(const code& ec, result_handler handler)
             this, _1, handler));
 }
 
+// Periodically save changes to the hosts file so a crash does not lose them.
+void p2p::start_hosts_flush()
+{
+    if (stopped() || settings_.host_pool_flush_seconds == 0)
+        return;
+
+    hosts_flush_->start(
+        std::bind(&p2p::handle_hosts_flush,
+            this, _1));
+}
+
+void p2p::handle_hosts_flush(const code& ec)
+{
+    if (stopped())
+        return;
+
+    if (ec)
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Failure in hosts flush timer: " << ec.message();
+        return;
+    }
+
+    const auto result = hosts_.save();
+
+    if (result && result != error::service_stopped)
+    {
+        LOG_ERROR(LOG_NETWORK)
+            << "Error saving host addresses: " << result.message();
+    }
+
+    start_hosts_flush();
+}
+
+// Periodically write metrics to the statistics server, if configured.
+void p2p::start_statistics()
+{
+    if (stopped() || !statistics_.enabled() ||
+        settings_.statistics_interval_seconds == 0)
+        return;
+
+    statistics_timer_->start(
+        std::bind(&p2p::handle_statistics,
+            this, _1));
+}
+
+void p2p::handle_statistics(const code& ec)
+{
+    if (stopped())
+        return;
+
+    if (ec)
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Failure in statistics timer: " << ec.message();
+        return;
+    }
+
+    statistics_.emit(metrics(), connection_count());
+    start_statistics();
+}
+
 void p2p::handle_started(const code& ec, result_handler handler)
 {
     if (stopped())
@@ -193,6 +378,25 @@ void p2p::run(result_handler handler)
 
     // The instance is retained by the stop handler (until shutdown).
     const auto inbound = attach_inbound_session();
+    inbound_.store(inbound);
+
+    if (settings_.fast_start)
+    {
+        // Outbound does not wait on inbound listeners.
+        const auto join_handler = synchronize(handler, 2, NAME "_run",
+            synchronizer_terminate::on_error);
+
+        inbound->start(
+            std::bind(&p2p::handle_inbound_running,
+                this, _1, join_handler));
+
+        // The instance is retained by the stop handler (until shutdown).
+        outbound_.store(attach_outbound_session());
+        outbound_.load()->start(
+            std::bind(&p2p::handle_running,
+                this, _1, join_handler));
+        return;
+    }
 
     // This is invoked on a new thread.
     inbound->start(
@@ -200,6 +404,15 @@ void p2p::run(result_handler handler)
             this, _1, handler));
 }
 
+void p2p::handle_inbound_running(const code& ec, result_handler handler)
+{
+    if (ec)
+        LOG_ERROR(LOG_NETWORK)
+            << "Error starting inbound session: " << ec.message();
+
+    handler(ec);
+}
+
 void p2p::handle_inbound_started(const code& ec, result_handler handler)
 {
     if (ec)
@@ -212,6 +425,7 @@ void p2p::handle_inbound_started(const code& ec, result_handler handler)
 
     // The instance is retained by the stop handler (until shutdown).
     const auto outbound = attach_outbound_session();
+    outbound_.store(outbound);
 
     // This is invoked on a new thread.
     outbound->start(
@@ -268,12 +482,24 @@ session_outbound::ptr p2p::attach_outbound_session()
 // is thread safe and idempotent, allowing it to be unguarded.
 bool p2p::stop()
 {
+    // Cancel periodic saves, the hosts file is saved below.
+    hosts_flush_->stop();
+    statistics_timer_->stop();
+    drain_timer_->stop();
+
     // This is the only stop operation that can fail.
     const auto result = (hosts_.stop() == error::success);
 
-    // Signal all current work to stop and free manual session.
+    // Save outbound peers before their channels are stopped below.
+    // A drain saves them before its channels begin to stop.
+    if (!draining_)
+        save_anchors();
+
+    // Signal all current work to stop and free manual and outbound sessions.
     stopped_ = true;
     manual_.store({});
+    inbound_.store({});
+    outbound_.store({});
 
     // Prevent subscription after stop.
     stop_subscriber_->stop();
@@ -285,11 +511,17 @@ bool p2p::stop()
 
     // Stop creating new channels and stop those that exist (self-clearing).
     pending_connect_.stop(error::service_stopped);
+    stop_idle_connectors();
     pending_handshake_.stop(error::service_stopped);
     pending_close_.stop(error::service_stopped);
 
+    // Release channels and protocols retained by scheduled timeouts.
+    timers_.stop();
+
     // Signal threadpool to stop accepting work now that subscribers are clear.
     threadpool_.shutdown();
+    channel_pools_.shutdown();
+    work_scheduler_.shutdown();
     return result;
 }
 
@@ -301,9 +533,79 @@ bool p2p::close()
 
     // Block on join of all threads in the threadpool.
     threadpool_.join();
+    channel_pools_.join();
+    work_scheduler_.join();
     return result;
 }
 
+// Sessions observe the drain as a stop, so no connections are created.
+// Channels are stopped individually so that peers do not reconnect at once
+// and queued sends (such as blocks in flight) are written before close.
+void p2p::drain(const asio::duration& timeout, result_handler handler)
+{
+    if (stopped() || draining_.exchange(true))
+    {
+        handler(error::operation_failed);
+        return;
+    }
+
+    LOG_INFO(LOG_NETWORK)
+        << "Draining (" << connection_count() << ") connections.";
+
+    const auto inbound = inbound_.load();
+
+    if (inbound)
+        inbound->drain();
+
+    // Outbound peers are saved while their channels remain connected.
+    save_anchors();
+
+    drain_deadline_ = asio::steady_clock::now() + timeout;
+    handle_drain(error::success, handler);
+}
+
+bool p2p::draining() const
+{
+    return draining_;
+}
+
+void p2p::handle_drain(const code& ec, result_handler handler)
+{
+    if (stopped())
+    {
+        handler(error::service_stopped);
+        return;
+    }
+
+    if (ec)
+        LOG_DEBUG(LOG_NETWORK)
+            << "Failure in drain timer: " << ec.message();
+
+    size_t remaining = 0;
+
+    for (const auto channel: *pending_close_.snapshot())
+    {
+        if (channel->send_queue_messages() == 0)
+            channel->stop(error::service_stopped);
+        else
+            ++remaining;
+    }
+
+    if (remaining != 0 && !ec && asio::steady_clock::now() < drain_deadline_)
+    {
+        drain_timer_->start(
+            std::bind(&p2p::handle_drain,
+                this, _1, handler));
+        return;
+    }
+
+    if (remaining != 0)
+        LOG_INFO(LOG_NETWORK)
+            << "Drain stopping (" << remaining << ") unflushed connections.";
+
+    handler(stop() ? error::success : error::file_system);
+}
+
 // Properties.
 // ----------------------------------------------------------------------------
 
@@ -312,6 +614,42 @@ const settings& p2p::network_settings() const
     return settings_;
 }
 
+runtime_settings::ptr p2p::current_settings() const
+{
+    return runtime_.load();
+}
+
+// The snapshot is published before it is applied, so that sessions read the
+// new values as they act on the change. Blacklist changes do not stop
+// existing connections, they apply to subsequent admission.
+code p2p::reload(const settings& settings)
+{
+    if (stopped())
+        return error::service_stopped;
+
+    const auto next = std::make_shared<const runtime_settings>(settings);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(reload_mutex_);
+
+    const auto prior = runtime_.load();
+    runtime_.store(next);
+    blacklist_.reconfigure(*prior, *next);
+
+    const auto outbound = outbound_.load();
+
+    if (outbound)
+        outbound->reload();
+    ///////////////////////////////////////////////////////////////////////////
+
+    LOG_INFO(LOG_NETWORK)
+        << "Reloaded network settings (" << next->inbound_connections
+        << " inbound, " << next->outbound_connections << " outbound).";
+
+    return error::success;
+}
+
 checkpoint p2p::top_block() const
 {
     return top_block_.load();
@@ -337,6 +675,46 @@ threadpool& p2p::thread_pool()
     return threadpool_;
 }
 
+channel_pools& p2p::channel_threads()
+{
+    return channel_pools_;
+}
+
+admission& p2p::inbound_admission()
+{
+    return admission_;
+}
+
+rate_limiter& p2p::upload_limit()
+{
+    return upload_limiter_;
+}
+
+rate_limiter& p2p::download_limit()
+{
+    return download_limiter_;
+}
+
+buffer_pool& p2p::receive_buffers()
+{
+    return buffers_;
+}
+
+work_scheduler& p2p::work_threads()
+{
+    return work_scheduler_;
+}
+
+timer_wheel& p2p::timers()
+{
+    return timers_;
+}
+
+resolver_cache& p2p::resolver()
+{
+    return resolver_;
+}
+
 // Send.
 // ----------------------------------------------------------------------------
 
@@ -348,6 +726,162 @@ void p2p::handle_send(const code& ec, channel::ptr channel,
     handle_complete(ec);
 }
 
+// Inventory relay.
+// ----------------------------------------------------------------------------
+// Announcements are queued to each channel and trickled by its relay
+// protocol, so that many items are sent in one inv message.
+
+void p2p::relay(const message::inventory_vector::list& items)
+{
+    // Iterate over a snapshot, which does not take the registry lock.
+    const auto snapshot = pending_close_.snapshot();
+    auto blocks = items;
+    blocks.erase(std::remove_if(blocks.begin(), blocks.end(),
+        [](const message::inventory_vector& item)
+        {
+            return item.is_transaction_type();
+        }), blocks.end());
+
+    for (const auto channel: *snapshot)
+        channel->announcements().enqueue(channel->filter() ? blocks : items);
+}
+
+void p2p::relay(const message::inventory_vector& item)
+{
+    relay(message::inventory_vector::list{ item });
+}
+
+void p2p::relay(const message::inventory_vector& item, uint64_t fee_rate)
+{
+    const message::inventory_vector::list items{ item };
+    const auto accepted = fee_accepted(fee_rate);
+
+    // Iterate over a snapshot, which does not take the registry lock.
+    // A filtered peer is relayed the transaction only by its filter.
+    const auto snapshot = pending_close_.snapshot();
+
+    for (const auto channel: *snapshot)
+        if (accepted(channel) && !channel->filter())
+            channel->announcements().enqueue(items);
+}
+
+channel_registry::list p2p::sample(channel_predicate predicate,
+    size_t maximum) const
+{
+    // Iterate over a snapshot, which does not take the registry lock.
+    const auto snapshot = pending_close_.snapshot();
+    channel_registry::list channels;
+    channels.reserve(snapshot->size());
+
+    for (const auto channel: *snapshot)
+        if (predicate(channel))
+            channels.push_back(channel);
+
+    if (channels.size() <= maximum)
+        return channels;
+
+    // A partial Fisher-Yates shuffle selects a uniform subset.
+    for (size_t index = 0; index < maximum; ++index)
+    {
+        const auto other = static_cast<size_t>(
+            pseudo_random(index, channels.size() - 1));
+        std::swap(channels[index], channels[other]);
+    }
+
+    channels.resize(maximum);
+    return channels;
+}
+
+void p2p::relay(const chain::transaction& tx, uint64_t fee_rate)
+{
+    const message::inventory_vector::list items
+    {
+        { message::inventory_vector::type_id::transaction, tx.hash() }
+    };
+
+    const auto accepted = fee_accepted(fee_rate);
+
+    // Iterate over a snapshot, which does not take the registry lock.
+    const auto snapshot = pending_close_.snapshot();
+
+    for (const auto channel: *snapshot)
+    {
+        if (!accepted(channel))
+            continue;
+
+        const auto filter = channel->filter();
+
+        if (!filter || filter->matches(tx))
+            channel->announcements().enqueue(items);
+    }
+}
+
+p2p::channel_predicate p2p::fee_accepted(uint64_t fee_rate)
+{
+    return [fee_rate](channel::ptr channel)
+    {
+        return channel->fee_filter() <= fee_rate;
+    };
+}
+
+void p2p::announce(headers_const_ptr headers)
+{
+    static const auto headers_command = std::make_shared<const std::string>(
+        message::headers::command);
+    static const auto inventory_command = std::make_shared<const std::string>(
+        message::inventory::command);
+
+    if (!tip_announcement_.set(headers))
+        return;
+
+    const auto tip = tip_announcement_.tip();
+    const message::inventory_vector::list known
+    {
+        { message::inventory_vector::type_id::block, tip }
+    };
+
+    // Iterate over a snapshot, which does not take the registry lock.
+    const auto snapshot = pending_close_.snapshot();
+
+    for (const auto channel: *snapshot)
+    {
+        auto& announcements = channel->announcements();
+
+        if (announcements.is_known(tip))
+            continue;
+
+        announcements.known(known);
+        const auto version = channel->negotiated_version();
+        const auto handler = std::bind(&p2p::handle_relay, this, _1,
+            channel);
+
+        if (channel->headers_preferred())
+            channel->send(headers_command, tip_announcement_.headers(version),
+                handler);
+        else
+            channel->send(inventory_command,
+                tip_announcement_.inventory(version), handler);
+    }
+}
+
+void p2p::handle_relay(const code& ec, channel::ptr channel)
+{
+    if (ec && ec != error::channel_stopped)
+        LOG_DEBUG(LOG_NETWORK)
+            << "Failure relaying to [" << channel->authority() << "] "
+            << ec.message();
+}
+
+void p2p::set_compact_pool(compact_block_pool::ptr pool)
+{
+    compact_pool_.store(pool);
+}
+
+compact_block_pool::ptr p2p::compact_pool() const
+{
+    return compact_pool_.load();
+}
+
 // Subscriptions.
 // ----------------------------------------------------------------------------
 
@@ -420,14 +954,155 @@ code p2p::fetch_address(address& out_address) const
     return hosts_.fetch(out_address);
 }
 
+code p2p::fetch_address(address& out_address,
+    const hosts::groups& excluded) const
+{
+    return hosts_.fetch(out_address, excluded);
+}
+
 code p2p::remove(const address& address)
 {
     return hosts_.remove(address);
 }
 
+code p2p::promote(const address& address)
+{
+    return hosts_.promote(address);
+}
+
+code p2p::demote(const address& address)
+{
+    return hosts_.demote(address);
+}
+
+config::authority::list p2p::load_anchors()
+{
+    return anchors_.load();
+}
+
+// Anchors are ordered by round trip, so the fastest are reconnected first.
+void p2p::save_anchors()
+{
+    config::authority::list peers;
+
+    for (const auto channel: ranked_channels())
+        if (channel->outbound())
+            peers.push_back(channel->authority());
+
+    const auto ec = anchors_.save(peers);
+
+    if (ec)
+        LOG_ERROR(LOG_NETWORK)
+            << "Error saving anchors: " << ec.message();
+}
+
+address_const_ptr p2p::cached_addresses()
+{
+    return address_cache_.get();
+}
+
+// Forwarding to few peers propagates fresh addresses without flooding.
+void p2p::forward(const address::list& addresses,
+    const config::authority& source)
+{
+    static const size_t forward_peers = 2;
+
+    if (addresses.empty())
+        return;
+
+    // Peers that know all of the addresses (sent or received) are skipped.
+    const auto others = [source, &addresses](channel::ptr channel)
+    {
+        return channel->authority() != source &&
+            channel->unknown_addresses(addresses);
+    };
+
+    // Only the addresses that the sampled peer does not know are sent.
+    const auto unknown = [&addresses](channel::ptr channel)
+        -> address_const_ptr
+    {
+        auto list = channel->mark_addresses(addresses);
+
+        if (list.empty())
+            return nullptr;
+
+        return std::make_shared<const message::address>(std::move(list));
+    };
+
+    const auto handle_channel = std::bind(&p2p::handle_relay, this, _1, _2);
+    const auto handle_complete = [](const code&) {};
+    broadcast_each<message::address>(unknown, others, forward_peers,
+        handle_channel, handle_complete);
+}
+
+// Bans.
+// ----------------------------------------------------------------------------
+
+void p2p::ban(const config::authority& authority)
+{
+    blacklist_.insert(authority.ip(), blacklist::address_prefix);
+}
+
+code p2p::ban(const std::string& subnet)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+
+    if (!blacklist::parse(subnet, ip, prefix))
+        return error::operation_failed;
+
+    blacklist_.insert(ip, prefix);
+    return error::success;
+}
+
+code p2p::unban(const std::string& subnet)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+
+    if (!blacklist::parse(subnet, ip, prefix))
+        return error::operation_failed;
+
+    return blacklist_.erase(ip, prefix) ? error::success : error::not_found;
+}
+
 // Pending connect collection.
 // ----------------------------------------------------------------------------
 
+acceptor::ptr p2p::create_acceptor()
+{
+    return std::make_shared<acceptor>(threadpool_, channel_pools_, buffers_,
+        timers_, admission_, settings_);
+}
+
+// Connectors are reused so that each attempt does not allocate a dispatcher,
+// mutex and timer. The idle set is bounded by the nominal connecting count.
+// The timeout is set on each use, so that a reload applies to reused ones.
+connector::ptr p2p::create_connector()
+{
+    connector::ptr connector;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    idle_mutex_.lock();
+
+    if (!idle_connectors_.empty())
+    {
+        connector = idle_connectors_.back();
+        idle_connectors_.pop_back();
+    }
+
+    idle_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (!connector)
+        connector = std::make_shared<network::connector>(threadpool_,
+            channel_pools_, buffers_, timers_, resolver_, settings_);
+
+    connector->set_timeout(runtime_.load()->connect_timeout());
+    return connector;
+}
+
 code p2p::pend(connector::ptr connector)
 {
     return pending_connect_.store(connector);
@@ -435,8 +1110,96 @@ code p2p::pend(connector::ptr connector)
 
 void p2p::unpend(connector::ptr connector)
 {
-    connector->stop(error::success);
     pending_connect_.remove(connector);
+
+    if (stopped() || !connector->recycle())
+    {
+        connector->stop(error::success);
+        return;
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    idle_mutex_.lock();
+
+    if (!stopped() &&
+        idle_connectors_.size() < nominal_connecting(settings_))
+    {
+        idle_connectors_.push_back(connector);
+        idle_mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    idle_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    connector->stop(error::success);
+}
+
+// private
+bool p2p::valid_versions() const
+{
+    using namespace message;
+
+    if (settings_.protocol_minimum < version::level::minimum)
+    {
+        LOG_ERROR(LOG_NETWORK)
+            << "Invalid protocol version configuration, minimum below ("
+            << version::level::minimum << ").";
+        return false;
+    }
+
+    if (settings_.protocol_maximum > version::level::maximum)
+    {
+        LOG_ERROR(LOG_NETWORK)
+            << "Invalid protocol version configuration, maximum above ("
+            << version::level::maximum << ").";
+        return false;
+    }
+
+    if (settings_.protocol_minimum > settings_.protocol_maximum)
+    {
+        LOG_ERROR(LOG_NETWORK)
+            << "Invalid protocol version configuration, "
+            << "minimum exceeds maximum.";
+        return false;
+    }
+
+    return true;
+}
+
+// private
+void p2p::preallocate_connectors()
+{
+    const auto count = nominal_connecting(settings_);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(idle_mutex_);
+
+    while (idle_connectors_.size() < count)
+        idle_connectors_.push_back(std::make_shared<connector>(threadpool_,
+            channel_pools_, buffers_, timers_, resolver_, settings_));
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void p2p::stop_idle_connectors()
+{
+    std::vector<connector::ptr> idle;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    idle_mutex_.lock();
+
+    idle.swap(idle_connectors_);
+
+    idle_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto& connector: idle)
+        connector->stop(error::service_stopped);
 }
 
 // Pending handshake collection.
@@ -444,7 +1207,7 @@ void p2p::unpend(connector::ptr connector)
 
 code p2p::pend(channel::ptr channel)
 {
-    return pending_handshake_.store(channel);
+    return pending_handshake_.store(channel, false);
 }
 
 void p2p::unpend(channel::ptr channel)
@@ -454,12 +1217,7 @@ void p2p::unpend(channel::ptr channel)
 
 bool p2p::pending(uint64_t version_nonce) const
 {
-    const auto match = [version_nonce](const channel::ptr& element)
-    {
-        return element->nonce() == version_nonce;
-    };
-
-    return pending_handshake_.exists(match);
+    return pending_handshake_.exists(version_nonce);
 }
 
 // Pending close collection (open connections).
@@ -472,24 +1230,13 @@ size_t p2p::connection_count() const
 
 bool p2p::connected(const address& address) const
 {
-    const auto match = [&address](const channel::ptr& element)
-    {
-        return element->authority() == address;
-    };
-
-    return pending_close_.exists(match);
+    return pending_close_.exists(config::authority(address));
 }
 
 code p2p::store(channel::ptr channel)
 {
-    const auto address = channel->authority();
-    const auto match = [&address](const channel::ptr& element)
-    {
-        return element->authority() == address;
-    };
-
     // May return error::address_in_use.
-    const auto ec = pending_close_.store(channel, match);
+    const auto ec = pending_close_.store(channel, true);
 
     if (!ec && channel->notify())
         channel_subscriber_->relay(error::success, channel);
@@ -499,7 +1246,159 @@ code p2p::store(channel::ptr channel)
 
 void p2p::remove(channel::ptr channel)
 {
+    // Retain the counters of the channel, as it is no longer enumerated.
+    const auto counters = channel->metrics().collect();
+    const auto latency = channel->metrics().latency();
     pending_close_.remove(channel);
+
+    // Favor the address in future selection according to its latency.
+    if (latency.samples != 0)
+    {
+        const auto average = std::chrono::duration_cast<asio::milliseconds>(
+            latency.average).count();
+        hosts_.rate(channel->authority().to_network_address(),
+            static_cast<uint32_t>(average));
+    }
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(metrics_mutex_);
+
+    retired_metrics_.add(counters);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+channel_registry::list p2p::ranked_channels() const
+{
+    typedef std::pair<asio::duration, channel::ptr> ranking;
+    std::vector<ranking> rankings;
+    const auto snapshot = pending_close_.snapshot();
+    rankings.reserve(snapshot->size());
+
+    for (const auto& channel: *snapshot)
+    {
+        const auto latency = channel->metrics().latency();
+        rankings.emplace_back(latency.samples == 0 ?
+            asio::duration::max() : latency.average, channel);
+    }
+
+    std::stable_sort(rankings.begin(), rankings.end(),
+        [](const ranking& left, const ranking& right)
+        {
+            return left.first < right.first;
+        });
+
+    channel_registry::list out;
+    out.reserve(rankings.size());
+
+    for (const auto& rank: rankings)
+        out.push_back(rank.second);
+
+    return out;
+}
+
+bool p2p::evict()
+{
+    const auto inbound = [](channel::ptr channel)
+    {
+        return channel->inbound();
+    };
+
+    const auto channel = eviction_.select(sample(inbound, max_size_t));
+
+    if (!channel)
+        return false;
+
+    LOG_DEBUG(LOG_NETWORK)
+        << "Evicting inbound channel [" << channel->authority() << "]";
+
+    channel->stop(error::channel_stopped);
+    return true;
+}
+
+// Message capture.
+// ----------------------------------------------------------------------------
+
+void p2p::set_capture(const authority& authority, bool enable)
+{
+    const auto ip = authority.ip();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    capture_mutex_.lock();
+
+    if (enable)
+        captures_.insert(ip);
+    else
+        captures_.erase(ip);
+
+    capture_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto channel: *pending_close_.snapshot())
+    {
+        if (channel->authority().ip() != ip)
+            continue;
+
+        if (!enable)
+            channel->set_capture(nullptr);
+        else if (!channel->capture())
+            capture(channel);
+    }
+
+    LOG_INFO(LOG_NETWORK)
+        << (enable ? "Started" : "Ended") << " capture of [" << authority
+        << "]";
+}
+
+void p2p::capture(channel::ptr channel)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    capture_mutex_.lock_shared();
+    const auto selected = captures_.find(channel->authority().ip()) !=
+        captures_.end();
+    capture_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (selected)
+        channel->set_capture(std::make_shared<message_capture>(
+            settings_.capture_buffer_bytes, settings_.identifier));
+}
+
+code p2p::save_capture(const authority& authority,
+    const boost::filesystem::path& file) const
+{
+    const auto ip = authority.ip();
+
+    for (const auto channel: *pending_close_.snapshot())
+    {
+        const auto capture = channel->capture();
+
+        if (capture && channel->authority().ip() == ip)
+            return capture->save(file);
+    }
+
+    return error::not_found;
+}
+
+// Counters recorded between the collection and removal of a channel are not
+// included, which is immaterial for monitoring.
+channel_metrics::snapshot p2p::metrics() const
+{
+    channel_metrics::snapshot out;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    metrics_mutex_.lock_shared();
+    out.add(retired_metrics_);
+    metrics_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto& channel: *pending_close_.snapshot())
+        out.add(channel->metrics().collect());
+
+    return out;
 }
 
 } // namespace network
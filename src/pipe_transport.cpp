@@ -0,0 +1,242 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/pipe_transport.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "pipe_transport"
+
+using namespace boost::asio;
+
+pipe_transport::pair pipe_transport::create(threadpool& pool,
+    const config::authority& first, const config::authority& second)
+{
+    const auto left = std::make_shared<pipe_transport>(pool, first);
+    const auto right = std::make_shared<pipe_transport>(pool, second);
+
+    // Each end holds the other weakly, so that neither keeps both alive.
+    left->peer_ = right;
+    right->peer_ = left;
+    return { left, right };
+}
+
+pipe_transport::pipe_transport(threadpool& pool,
+    const config::authority& authority)
+  : authority_(authority),
+    dispatch_(pool, NAME),
+    read_data_(nullptr),
+    read_size_(0),
+    read_filled_(0),
+    read_exact_(false),
+    closed_(false),
+    stopped_(false)
+{
+}
+
+config::authority pipe_transport::authority() const
+{
+    return authority_;
+}
+
+void pipe_transport::read_some(const mutable_buffer& buffer,
+    io_handler handler)
+{
+    start_read(buffer, false, handler);
+}
+
+void pipe_transport::read(const mutable_buffer& buffer, io_handler handler)
+{
+    start_read(buffer, true, handler);
+}
+
+// private
+void pipe_transport::start_read(const mutable_buffer& buffer, bool exact,
+    io_handler handler)
+{
+    boost_code ec;
+    size_t size = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    read_data_ = buffer_cast<uint8_t*>(buffer);
+    read_size_ = buffer_size(buffer);
+    read_filled_ = 0;
+    read_exact_ = exact;
+    read_handler_ = handler;
+    complete(handler, ec, size);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The handler is always posted, never invoked from within the read.
+    if (handler)
+        dispatch_.concurrent(handler, ec, size);
+}
+
+void pipe_transport::write(const const_buffers& buffers, io_handler handler)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+    const auto peer = stopped_ ? nullptr : peer_.lock();
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The peer is called outside of the lock, as it may call this end.
+    if (!peer || !peer->receive(buffers))
+    {
+        const boost_code ec = boost::asio::error::broken_pipe;
+        dispatch_.concurrent(handler, ec, size_t(0));
+        return;
+    }
+
+    dispatch_.concurrent(handler, boost_code(), buffer_size(buffers));
+}
+
+void pipe_transport::stop()
+{
+    io_handler handler;
+    boost_code ec;
+    size_t size = 0;
+    ptr peer;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (!stopped_)
+    {
+        stopped_ = true;
+        peer = peer_.lock();
+        peer_.reset();
+        complete(handler, ec, size);
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (handler)
+        dispatch_.concurrent(handler, ec, size);
+
+    // The far end reads what remains buffered and then the end of stream.
+    if (peer)
+        peer->close();
+}
+
+// private
+// Returns false if this end is stopped, in which case the bytes are dropped.
+bool pipe_transport::receive(const const_buffers& buffers)
+{
+    io_handler handler;
+    boost_code ec;
+    size_t size = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (stopped_)
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return false;
+    }
+
+    for (const auto& buffer: buffers)
+    {
+        const auto data = buffer_cast<const uint8_t*>(buffer);
+        inbound_.insert(inbound_.end(), data, data + buffer_size(buffer));
+    }
+
+    complete(handler, ec, size);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (handler)
+        dispatch_.concurrent(handler, ec, size);
+
+    return true;
+}
+
+// private
+void pipe_transport::close()
+{
+    io_handler handler;
+    boost_code ec;
+    size_t size = 0;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    closed_ = true;
+    peer_.reset();
+    complete(handler, ec, size);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (handler)
+        dispatch_.concurrent(handler, ec, size);
+}
+
+// private, call under mutex_.
+// Fill the pending read from the inbound bytes, and if it is satisfied (or
+// can never be) move its handler and result out for posting by the caller.
+void pipe_transport::complete(io_handler& handler, boost_code& ec,
+    size_t& size)
+{
+    handler = nullptr;
+
+    if (!read_handler_)
+        return;
+
+    const auto count = std::min(inbound_.size(), read_size_ - read_filled_);
+    std::copy(inbound_.begin(), inbound_.begin() + count,
+        read_data_ + read_filled_);
+    inbound_.erase(inbound_.begin(), inbound_.begin() + count);
+    read_filled_ += count;
+
+    const auto satisfied = read_exact_ ? read_filled_ == read_size_ :
+        read_filled_ != 0 || read_size_ == 0;
+
+    if (stopped_)
+        ec = boost::asio::error::operation_aborted;
+    else if (!satisfied && closed_)
+        ec = boost::asio::error::eof;
+    else if (!satisfied)
+        return;
+
+    size = read_filled_;
+    handler = std::move(read_handler_);
+    read_handler_ = nullptr;
+}
+
+} // namespace network
+} // namespace libbitcoin
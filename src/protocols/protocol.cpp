@@ -30,8 +30,8 @@ namespace network {
 #define NAME "protocol"
 
 protocol::protocol(p2p& network, channel::ptr channel, const std::string& name)
-  : pool_(network.thread_pool()),
-    dispatch_(network.thread_pool(), NAME),
+  : pool_(channel->pool()),
+    dispatch_(channel->pool(), NAME),
     channel_(channel),
     name_(name)
 {
@@ -72,6 +72,71 @@ void protocol::set_negotiated_version(uint32_t value)
     channel_->set_negotiated_version(value);
 }
 
+channel_metrics& protocol::metrics()
+{
+    return channel_->metrics();
+}
+
+void protocol::set_headers_preferred(bool value)
+{
+    channel_->set_headers_preferred(value);
+}
+
+void protocol::cork()
+{
+    channel_->cork();
+}
+
+void protocol::set_fee_filter(uint64_t value)
+{
+    channel_->set_fee_filter(value);
+}
+
+bloom_filter::ptr protocol::filter() const
+{
+    return channel_->filter();
+}
+
+void protocol::set_filter(bloom_filter::ptr value)
+{
+    channel_->set_filter(value);
+}
+
+bool protocol::peer_relay() const
+{
+    return channel_->peer_relay();
+}
+
+void protocol::enable_peer_relay()
+{
+    channel_->enable_peer_relay();
+}
+
+bool protocol::verbose() const
+{
+    return channel_->verbose();
+}
+
+inventory_queue& protocol::announcements()
+{
+    return channel_->announcements();
+}
+
+void protocol::set_useful()
+{
+    channel_->set_useful();
+}
+
+request_tracker& protocol::requests()
+{
+    return channel_->requests();
+}
+
+void protocol::known_addresses(const message::network_address::list& list)
+{
+    channel_->known_addresses(list);
+}
+
 threadpool& protocol::pool()
 {
     return pool_;
@@ -18,10 +18,16 @@
  */
 #include <bitcoin/network/protocols/protocol_address_31402.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
 #include <functional>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol.hpp>
 #include <bitcoin/network/protocols/protocol_events.hpp>
@@ -35,12 +41,34 @@ namespace network {
 using namespace bc::message;
 using namespace std::placeholders;
 
+// Each peer may send a burst of one full address message, then one address
+// per ten seconds.
+static const double address_burst = 1000;
+static const double addresses_per_second = 0.1;
+
+// Only small messages of recent addresses are forwarded, as they are likely
+// self announcements rather than responses to get_address.
+static const size_t forward_limit = 10;
+static const uint32_t fresh_seconds = 10 * 60;
+
+// Implausible timestamps are replaced with one that is five days old.
+static const uint32_t minimum_timestamp = 100000000;
+static const uint32_t future_seconds = 10 * 60;
+static const uint32_t default_age_seconds = 5 * 24 * 60 * 60;
+
+static uint32_t now()
+{
+    return static_cast<uint32_t>(std::time(nullptr));
+}
+
 static message::address configured_self(const network::settings& settings)
 {
     if (settings.self.port() == 0)
         return address{};
 
-    return address{ { settings.self.to_network_address() } };
+    auto self = settings.self.to_network_address();
+    self.set_timestamp(now());
+    return address{ { self } };
 }
 
 protocol_address_31402::protocol_address_31402(p2p& network,
@@ -48,6 +76,8 @@ protocol_address_31402::protocol_address_31402(p2p& network,
   : protocol_events(network, channel, NAME),
     network_(network),
     self_(configured_self(network_.network_settings())),
+    tokens_(address_burst),
+    updated_(asio::steady_clock::now()),
     CONSTRUCT_TRACK(protocol_address_31402)
 {
 }
@@ -85,39 +115,94 @@ bool protocol_address_31402::handle_receive_address(const code& ec,
     if (stopped(ec))
         return false;
 
-    LOG_DEBUG(LOG_NETWORK)
+    const auto& received = message->addresses();
+    const auto allowed = admit(received.size());
+    const auto current = now();
+    const auto forward = received.size() <= forward_limit;
+    address::list accepted;
+    address::list fresh;
+    accepted.reserve(allowed);
+
+    for (size_t index = 0; index < allowed; ++index)
+    {
+        auto host = received[index];
+        const auto timestamp = host.timestamp();
+
+        if (timestamp < minimum_timestamp ||
+            timestamp > current + future_seconds)
+            host.set_timestamp(current - default_age_seconds);
+        else if (forward && timestamp + fresh_seconds > current)
+            fresh.push_back(host);
+
+        accepted.push_back(host);
+    }
+
+    if (allowed < received.size())
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Address rate exceeded by [" << authority() << "] ("
+            << received.size() - allowed << " dropped)";
+
+    if (accepted.empty())
+        return true;
+
+    // The peer knows what it sent, so it is not forwarded back to it.
+    known_addresses(accepted);
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Storing addresses from [" << authority() << "] ("
-        << message->addresses().size() << ")";
+        << accepted.size() << ")";
 
-    // TODO: manage timestamps (active channels are connected < 3 hours ago).
-    network_.store(message->addresses(), BIND1(handle_store_addresses, _1));
+    network_.store(accepted, BIND1(handle_store_addresses, _1));
+    network_.forward(fresh, authority());
 
     // RESUBSCRIBE
     return true;
 }
 
+// private
+// Refill the peer's token bucket and take up to the requested count.
+size_t protocol_address_31402::admit(size_t count)
+{
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto elapsed = std::chrono::duration<double>(now - updated_);
+    tokens_ = std::min(address_burst,
+        tokens_ + elapsed.count() * addresses_per_second);
+    updated_ = now;
+
+    const auto allowed = std::min(count, static_cast<size_t>(tokens_));
+    tokens_ -= allowed;
+    return allowed;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 bool protocol_address_31402::handle_receive_get_address(const code& ec,
     get_address_const_ptr message)
 {
     if (stopped(ec))
         return false;
 
-    // TODO: allowing repeated queries can allow a channel to map our history.
-    // TODO: pull active hosts from host cache (currently just resending self).
     // TODO: need to distort for privacy, don't send currently-connected peers.
-    // TODO: response size limit is max_address (1000).
 
-    if (self_.addresses().empty())
+    // The response is sampled once per interval for all channels, so that
+    // requests do not each sample (or together map) the pool.
+    const auto response = network_.cached_addresses();
+
+    if (response->addresses().empty())
         return false;
 
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Sending addresses to [" << authority() << "] ("
-        << self_.addresses().size() << ")";
+        << response->addresses().size() << ")";
 
-    SEND2(self_, handle_send, _1, self_.command);
+    SEND2(*response, handle_send, _1, response->command);
 
-    // RESUBSCRIBE
-    return true;
+    // Only the first request of a channel is answered.
+    return false;
 }
 
 void protocol_address_31402::handle_store_addresses(const code& ec)
@@ -137,7 +222,7 @@ void protocol_address_31402::handle_store_addresses(const code& ec)
 void protocol_address_31402::handle_stop(const code&)
 {
     // None of the other bc::network protocols log their stop.
-    ////LOG_DEBUG(LOG_NETWORK)
+    ////NETWORK_LOG_DEBUG(LOG_NETWORK)
     ////    << "Stopped address protocol for [" << authority() << "].";
 }
 
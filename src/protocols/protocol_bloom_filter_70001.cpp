@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/protocols/protocol_bloom_filter_70001.hpp>
+
+#include <functional>
+#include <memory>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/bloom_filter.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "bloom_filter"
+#define CLASS protocol_bloom_filter_70001
+
+using namespace bc::message;
+using namespace std::placeholders;
+
+protocol_bloom_filter_70001::protocol_bloom_filter_70001(p2p& network,
+    channel::ptr channel, bool serve)
+  : protocol_events(network, channel, NAME),
+    serve_(serve),
+    CONSTRUCT_TRACK(protocol_bloom_filter_70001)
+{
+}
+
+// Start sequence.
+// ----------------------------------------------------------------------------
+
+void protocol_bloom_filter_70001::start()
+{
+    // Must have a handler to capture a shared self pointer in stop subscriber.
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE2(filter_load, handle_receive_filter_load, _1, _2);
+    SUBSCRIBE2(filter_add, handle_receive_filter_add, _1, _2);
+    SUBSCRIBE2(filter_clear, handle_receive_filter_clear, _1, _2);
+}
+
+// Protocol.
+// ----------------------------------------------------------------------------
+
+// private
+// Returns true if the filter message is not served, stopping a peer that
+// should know better from the absence of the bloom service (bip111).
+bool protocol_bloom_filter_70001::unserved()
+{
+    if (serve_)
+        return false;
+
+    if (negotiated_version() >= version::level::bip111)
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Unrequested bloom filter from [" << authority() << "]";
+        stop(error::bad_stream);
+    }
+
+    return true;
+}
+
+bool protocol_bloom_filter_70001::handle_receive_filter_load(const code& ec,
+    filter_load_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    if (unserved())
+        return !stopped();
+
+    if (!bloom_filter::valid(*message))
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Oversized bloom filter from [" << authority() << "]";
+        stop(error::bad_stream);
+        return false;
+    }
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
+        << "Bloom filter (" << message->filter().size() << " bytes) from ["
+        << authority() << "]";
+
+    // A loaded filter enables transaction relay (bip37).
+    set_filter(std::make_shared<bloom_filter>(*message));
+    enable_peer_relay();
+
+    // RESUBSCRIBE
+    return true;
+}
+
+bool protocol_bloom_filter_70001::handle_receive_filter_add(const code& ec,
+    filter_add_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    if (unserved())
+        return !stopped();
+
+    const auto filter = this->filter();
+
+    // An element added without a filter or over the limit is misbehavior.
+    if (!filter || message->data().size() > bloom_filter::maximum_element)
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Invalid bloom filter add from [" << authority() << "]";
+        stop(error::bad_stream);
+        return false;
+    }
+
+    filter->insert(message->data());
+
+    // RESUBSCRIBE
+    return true;
+}
+
+bool protocol_bloom_filter_70001::handle_receive_filter_clear(
+    const code& ec, filter_clear_const_ptr)
+{
+    if (stopped(ec))
+        return false;
+
+    if (unserved())
+        return !stopped();
+
+    // Relay to the peer is unfiltered once its filter is cleared, and is
+    // enabled even if the peer disabled relay by its version (bip37).
+    set_filter(nullptr);
+    enable_peer_relay();
+
+    // RESUBSCRIBE
+    return true;
+}
+
+void protocol_bloom_filter_70001::handle_stop(const code&)
+{
+    // None of the other bc::network protocols log their stop.
+    ////NETWORK_LOG_DEBUG(LOG_NETWORK)
+    ////    << "Stopped bloom_filter protocol for [" << authority() << "].";
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,387 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/protocols/protocol_compact_block_70014.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/compact_block_pool.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "compact_block"
+#define CLASS protocol_compact_block_70014
+
+using namespace bc::message;
+using namespace std::placeholders;
+
+// Version 1 short ids are of txids, version 2 of wtxids (bip152).
+static const uint64_t txid_version = 1;
+static const uint64_t wtxid_version = 2;
+
+static uint64_t own_version(const settings& settings)
+{
+    const auto witness = (settings.services & version::service::node_witness);
+    return witness != 0 ? wtxid_version : txid_version;
+}
+
+// Index encoding.
+// ----------------------------------------------------------------------------
+
+protocol_compact_block_70014::indexes protocol_compact_block_70014::encode(
+    const indexes& values)
+{
+    indexes differences;
+    differences.reserve(values.size());
+    uint64_t next = 0;
+
+    for (const auto index: values)
+    {
+        differences.push_back(index - next);
+        next = index + 1;
+    }
+
+    return differences;
+}
+
+bool protocol_compact_block_70014::decode(indexes& out,
+    const indexes& differences, size_t count)
+{
+    out.clear();
+    out.reserve(differences.size());
+    size_t next = 0;
+
+    for (const auto difference: differences)
+    {
+        // This also precludes overflow of the cumulative index.
+        if (next >= count || difference >= count - next)
+            return false;
+
+        const auto index = next + static_cast<size_t>(difference);
+        out.push_back(index);
+        next = index + 1;
+    }
+
+    return true;
+}
+
+protocol_compact_block_70014::protocol_compact_block_70014(p2p& network,
+    channel::ptr channel, compact_block_pool::ptr pool, bool high_bandwidth)
+  : protocol_events(network, channel, NAME),
+    pool_(pool),
+    high_bandwidth_(high_bandwidth),
+    version_(own_version(network.network_settings())),
+    peer_compact_version_(0),
+    pending_hash_(null_hash),
+    CONSTRUCT_TRACK(protocol_compact_block_70014)
+{
+}
+
+// Start sequence.
+// ----------------------------------------------------------------------------
+
+void protocol_compact_block_70014::start()
+{
+    // Must have a handler to capture a shared self pointer in stop subscriber.
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE2(send_compact, handle_receive_send_compact, _1, _2);
+    SUBSCRIBE2(compact_block, handle_receive_compact_block, _1, _2);
+    SUBSCRIBE2(block_transactions, handle_receive_block_transactions, _1, _2);
+    SUBSCRIBE2(get_block_transactions, handle_receive_get_block_transactions,
+        _1, _2);
+
+    // Announce each supported version, in order of preference.
+    for (auto version = version_; version >= txid_version; --version)
+    {
+        SEND2(send_compact(high_bandwidth_, version), handle_send, _1,
+            send_compact::command);
+    }
+}
+
+// private
+// The highest version announced by both sides, or our own if the peer has
+// not announced (it may still push compact blocks in high bandwidth mode).
+uint64_t protocol_compact_block_70014::compact_version() const
+{
+    const auto peer = peer_compact_version_.load();
+    return peer == 0 ? version_ : peer;
+}
+
+// Negotiation.
+// ----------------------------------------------------------------------------
+
+bool protocol_compact_block_70014::handle_receive_send_compact(
+    const code& ec, send_compact_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    const auto version = message->version();
+
+    // Unknown versions are ignored, as required for forward compatibility.
+    if (version < txid_version || version > version_)
+        return true;
+
+    // Retain the highest version that both sides support.
+    auto current = peer_compact_version_.load();
+    while (version > current &&
+        !peer_compact_version_.compare_exchange_weak(current, version))
+    {
+    }
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
+        << "Compact block version " << version << " ("
+        << (message->high_bandwidth_mode() ? "high" : "low")
+        << " bandwidth) accepted from [" << authority() << "]";
+
+    // RESUBSCRIBE
+    return true;
+}
+
+// Reconstruction.
+// ----------------------------------------------------------------------------
+
+bool protocol_compact_block_70014::handle_receive_compact_block(
+    const code& ec, compact_block_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    const auto& prefilled = message->transactions();
+    const auto count = prefilled.size() + message->short_ids().size();
+    transaction_list transactions(count);
+
+    // Prefilled indexes are differentially encoded (bip152).
+    size_t next = 0;
+
+    for (const auto& item: prefilled)
+    {
+        if (item.index() >= count - next)
+        {
+            NETWORK_LOG_DEBUG(LOG_NETWORK)
+                << "Invalid prefilled index from [" << authority() << "]";
+            stop(error::bad_stream);
+            return false;
+        }
+
+        const auto index = next + static_cast<size_t>(item.index());
+        transactions[index] = std::make_shared<const transaction>(
+            item.transaction());
+        next = index + 1;
+    }
+
+    const auto hash = message->header().hash();
+
+    if (!pool_->fill(*message, compact_version(), transactions))
+    {
+        request_block(hash);
+        return true;
+    }
+
+    indexes missing;
+
+    for (size_t index = 0; index < count; ++index)
+        if (!transactions[index])
+            missing.push_back(index);
+
+    if (missing.empty())
+    {
+        complete(message->header(), std::move(transactions));
+        return true;
+    }
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
+        << "Requesting " << missing.size() << " of " << count
+        << " compact block transactions from [" << authority() << "]";
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // A newer compact block replaces an incomplete reconstruction.
+    pending_hash_ = hash;
+    pending_header_ = message->header();
+    pending_ = std::move(transactions);
+    missing_ = missing;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Requested indexes are differentially encoded (bip152).
+    SEND2(get_block_transactions(hash, encode(missing)), handle_send, _1,
+        get_block_transactions::command);
+
+    // RESUBSCRIBE
+    return true;
+}
+
+bool protocol_compact_block_70014::handle_receive_block_transactions(
+    const code& ec, block_transactions_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    chain::header header;
+    transaction_list transactions;
+    const auto& received = message->transactions();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // Unsolicited and superseded responses are ignored.
+    if (message->block_hash() != pending_hash_)
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return true;
+    }
+
+    const auto matched = (received.size() == missing_.size());
+
+    if (matched)
+    {
+        for (size_t index = 0; index < missing_.size(); ++index)
+            pending_[missing_[index]] = std::make_shared<const transaction>(
+                received[index]);
+
+        header = pending_header_;
+        transactions = std::move(pending_);
+    }
+
+    pending_hash_ = null_hash;
+    pending_.clear();
+    missing_.clear();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (matched)
+        complete(header, std::move(transactions));
+    else
+        request_block(message->block_hash());
+
+    // RESUBSCRIBE
+    return true;
+}
+
+// private
+void protocol_compact_block_70014::complete(const chain::header& header,
+    transaction_list&& transactions)
+{
+    chain::transaction::list list;
+    list.reserve(transactions.size());
+
+    for (const auto& tx: transactions)
+        list.push_back(*tx);
+
+    const auto block = std::make_shared<const message::block>(
+        chain::header(header), std::move(list));
+
+    // A mismatch implies a short id collision with the pool.
+    if (block->generate_merkle_root() != header.merkle())
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Compact block reconstruction failed for [" << authority()
+            << "] " << encode_hash(header.hash());
+        request_block(header.hash());
+        return;
+    }
+
+    pool_->store(block, authority());
+}
+
+// private
+void protocol_compact_block_70014::request_block(const hash_digest& hash)
+{
+    const auto type = compact_version() == wtxid_version ?
+        inventory_vector::type_id::witness_block :
+        inventory_vector::type_id::block;
+
+    SEND2(get_data({ { type, hash } }), handle_send, _1, get_data::command);
+}
+
+// Service.
+// ----------------------------------------------------------------------------
+
+bool protocol_compact_block_70014::handle_receive_get_block_transactions(
+    const code& ec, get_block_transactions_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    pool_->fetch(message->block_hash(),
+        BIND3(handle_fetch, _1, _2, message));
+
+    // RESUBSCRIBE
+    return true;
+}
+
+void protocol_compact_block_70014::handle_fetch(const code& ec,
+    block_const_ptr block, get_block_transactions_const_ptr request)
+{
+    if (stopped(ec))
+        return;
+
+    // A block that is not stored is not served, the peer may ask another.
+    if (ec || !block)
+        return;
+
+    const auto& transactions = block->transactions();
+    indexes requested;
+
+    // Requested indexes are differentially encoded (bip152).
+    if (!decode(requested, request->indexes(), transactions.size()))
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Invalid transaction index from [" << authority() << "]";
+        stop(error::bad_stream);
+        return;
+    }
+
+    chain::transaction::list list;
+    list.reserve(requested.size());
+
+    for (const auto index: requested)
+        list.push_back(transactions[static_cast<size_t>(index)]);
+
+    SEND2(block_transactions(request->block_hash(), std::move(list)),
+        handle_send, _1, block_transactions::command);
+}
+
+void protocol_compact_block_70014::handle_stop(const code&)
+{
+    // None of the other bc::network protocols log their stop.
+    ////NETWORK_LOG_DEBUG(LOG_NETWORK)
+    ////    << "Stopped compact_block protocol for [" << authority() << "].";
+}
+
+} // namespace network
+} // namespace libbitcoin
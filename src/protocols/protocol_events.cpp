@@ -22,6 +22,7 @@
 #include <string>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol.hpp>
 
@@ -76,7 +77,7 @@ void protocol_events::handle_stopped(const code& ec)
 {
     if (!stopped(ec))
     {
-        LOG_VERBOSE(LOG_NETWORK)
+        NETWORK_LOG_VERBOSE(LOG_NETWORK)
             << "Stop protocol_" << name() << " on [" << authority() << "] "
             << ec.message();
     }
@@ -0,0 +1,91 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/protocols/protocol_fee_filter_70013.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "fee_filter"
+#define CLASS protocol_fee_filter_70013
+
+using namespace bc::message;
+using namespace std::placeholders;
+
+protocol_fee_filter_70013::protocol_fee_filter_70013(p2p& network,
+    channel::ptr channel)
+  : protocol_events(network, channel, NAME),
+    minimum_fee_(network.network_settings().minimum_fee_filter),
+    CONSTRUCT_TRACK(protocol_fee_filter_70013)
+{
+}
+
+// Start sequence.
+// ----------------------------------------------------------------------------
+
+void protocol_fee_filter_70013::start()
+{
+    // Must have a handler to capture a shared self pointer in stop subscriber.
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE2(fee_filter, handle_receive_fee_filter, _1, _2);
+
+    // A zero rate filters nothing, so it is not sent.
+    if (minimum_fee_ != 0)
+        SEND2(fee_filter{ minimum_fee_ }, handle_send, _1,
+            fee_filter::command);
+}
+
+// Protocol.
+// ----------------------------------------------------------------------------
+
+bool protocol_fee_filter_70013::handle_receive_fee_filter(const code& ec,
+    fee_filter_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
+        << "Fee filter (" << message->minimum_fee() << ") from ["
+        << authority() << "]";
+
+    // The peer may change its filter at any time.
+    set_fee_filter(message->minimum_fee());
+
+    // RESUBSCRIBE
+    return true;
+}
+
+void protocol_fee_filter_70013::handle_stop(const code&)
+{
+    // None of the other bc::network protocols log their stop.
+    ////NETWORK_LOG_DEBUG(LOG_NETWORK)
+    ////    << "Stopped fee_filter protocol for [" << authority() << "].";
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -22,6 +22,7 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_timer.hpp>
 
@@ -59,7 +60,7 @@ void protocol_ping_31402::send_ping(const code& ec)
 
     if (ec && ec != error::channel_timeout)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure in ping timer for [" << authority() << "] "
             << ec.message();
         stop(ec);
@@ -24,6 +24,7 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_ping_31402.hpp>
 #include <bitcoin/network/protocols/protocol_timer.hpp>
@@ -33,6 +34,9 @@ namespace network {
 
 #define CLASS protocol_ping_60001
 
+// A single slow sample does not indicate a slow peer.
+static const size_t minimum_latency_samples = 3;
+
 using namespace bc::message;
 using namespace std::placeholders;
 
@@ -51,7 +55,7 @@ void protocol_ping_60001::send_ping(const code& ec)
 
     if (ec && ec != error::channel_timeout)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure in ping timer for [" << authority() << "] "
             << ec.message();
         stop(ec);
@@ -60,12 +64,13 @@ void protocol_ping_60001::send_ping(const code& ec)
 
     if (pending_)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Ping latency limit exceeded [" << authority() << "]";
         stop(error::channel_timeout);
         return;
     }
 
+    sent_ = asio::steady_clock::now();
     pending_ = true;
     const auto nonce = pseudo_random();
     SUBSCRIBE3(pong, handle_receive_pong, _1, _2, nonce);
@@ -79,7 +84,7 @@ void protocol_ping_60001::handle_send_ping(const code& ec, const std::string&)
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure sending ping to [" << authority() << "] "
             << ec.message();
         stop(ec);
@@ -95,7 +100,7 @@ bool protocol_ping_60001::handle_receive_ping(const code& ec,
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure getting ping from [" << authority() << "] "
             << ec.message();
         stop(ec);
@@ -114,7 +119,7 @@ bool protocol_ping_60001::handle_receive_pong(const code& ec,
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure getting pong from [" << authority() << "] "
             << ec.message();
         stop(ec);
@@ -131,6 +136,22 @@ bool protocol_ping_60001::handle_receive_pong(const code& ec,
         return false;
     }
 
+    auto& counters = metrics();
+    counters.pinged(asio::steady_clock::now() - sent_);
+
+    // Evict a peer that is persistently slower than the configured limit.
+    const auto latency = counters.latency();
+
+    if (settings_.channel_latency_limit_milliseconds != 0 &&
+        latency.samples >= minimum_latency_samples &&
+        latency.average > settings_.channel_latency_limit())
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Ping latency limit exceeded on average [" << authority()
+            << "]";
+        stop(error::channel_timeout);
+    }
+
     return false;
 }
 
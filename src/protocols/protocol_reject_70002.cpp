@@ -24,6 +24,7 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_events.hpp>
 
@@ -65,7 +66,7 @@ bool protocol_reject_70002::handle_receive_reject(const code& ec,
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure receiving reject from [" << authority() << "] "
             << ec.message();
         stop(error::channel_stopped);
@@ -83,7 +84,7 @@ bool protocol_reject_70002::handle_receive_reject(const code& ec,
         hash = " [" + encode_hash(reject->data()) + "].";
 
     const auto code = reject->code();
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Received " << message << " reject (" << static_cast<uint16_t>(code)
         << ") from [" << authority() << "] '" << reject->reason()
         << "'" << hash;
@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/protocols/protocol_relay_31402.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "relay"
+#define CLASS protocol_relay_31402
+
+using namespace bc::message;
+using namespace std::placeholders;
+
+// The protocol limit on the number of items in an inv message.
+static const size_t maximum_inventory = 50000;
+
+protocol_relay_31402::protocol_relay_31402(p2p& network, channel::ptr channel)
+  : protocol_events(network, channel, NAME),
+    settings_(network.network_settings()),
+    trickle_(std::make_shared<deadline>(network.thread_pool(),
+        settings_.relay_trickle())),
+    CONSTRUCT_TRACK(protocol_relay_31402)
+{
+}
+
+void protocol_relay_31402::start()
+{
+    // Must have a handler to capture a shared self pointer in stop subscriber.
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE2(inventory, handle_receive_inventory, _1, _2);
+    start_trickle();
+}
+
+// private
+void protocol_relay_31402::start_trickle()
+{
+    if (stopped())
+        return;
+
+    trickle_->start(BIND1(send_inventory, _1), next_trickle());
+
+    // Do not retain the protocol in the timer if stopped during start.
+    if (stopped())
+        trickle_->stop();
+}
+
+// private
+// Intervals are exponentially distributed about the configured mean.
+asio::duration protocol_relay_31402::next_trickle() const
+{
+    const auto mean = std::chrono::duration<double>(settings_.relay_trickle());
+    const auto uniform = static_cast<double>(pseudo_random(1, max_uint64)) /
+        static_cast<double>(max_uint64);
+
+    return std::chrono::duration_cast<asio::duration>(
+        mean * -std::log(uniform));
+}
+
+// This is fired by the trickle timer.
+void protocol_relay_31402::send_inventory(const code& ec)
+{
+    if (stopped(ec))
+        return;
+
+    if (ec)
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Failure in relay timer for [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return;
+    }
+
+    // A peer that has disabled transaction relay (bip37) is sent blocks only,
+    // until it loads or clears a filter.
+    const auto relay = peer_relay();
+    auto& queue = announcements();
+
+    for (auto items = queue.dequeue(maximum_inventory); !items.empty();
+        items = queue.dequeue(maximum_inventory))
+    {
+        if (!relay)
+            items.erase(std::remove_if(items.begin(), items.end(),
+                [](const inventory_vector& item)
+                {
+                    return item.is_transaction_type();
+                }), items.end());
+
+        if (items.empty())
+            continue;
+
+        NETWORK_LOG_VERBOSE(LOG_NETWORK)
+            << "Announcing inventory to [" << authority() << "] ("
+            << items.size() << ")";
+
+        SEND2(inventory{ std::move(items) }, handle_send, _1,
+            inventory::command);
+    }
+
+    start_trickle();
+}
+
+bool protocol_relay_31402::handle_receive_inventory(const code& ec,
+    inventory_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    // Do not announce back to the peer the inventory it has announced.
+    announcements().known(message->inventories());
+
+    // RESUBSCRIBE
+    return true;
+}
+
+void protocol_relay_31402::handle_stop(const code&)
+{
+    trickle_->stop();
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -22,6 +22,7 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_timer.hpp>
 
@@ -96,7 +97,7 @@ bool protocol_seed_31402::handle_receive_address(const code& ec,
     if (stopped(ec))
         return false;
 
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Storing addresses from seed [" << authority() << "] ("
         << message->addresses().size() << ")";
 
@@ -121,7 +122,7 @@ void protocol_seed_31402::handle_send_get_address(const code& ec)
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure sending get_address to seed [" << authority() << "] "
             << ec.message();
         set_event(ec);
@@ -146,7 +147,7 @@ void protocol_seed_31402::handle_store_addresses(const code& ec)
         return;
     }
 
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Stopping completed seed [" << authority() << "] ";
 
     // 3 of 3
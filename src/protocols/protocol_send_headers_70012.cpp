@@ -0,0 +1,103 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/protocols/protocol_send_headers_70012.hpp>
+
+#include <functional>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/protocols/protocol_events.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "send_headers"
+#define CLASS protocol_send_headers_70012
+
+using namespace bc::message;
+using namespace std::placeholders;
+
+protocol_send_headers_70012::protocol_send_headers_70012(p2p& network,
+    channel::ptr channel)
+  : protocol_events(network, channel, NAME),
+    CONSTRUCT_TRACK(protocol_send_headers_70012)
+{
+}
+
+// Start sequence.
+// ----------------------------------------------------------------------------
+
+void protocol_send_headers_70012::start()
+{
+    // Must have a handler to capture a shared self pointer in stop subscriber.
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE2(send_headers, handle_receive_send_headers, _1, _2);
+    SUBSCRIBE2(headers, handle_receive_headers, _1, _2);
+    SEND2(send_headers{}, handle_send, _1, send_headers::command);
+}
+
+// Protocol.
+// ----------------------------------------------------------------------------
+
+bool protocol_send_headers_70012::handle_receive_send_headers(
+    const code& ec, send_headers_const_ptr)
+{
+    if (stopped(ec))
+        return false;
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
+        << "Announcing headers to [" << authority() << "]";
+
+    set_headers_preferred(true);
+
+    // The preference cannot be withdrawn, so do not resubscribe.
+    return false;
+}
+
+bool protocol_send_headers_70012::handle_receive_headers(const code& ec,
+    headers_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    inventory_vector::list blocks;
+    blocks.reserve(message->elements().size());
+
+    for (const auto& header: message->elements())
+        blocks.push_back({ inventory_vector::type_id::block, header.hash() });
+
+    // Do not announce back to the peer the blocks it has announced.
+    announcements().known(blocks);
+
+    // RESUBSCRIBE
+    return true;
+}
+
+void protocol_send_headers_70012::handle_stop(const code&)
+{
+    // None of the other bc::network protocols log their stop.
+    ////NETWORK_LOG_DEBUG(LOG_NETWORK)
+    ////    << "Stopped send_headers protocol for [" << authority() << "].";
+}
+
+} // namespace network
+} // namespace libbitcoin
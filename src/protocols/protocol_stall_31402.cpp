@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/protocols/protocol_stall_31402.hpp>
+
+#include <chrono>
+#include <functional>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/p2p.hpp>
+#include <bitcoin/network/protocols/protocol_timer.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "stall"
+#define CLASS protocol_stall_31402
+
+using namespace bc::message;
+using namespace std::placeholders;
+
+// Stalls are detected within a second of the timeout.
+static const auto check_interval = asio::seconds(1);
+
+protocol_stall_31402::protocol_stall_31402(p2p& network,
+    channel::ptr channel)
+  : protocol_timer(network, channel, true, NAME),
+    disconnect_(network.network_settings().request_stall_disconnect),
+    CONSTRUCT_TRACK(protocol_stall_31402)
+{
+}
+
+// Start sequence.
+// ----------------------------------------------------------------------------
+
+void protocol_stall_31402::start()
+{
+    protocol_timer::start(check_interval, BIND1(handle_timer, _1));
+
+    SUBSCRIBE2(not_found, handle_receive_not_found, _1, _2);
+}
+
+// Protocol.
+// ----------------------------------------------------------------------------
+
+void protocol_stall_31402::handle_timer(const code& ec)
+{
+    if (stopped(ec))
+        return;
+
+    if (ec && ec != error::channel_timeout)
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Failure in stall timer for [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return;
+    }
+
+    auto& tracker = requests();
+
+    if (!tracker.stalled())
+        return;
+
+    const auto timeout = std::chrono::duration_cast<asio::milliseconds>(
+        tracker.timeout());
+
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
+        << "Stalled " << tracker.outstanding() << " requests beyond "
+        << timeout.count() << "ms on [" << authority() << "]";
+
+    if (disconnect_)
+        stop(error::channel_timeout);
+}
+
+bool protocol_stall_31402::handle_receive_not_found(const code& ec,
+    not_found_const_ptr message)
+{
+    if (stopped(ec))
+        return false;
+
+    auto& tracker = requests();
+
+    for (const auto& item: message->inventories())
+        tracker.cancel(item.hash());
+
+    // RESUBSCRIBE
+    return true;
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -23,6 +23,7 @@
 #include <string>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_events.hpp>
 
@@ -35,7 +36,10 @@ using namespace std::placeholders;
 protocol_timer::protocol_timer(p2p& network, channel::ptr channel,
     bool perpetual, const std::string& name)
   : protocol_events(network, channel, name),
-    perpetual_(perpetual)
+    perpetual_(perpetual),
+    timers_(network.timers()),
+    timeout_(asio::seconds(0)),
+    timer_(0)
 {
 }
 
@@ -46,8 +50,9 @@ protocol_timer::protocol_timer(p2p& network, channel::ptr channel,
 void protocol_timer::start(const asio::duration& timeout,
     event_handler handle_event)
 {
-    // The deadline timer is thread safe.
-    timer_ = std::make_shared<deadline>(pool(), timeout);
+    // The timer wheel is thread safe, the timeout is set before start and
+    // otherwise only from the (sequential) event handler.
+    timeout_ = timeout;
     protocol_events::start(BIND2(handle_notify, _1, handle_event));
     reset_timer();
 }
@@ -55,7 +60,7 @@ void protocol_timer::start(const asio::duration& timeout,
 void protocol_timer::handle_notify(const code& ec, event_handler handler)
 {
     if (ec == error::channel_stopped)
-        timer_->stop();
+        timers_.cancel(timer_.exchange(0));
 
     handler(ec);
 }
@@ -69,7 +74,20 @@ void protocol_timer::reset_timer()
     if (stopped())
         return;
 
-    timer_->start(BIND1(handle_timer, _1));
+    // Replace any scheduled timeout, canceling an unfired one has no effect.
+    const auto id = timers_.schedule(timeout_, BIND1(handle_timer, _1));
+    timers_.cancel(timer_.exchange(id));
+
+    // Do not retain the protocol in the wheel if stopped during schedule.
+    if (stopped())
+        timers_.cancel(timer_.exchange(0));
+}
+
+// protected:
+void protocol_timer::reset_timer(const asio::duration& timeout)
+{
+    timeout_ = timeout;
+    reset_timer();
 }
 
 void protocol_timer::handle_timer(const code& ec)
@@ -77,7 +95,7 @@ void protocol_timer::handle_timer(const code& ec)
     if (stopped())
         return;
 
-    LOG_VERBOSE(LOG_NETWORK)
+    NETWORK_LOG_VERBOSE(LOG_NETWORK)
         << "Fired protocol_" << name() << " timer on [" << authority() << "] "
         << ec.message();
 
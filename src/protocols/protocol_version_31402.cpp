@@ -23,6 +23,7 @@
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_timer.hpp>
 #include <bitcoin/network/settings.hpp>
@@ -59,6 +60,8 @@ protocol_version_31402::protocol_version_31402(p2p& network,
     uint64_t minimum_services)
   : protocol_timer(network, channel, false, NAME),
     network_(network),
+    version_accepted_(false),
+    verack_received_(false),
     own_version_(own_version),
     own_services_(own_services),
     invalid_services_(invalid_services),
@@ -73,19 +76,36 @@ protocol_version_31402::protocol_version_31402(p2p& network,
 
 void protocol_version_31402::start(event_handler handler)
 {
-    const auto period = network_.network_settings().channel_handshake();
+    const auto period = network_.current_settings()->channel_handshake();
 
-    const auto join_handler = synchronize(handler, 2, NAME,
-        synchronizer_terminate::on_error);
+    // The handler is invoked once, in the context of the version receipt.
+    const auto complete = synchronize(handler, 1, NAME,
+        synchronizer_terminate::on_count);
 
-    // The handler is invoked in the context of the last message receipt.
-    protocol_timer::start(period, join_handler);
+    protocol_timer::start(period, BIND2(handle_event, _1, complete));
 
     SUBSCRIBE2(version, handle_receive_version, _1, _2);
     SUBSCRIBE2(verack, handle_receive_verack, _1, _2);
     SEND2(version_factory(), handle_send, _1, version::command);
 }
 
+// private
+void protocol_version_31402::handle_event(const code& ec,
+    event_handler complete)
+{
+    // Until the version is accepted any event completes the handshake.
+    if (!version_accepted_ || !ec)
+    {
+        complete(ec);
+        return;
+    }
+
+    // The channel was accepted before the verack, so a failure to receive it
+    // (or a later version reject) stops the channel.
+    if (!verack_received_ && !stopped(ec))
+        stop(ec);
+}
+
 message::version protocol_version_31402::version_factory() const
 {
     const auto& settings = network_.network_settings();
@@ -121,51 +141,17 @@ bool protocol_version_31402::handle_receive_version(const code& ec,
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure receiving version from [" << authority() << "] "
             << ec.message();
         set_event(ec);
         return false;
     }
 
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Peer [" << authority() << "] protocol version ("
         << message->value() << ") user agent: " << message->user_agent();
 
-    // TODO: move these three checks to initialization.
-    //-------------------------------------------------------------------------
-
-    const auto& settings = network_.network_settings();
-
-    if (settings.protocol_minimum < version::level::minimum)
-    {
-        LOG_ERROR(LOG_NETWORK)
-            << "Invalid protocol version configuration, minimum below ("
-            << version::level::minimum << ").";
-        set_event(error::channel_stopped);
-        return false;
-    }
-
-    if (settings.protocol_maximum > version::level::maximum)
-    {
-        LOG_ERROR(LOG_NETWORK)
-            << "Invalid protocol version configuration, maximum above ("
-            << version::level::maximum << ").";
-        set_event(error::channel_stopped);
-        return false;
-    }
-
-    if (settings.protocol_minimum > settings.protocol_maximum)
-    {
-        LOG_ERROR(LOG_NETWORK)
-            << "Invalid protocol version configuration, "
-            << "minimum exceeds maximum.";
-        set_event(error::channel_stopped);
-        return false;
-    }
-
-    //-------------------------------------------------------------------------
-
     if (!sufficient_peer(message))
     {
         set_event(error::channel_stopped);
@@ -176,13 +162,16 @@ bool protocol_version_31402::handle_receive_version(const code& ec,
     set_negotiated_version(version);
     set_peer_version(message);
 
-    LOG_DEBUG(LOG_NETWORK)
+    NETWORK_LOG_DEBUG(LOG_NETWORK)
         << "Negotiated protocol version (" << version
         << ") for [" << authority() << "]";
 
+    // Hold the verack so that it is written with the messages of protocols
+    // attached upon handshake completion, the session releases the channel.
+    cork();
     SEND2(verack(), handle_send, _1, verack::command);
 
-    // 1 of 2
+    version_accepted_ = true;
     set_event(error::success);
     return false;
 }
@@ -191,7 +180,7 @@ bool protocol_version_31402::sufficient_peer(version_const_ptr message)
 {
     if ((message->services() & invalid_services_) != 0)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Invalid peer network services (" << message->services()
             << ") for [" << authority() << "]";
         return false;
@@ -199,7 +188,7 @@ bool protocol_version_31402::sufficient_peer(version_const_ptr message)
 
     if ((message->services() & minimum_services_) != minimum_services_)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Insufficient peer network services (" << message->services()
             << ") for [" << authority() << "]";
         return false;
@@ -207,7 +196,7 @@ bool protocol_version_31402::sufficient_peer(version_const_ptr message)
 
     if (message->value() < minimum_version_)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Insufficient peer protocol version (" << message->value()
             << ") for [" << authority() << "]";
         return false;
@@ -224,15 +213,15 @@ bool protocol_version_31402::handle_receive_verack(const code& ec,
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure receiving verack from [" << authority() << "] "
             << ec.message();
         set_event(ec);
         return false;
     }
 
-    // 2 of 2
-    set_event(error::success);
+    // The verack may precede the version, acceptance completes the handshake.
+    verack_received_ = true;
     return false;
 }
 
@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/channel.hpp>
+#include <bitcoin/network/logging.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_version_31402.hpp>
 #include <bitcoin/network/settings.hpp>
@@ -122,7 +123,7 @@ bool protocol_version_70002::handle_receive_reject(const code& ec,
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Failure receiving reject from [" << authority() << "] "
             << ec.message();
         set_event(error::channel_stopped);
@@ -140,7 +141,7 @@ bool protocol_version_70002::handle_receive_reject(const code& ec,
     // Client is an obsolete, unsupported version.
     if (code == reject::reason_code::obsolete)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Obsolete version reject from [" << authority() << "] '"
             << reject->reason() << "'";
         set_event(error::channel_stopped);
@@ -150,7 +151,7 @@ bool protocol_version_70002::handle_receive_reject(const code& ec,
     // Duplicate version message received.
     if (code == reject::reason_code::duplicate)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Duplicate version reject from [" << authority() << "] '"
             << reject->reason() << "'";
         set_event(error::channel_stopped);
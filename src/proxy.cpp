@@ -21,14 +21,19 @@
 #define BOOST_BIND_NO_PLACEHOLDERS
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <string>
 #include <utility>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/define.hpp>
+#include <bitcoin/network/logging.hpp>
+#include <bitcoin/network/pool_allocator.hpp>
 #include <bitcoin/network/settings.hpp>
 
 namespace libbitcoin {
@@ -43,24 +48,85 @@ using namespace bc::message;
 // Dump up to 1k of payload as hex in order to diagnose failure.
 static const size_t invalid_payload_dump_size = 1024;
 
-// payload_buffer_ sizing assumes monotonically increasing size by version.
-// Initialize to pre-witness max payload and let grow to witness as required.
-// The socket owns the single thread on which this channel reads and writes.
-proxy::proxy(threadpool& pool, socket::ptr socket, const settings& settings)
-  : authority_(socket->authority()),
+// Control messages (ping, pong, reject, ...) written together, unbounded as
+// they are small and time sensitive, so never wait behind another class.
+static const size_t control_send_weight = max_size_t;
+
+// Announcements and requests (inv, addr, headers, get_data, ...) written
+// together. Most are small, so this amortizes the write completion over a
+// trickle burst, while bounding the delay it adds to a waiting bulk message.
+static const size_t announcement_send_weight = 16;
+
+// Bulk messages (block, tx, ...) written together. A block may be megabytes,
+// so taking only two per write allows the higher classes to preempt bulk
+// between messages, while the second keeps the socket busy.
+static const size_t bulk_send_weight = 2;
+
+// The maximum number of messages of each priority class written together.
+static const size_t send_weights[] =
+{
+    control_send_weight,
+    announcement_send_weight,
+    bulk_send_weight
+};
+
+// Payloads of at least this size are checksummed or parsed off the read loop.
+static const size_t offload_minimum_size = 64 * 1024;
+
+// The read loop is suspended while this many payloads await verification.
+static const size_t maximum_verifying = 4;
+
+// Messages that fit the read buffer are handled directly from it.
+static const size_t read_buffer_size = 16 * 1024;
+
+// payload_buffer_ is borrowed from the shared pool only while reading a
+// payload too large for the read buffer, so an idle channel does not pin a
+// maximum-size buffer.
+// The transport owns the single thread on which this channel reads and writes.
+proxy::proxy(threadpool& pool, buffer_pool& buffers, transport::ptr transport,
+    const settings& settings)
+  : authority_(transport->authority()),
     heading_buffer_(heading::maximum_size()),
-    payload_buffer_(heading::maximum_payload_size(settings.protocol_maximum, false)),
+    read_buffer_(read_buffer_size),
+    read_begin_(0),
+    read_end_(0),
+    read_delay_(asio::duration::zero()),
     maximum_payload_(heading::maximum_payload_size(settings.protocol_maximum,
         (settings.services & version::service::node_witness) != 0)),
-    socket_(socket),
+    transport_(transport),
+    pool_(pool),
+    buffers_(buffers),
     stopped_(true),
     protocol_magic_(settings.identifier),
     validate_checksum_(settings.validate_checksum),
+    validate_unsubscribed_(settings.validate_unsubscribed),
+    thread_affinity_(settings.thread_affinity),
     verbose_(settings.verbose),
     version_(settings.protocol_maximum),
+    send_coalesce_(settings.send_coalesce()),
+    send_queue_message_limit_(settings.send_queue_message_limit),
+    send_queue_byte_limit_(settings.send_queue_byte_limit),
+    send_queue_overflow_(settings.send_queue_overflow),
     message_subscriber_(pool),
-    stop_subscriber_(std::make_shared<stop_subscriber>(pool, NAME "_sub")),
-    dispatch_(pool, NAME "_dispatch")
+    stop_subscriber_(std::allocate_shared<stop_subscriber>(
+        pool_allocator<stop_subscriber>(), pool, NAME "_sub")),
+    writable_subscriber_(std::allocate_shared<writable_subscriber>(
+        pool_allocator<writable_subscriber>(), pool,
+        NAME "_writable")),
+    dispatch_(pool, NAME "_dispatch"),
+    upload_(settings.channel_upload_rate_limit),
+    download_(settings.channel_download_rate_limit),
+    capturing_(false),
+    shared_upload_(nullptr),
+    shared_download_(nullptr),
+    send_queue_messages_(0),
+    send_queue_bytes_(0),
+    sending_(false),
+    corked_(false),
+    throttled_(false),
+    send_allowed_(asio::steady_clock::now()),
+    verifying_(0),
+    reading_(true)
 {
 }
 
@@ -77,11 +143,31 @@ const config::authority& proxy::authority() const
     return authority_;
 }
 
+threadpool& proxy::pool()
+{
+    return pool_;
+}
+
+channel_metrics& proxy::metrics()
+{
+    return metrics_;
+}
+
+const channel_metrics& proxy::metrics() const
+{
+    return metrics_;
+}
+
 uint32_t proxy::negotiated_version() const
 {
     return version_.load();
 }
 
+bool proxy::verbose() const
+{
+    return verbose_;
+}
+
 void proxy::set_negotiated_version(uint32_t value)
 {
     version_.store(value);
@@ -100,13 +186,14 @@ void proxy::start(result_handler handler)
 
     stopped_ = false;
     stop_subscriber_->start();
+    writable_subscriber_->start();
     message_subscriber_.start();
 
     // Allow for subscription before first read, so no messages are missed.
     handler(error::success);
 
     // Start the read cycle.
-    read_heading();
+    read_frames();
 }
 
 // Stop subscription.
@@ -117,123 +204,409 @@ void proxy::subscribe_stop(result_handler handler)
     stop_subscriber_->subscribe(handler, error::channel_stopped);
 }
 
+// Rate limits.
+// ----------------------------------------------------------------------------
+// Reads are paced by delaying the next read, so that tcp backpressures the
+// peer, and writes by delaying the next write, so that the queue absorbs it.
+
+void proxy::set_rate_limits(rate_limiter& upload, rate_limiter& download)
+{
+    shared_upload_ = &upload;
+    shared_download_ = &download;
+}
+
+void proxy::set_capture(message_capture::ptr capture)
+{
+    capture_.store(capture);
+    capturing_ = static_cast<bool>(capture);
+}
+
+void proxy::set_scheduler(work_scheduler& scheduler)
+{
+    serial_ = scheduler.make_serial();
+}
+
+message_capture::ptr proxy::capture() const
+{
+    return capture_.load();
+}
+
+// private
+// Channels without shared limiters are exempt from their own limits too.
+asio::duration proxy::throttle(rate_limiter& own, rate_limiter* shared,
+    size_t bytes)
+{
+    if (shared == nullptr)
+        return asio::duration::zero();
+
+    return std::max(own.consume(bytes), shared->consume(bytes));
+}
+
 // Read cycle (read continues until stop).
 // ----------------------------------------------------------------------------
+// Reads take whatever the socket has available into the read buffer, and all
+// complete messages in it are then handled, so a burst of small messages
+// costs one completion. A message that cannot fit the buffer is completed by
+// an exact read into a payload buffer borrowed from the pool.
 
-void proxy::read_heading()
+void proxy::read_more()
 {
     if (stopped())
         return;
 
-    async_read(socket_->get(), buffer(heading_buffer_),
-        std::bind(&proxy::handle_read_heading,
+    // Pace reads to the download budget, tcp backpressures the peer.
+    if (read_delay_ != asio::duration::zero())
+    {
+        const auto delay = read_delay_;
+        read_delay_ = asio::duration::zero();
+        dispatch_.delayed(delay,
+            std::bind(&proxy::handle_read_delay,
+                shared_from_this(), _1));
+        return;
+    }
+
+    // Move a partial message to the front, making room to complete it.
+    if (read_begin_ != 0)
+    {
+        const auto begin = read_buffer_.begin();
+        std::copy(begin + read_begin_, begin + read_end_, begin);
+        read_end_ -= read_begin_;
+        read_begin_ = 0;
+    }
+
+    transport_->read_some(
+        buffer(read_buffer_.data() + read_end_,
+            read_buffer_.size() - read_end_),
+        std::bind(&proxy::handle_read_more,
             shared_from_this(), _1, _2));
 }
 
-void proxy::handle_read_heading(const boost_code& ec, size_t)
+void proxy::handle_read_more(const boost_code& ec, size_t bytes)
 {
     if (stopped())
         return;
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
-            << "Heading read failure [" << authority() << "] "
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Read failure [" << authority() << "] "
             << code(error::boost_to_error_code(ec)).message();
         stop(ec);
         return;
     }
 
-    const auto head = heading::factory(heading_buffer_);
+    read_delay_ = throttle(download_, shared_download_, bytes);
+    read_end_ += bytes;
+    read_frames();
+}
+
+void proxy::handle_read_delay(const code&)
+{
+    read_more();
+}
+
+// Handle buffered messages until more data is required or reading suspends.
+void proxy::read_frames()
+{
+    const auto heading_size = heading_buffer_.size();
+
+    while (!stopped())
+    {
+        const auto available = read_end_ - read_begin_;
+
+        if (available < heading_size)
+        {
+            read_more();
+            return;
+        }
+
+        const auto begin = read_buffer_.begin() + read_begin_;
+        std::copy(begin, begin + heading_size, heading_buffer_.begin());
+        const auto head = heading::factory(heading_buffer_);
+
+        if (!validate_heading(head))
+            return;
+
+        const auto payload_size = head.payload_size();
 
+        if (heading_size + payload_size > read_buffer_.size())
+        {
+            read_payload(head);
+            return;
+        }
+
+        if (available < heading_size + payload_size)
+        {
+            read_more();
+            return;
+        }
+
+        const auto payload = read_buffer_.data() + read_begin_ + heading_size;
+        read_begin_ += heading_size + payload_size;
+
+        if (!handle_frame(head, { payload, payload + payload_size }))
+            return;
+    }
+}
+
+// Returns false if the channel has stopped.
+bool proxy::validate_heading(const heading& head)
+{
     if (!head.is_valid())
     {
         LOG_WARNING(LOG_NETWORK)
             << "Invalid heading from [" << authority() << "]";
         stop(error::bad_stream);
-        return;
+        return false;
     }
 
     if (head.magic() != protocol_magic_)
     {
         // These are common, with magic 542393671 coming from http requests.
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Invalid heading magic (" << head.magic() << ") from ["
             << authority() << "]";
         stop(error::bad_stream);
-        return;
+        return false;
     }
 
     if (head.payload_size() > maximum_payload_)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Oversized payload indicated by " << head.command()
             << " heading from [" << authority() << "] ("
             << head.payload_size() << " bytes)";
         stop(error::bad_stream);
-        return;
+        return false;
+    }
+
+    return true;
+}
+
+// Returns false if the channel has stopped or reading is suspended.
+bool proxy::handle_frame(const heading& head, const data_slice& payload)
+{
+    if (!offloading(payload.size()))
+    {
+        if (!handle_payload(head, payload))
+            return false;
+
+        signal_activity();
+        return true;
     }
 
-    read_payload(head);
+    // An offloaded payload is copied out, as the read buffer is reused.
+    // The copy completes before verify, which may release the read loop.
+    const auto copy = std::make_shared<pooled_buffer>(buffers_,
+        payload.size());
+    std::copy(payload.begin(), payload.end(), copy->data().begin());
+    return verify(head, copy);
 }
 
+// The heading is consumed and the buffered part of the payload copied out.
 void proxy::read_payload(const heading& head)
 {
-    if (stopped())
-        return;
+    const auto heading_size = heading_buffer_.size();
+    const auto begin = read_buffer_.begin() + read_begin_ + heading_size;
+    const auto end = read_buffer_.begin() + read_end_;
+    const auto buffered = static_cast<size_t>(std::distance(begin, end));
+    read_begin_ = read_end_ = 0;
 
-    // This does not cause a reallocation.
-    payload_buffer_.resize(head.payload_size());
+    // Borrow a buffer of the announced size class from the shared pool.
+    payload_buffer_ = std::make_shared<pooled_buffer>(buffers_,
+        head.payload_size());
+    auto& payload = payload_buffer_->data();
+    std::copy(begin, end, payload.begin());
 
-    async_read(socket_->get(), buffer(payload_buffer_),
+    transport_->read(
+        buffer(payload.data() + buffered, payload.size() - buffered),
         std::bind(&proxy::handle_read_payload,
             shared_from_this(), _1, _2, head));
 }
 
-void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
+void proxy::handle_read_payload(const boost_code& ec, size_t bytes,
     const heading& head)
 {
+    // The buffer is returned to the pool on every path that does not hand it
+    // to the verifier, and the next read borrows another.
+    auto payload = std::move(payload_buffer_);
+
     if (stopped())
         return;
 
     if (ec)
     {
-        LOG_DEBUG(LOG_NETWORK)
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
             << "Payload read failure [" << authority() << "] "
             << code(error::boost_to_error_code(ec)).message();
         stop(ec);
         return;
     }
 
+    read_delay_ = throttle(download_, shared_download_, bytes);
+
+    if (!offloading(payload->data().size()))
+    {
+        const auto valid = handle_payload(head, payload->data());
+        payload.reset();
+
+        if (valid)
+        {
+            signal_activity();
+            read_frames();
+        }
+
+        return;
+    }
+
+    if (verify(head, payload))
+        read_frames();
+}
+
+// Determine if the payload is to be offloaded. Only the read loop offloads,
+// so a payload is handled inline only when no verification is outstanding.
+bool proxy::offloading(size_t payload_size) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(verify_mutex_);
+
+    // Once a payload is offloaded, later payloads follow it to retain order.
+    return verifying_ != 0 ||
+        ((validate_checksum_ || serial_) &&
+            payload_size >= offload_minimum_size);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Offload the payload, returning false if the read loop must suspend until a
+// verification completes, in which case handle_verify resumes it. The read
+// loop must not touch its buffers once suspended, so the payload is posted
+// (retaining order) before suspension is decided. A verification completing
+// in between observes that reading is not suspended, so it does not resume.
+bool proxy::verify(const heading& head, shared_payload payload)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    verify_mutex_.lock();
+    ++verifying_;
+    verify_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    post_verify(head, payload);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(verify_mutex_);
+
+    reading_ = verifying_ < maximum_verifying;
+    return reading_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Verification is ordered on the channel strand, overlapping the read.
+// With a scheduler it is ordered by the channel serial, on any idle core.
+void proxy::post_verify(const heading& head, shared_payload payload)
+{
+    if (serial_)
+    {
+        serial_->post(
+            std::bind(&proxy::handle_verify,
+                shared_from_this(), head, payload));
+        return;
+    }
+
+    dispatch_.ordered(
+        std::bind(&proxy::handle_verify,
+            shared_from_this(), head, payload));
+}
+
+void proxy::handle_verify(const heading& head, shared_payload payload)
+{
+    // The buffer returns to the pool once the last handler copy is gone.
+    const auto valid = !stopped() && handle_payload(head, payload->data());
+
+    if (valid)
+        signal_activity();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    verify_mutex_.lock();
+
+    --verifying_;
+    const auto resume = !reading_ && verifying_ < maximum_verifying;
+
+    if (resume)
+        reading_ = true;
+
+    verify_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Resume the read loop if it was suspended for verification backlog.
+    if (valid && resume)
+        read_frames();
+}
+
+// Returns false if the channel has been stopped due to an invalid payload.
+bool proxy::handle_payload(const heading& head, const data_slice& payload)
+{
+    const auto payload_size = payload.size();
+    const auto message_size = heading_buffer_.size() + payload_size;
+
+    // Messages are captured before validation, so invalid ones are retained.
+    if (capturing_)
+    {
+        const auto capture = capture_.load();
+
+        if (capture)
+            capture->received(head.command(), payload);
+    }
+
     // This is a pointless test but we allow it as an option for completeness.
-    if (validate_checksum_ &&
-        head.checksum() != bitcoin_checksum(payload_buffer_))
+    if (validate_checksum_ && head.checksum() != bitcoin_checksum(payload))
     {
         LOG_WARNING(LOG_NETWORK)
             << "Invalid " << head.command() << " payload from [" << authority()
             << "] bad checksum.";
         stop(error::bad_stream);
-        return;
+        return false;
+    }
+
+    // A message that no protocol handles is not worth parsing.
+    if (!validate_unsubscribed_ &&
+        message_subscriber_.unsubscribed(head.command()))
+    {
+        metrics_.received(head.command(), message_size,
+            asio::duration::zero());
+
+        NETWORK_LOG_VERBOSE(LOG_NETWORK)
+            << "Ignored " << head.command() << " from [" << authority()
+            << "] (" << payload_size << " bytes)";
+        return true;
     }
 
     // Notify subscribers of the new message.
-    payload_source source(payload_buffer_);
-    payload_stream istream(source);
+    // The message is read directly from the contiguous payload buffer.
+    auto source = make_safe_deserializer(payload.begin(), payload.end());
 
     // Failures are not forwarded to subscribers and channel is stopped below.
-    const auto code = message_subscriber_.load(head.type(), version_, istream);
-    const auto consumed = istream.peek() == std::istream::traits_type::eof();
+    // Parse time includes the invocation of blocking subscribers.
+    const auto start = asio::steady_clock::now();
+    const auto code = message_subscriber_.load(head.command(), version_,
+        source);
+    const auto consumed = source.is_exhausted();
+    metrics_.received(head.command(), message_size,
+        asio::steady_clock::now() - start);
 
     if (verbose_ && code)
     {
         const auto size = std::min(payload_size, invalid_payload_dump_size);
-        const auto begin = payload_buffer_.begin();
+        const auto begin = payload.begin();
 
-        LOG_VERBOSE(LOG_NETWORK)
+        NETWORK_LOG_VERBOSE(LOG_NETWORK)
             << "Invalid payload from [" << authority() << "] "
             << encode_base16(data_chunk{ begin, begin + size });
         stop(code);
-        return;
+        return false;
     }
 
     if (code)
@@ -242,7 +615,7 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
             << "Invalid " << head.command() << " payload from [" << authority()
             << "] " << code.message();
         stop(code);
-        return;
+        return false;
     }
 
     if (!consumed)
@@ -251,56 +624,430 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
             << "Invalid " << head.command() << " payload from [" << authority()
             << "] trailing bytes.";
         stop(error::bad_stream);
-        return;
+        return false;
     }
 
-    LOG_VERBOSE(LOG_NETWORK)
+    NETWORK_LOG_VERBOSE(LOG_NETWORK)
         << "Received " << head.command() << " from [" << authority()
         << "] (" << payload_size << " bytes)";
-
-    signal_activity();
-    read_heading();
+    return true;
 }
 
 // Message send sequence.
 // ----------------------------------------------------------------------------
+// Messages accumulate while a write is outstanding and are then written as a
+// single buffer sequence, so bursts of small messages share one write.
+// Each write takes queued messages by priority class, up to the class weight,
+// so control and announcement messages overtake queued bulk data.
 
-void proxy::do_send(command_ptr command, payload_ptr payload,
+void proxy::send(command_ptr command, payload_ptr payload,
     result_handler handler)
 {
-    async_write(socket_->get(), buffer(*payload),
-        std::bind(&proxy::handle_send,
-            shared_from_this(), _1, _2, command, payload, handler));
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock();
+
+    if (stopped())
+    {
+        send_mutex_.unlock();
+        //---------------------------------------------------------------------
+        handler(error::channel_stopped);
+        return;
+    }
+
+    const auto size = payload->size();
+
+    if (exceeds_limits(size))
+    {
+        const auto low_priority =
+            *command == message::inventory::command ||
+            *command == message::address::command;
+
+        switch (send_queue_overflow_)
+        {
+            case overflow_policy::drop:
+                if (!low_priority)
+                    break;
+
+                // fall through
+            case overflow_policy::stall:
+            {
+                throttled_ = true;
+                send_mutex_.unlock();
+                //-------------------------------------------------------------
+                NETWORK_LOG_VERBOSE(LOG_NETWORK)
+                    << "Send queue full, rejected " << *command << " to ["
+                    << authority() << "]";
+                handler(error::peer_throttling);
+                return;
+            }
+            case overflow_policy::disconnect:
+            {
+                send_mutex_.unlock();
+                //-------------------------------------------------------------
+                NETWORK_LOG_DEBUG(LOG_NETWORK)
+                    << "Send queue full, dropping [" << authority() << "]";
+                stop(error::peer_throttling);
+                handler(error::channel_stopped);
+                return;
+            }
+        }
+    }
+
+    const auto now = asio::steady_clock::now();
+    send_queue_[classify(*command)].push_back(
+        { command, payload, handler, now });
+    ++send_queue_messages_;
+    send_queue_bytes_ += size;
+
+    // Only the first message of an idle queue initiates a write.
+    const auto start = !sending_ && !corked_;
+    sending_ = sending_ || start;
+
+    send_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (capturing_)
+    {
+        const auto capture = capture_.load();
+
+        if (capture)
+            capture->sent(command, payload);
+    }
+
+    if (start)
+        start_send();
 }
 
-void proxy::handle_send(const boost_code& ec, size_t, command_ptr command,
-    payload_ptr payload, result_handler handler)
+void proxy::start_send()
 {
-    dispatch_.unlock();
-    const auto size = payload->size();
-    const auto error = code(error::boost_to_error_code(ec));
+    // An idle queue still owes the upload debt of its prior writes, and of
+    // other channels on the shared budget, so the first write waits it out.
+    const auto delay = send_delay();
 
-    if (stopped())
+    if (delay != asio::duration::zero())
     {
-        handler(error);
+        dispatch_.delayed(std::max(delay, send_coalesce_),
+            std::bind(&proxy::handle_flush,
+                shared_from_this(), _1));
         return;
     }
 
-    if (error)
+    // Optionally wait for more messages so that they are written together.
+    // With thread affinity the write is initiated on the thread of this
+    // channel, so a send from elsewhere (such as broadcast) is posted to it.
+    if (send_coalesce_ != asio::duration::zero())
+        dispatch_.delayed(send_coalesce_,
+            std::bind(&proxy::handle_flush,
+                shared_from_this(), _1));
+    else if (thread_affinity_)
+        dispatch_.concurrent(
+            std::bind(&proxy::do_send,
+                shared_from_this()));
+    else
+        do_send();
+}
+
+void proxy::handle_flush(const code&)
+{
+    do_send();
+}
+
+// The remaining upload debt of this channel or the shared budget.
+asio::duration proxy::send_delay() const
+{
+    if (shared_upload_ == nullptr)
+        return asio::duration::zero();
+
+    const auto now = asio::steady_clock::now();
+    auto own = asio::duration::zero();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock_shared();
+
+    if (send_allowed_ > now)
+        own = std::chrono::duration_cast<asio::duration>(
+            send_allowed_ - now);
+
+    send_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return std::max(own, shared_upload_->delay());
+}
+
+void proxy::cork()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(send_mutex_);
+
+    corked_ = true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void proxy::uncork()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock();
+
+    const auto start = corked_ && !sending_ && !stopped() &&
+        !send_queue_empty();
+
+    corked_ = false;
+    sending_ = sending_ || start;
+
+    send_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (start)
+        start_send();
+}
+
+size_t proxy::send_queue_messages() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(send_mutex_);
+
+    return send_queue_messages_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t proxy::send_queue_bytes() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(send_mutex_);
+
+    return send_queue_bytes_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool proxy::writable() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(send_mutex_);
+
+    return !throttled_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void proxy::subscribe_writable(result_handler handler)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock();
+
+    // Subscribe under the lock so that the drain notification is not missed.
+    if (throttled_)
     {
-        LOG_DEBUG(LOG_NETWORK)
-            << "Failure sending " << *command << " to [" << authority()
-            << "] (" << size << " bytes) " << error.message();
+        writable_subscriber_->subscribe(handler, error::channel_stopped);
+        send_mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    send_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    handler(stopped() ? error::channel_stopped : error::success);
+}
+
+// private
+proxy::priority proxy::classify(const std::string& command)
+{
+    if (command == message::ping::command ||
+        command == message::pong::command ||
+        command == message::verack::command ||
+        command == message::version::command ||
+        command == message::reject::command)
+        return priority::control;
+
+    if (command == message::block::command ||
+        command == message::transaction::command ||
+        command == message::merkle_block::command)
+        return priority::bulk;
+
+    // Announcements (inv, headers, compact blocks) and requests.
+    return priority::announcement;
+}
+
+// private, call under send_mutex_.
+bool proxy::send_queue_empty() const
+{
+    for (const auto& queue: send_queue_)
+        if (!queue.empty())
+            return false;
+
+    return true;
+}
+
+// private, call under send_mutex_.
+// A message is always accepted into an empty queue, regardless of size.
+bool proxy::exceeds_limits(size_t size) const
+{
+    if (send_queue_messages_ == 0)
+        return false;
+
+    return
+        (send_queue_message_limit_ != 0 &&
+            send_queue_messages_ >= send_queue_message_limit_) ||
+        (send_queue_byte_limit_ != 0 &&
+            send_queue_bytes_ + size > send_queue_byte_limit_);
+}
+
+// private, call under send_mutex_.
+// Writability resumes at half of the limits to avoid rapid toggling.
+bool proxy::below_low_water() const
+{
+    return
+        (send_queue_message_limit_ == 0 ||
+            send_queue_messages_ <= send_queue_message_limit_ / 2) &&
+        (send_queue_byte_limit_ == 0 ||
+            send_queue_bytes_ <= send_queue_byte_limit_ / 2);
+}
+
+// Writes are sequential because sending_ is set until the queue is empty.
+void proxy::do_send()
+{
+    const auto batch = std::allocate_shared<send_batch>(
+        pool_allocator<send_batch>());
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock();
+
+    if (stopped() || send_queue_empty())
+    {
+        sending_ = false;
+        send_mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    // Take up to the weight of each class, highest precedence first.
+    for (size_t index = 0; index < priority_count; ++index)
+    {
+        auto& queue = send_queue_[index];
+        const auto count = std::min(queue.size(), send_weights[index]);
+        const auto end = queue.begin() + count;
+        std::move(queue.begin(), end, std::back_inserter(*batch));
+        queue.erase(queue.begin(), end);
+    }
+
+    send_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    transport::const_buffers buffers;
+    buffers.reserve(batch->size());
+
+    for (const auto& message: *batch)
+        buffers.push_back(buffer(*message.payload));
+
+    // The batch retains the payloads until the write completes.
+    transport_->write(buffers,
+        std::bind(&proxy::handle_send,
+            shared_from_this(), _1, _2, batch));
+}
+
+void proxy::handle_send(const boost_code& ec, size_t bytes,
+    send_batch_ptr batch)
+{
+    const auto error = code(error::boost_to_error_code(ec));
+    size_t size = 0;
+
+    for (const auto& message: *batch)
+        size += message.payload->size();
+
+    // Pace writes to the upload budget, the queue absorbs the difference.
+    // The debt is retained so that a write from an idle queue also waits.
+    const auto delay = throttle(upload_, shared_upload_, bytes);
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock();
+
+    if (delay != asio::duration::zero())
+        send_allowed_ = now + delay;
+
+    send_queue_messages_ -= batch->size();
+    send_queue_bytes_ -= size;
+    sending_ = !error && !stopped() && !corked_ && !send_queue_empty();
+    const auto more = sending_;
+    const auto drained = throttled_ && below_low_water();
+
+    if (drained)
+        throttled_ = false;
+
+    send_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (error && !stopped())
+    {
+        NETWORK_LOG_DEBUG(LOG_NETWORK)
+            << "Failure sending " << batch->size() << " messages to ["
+            << authority() << "] (" << size << " bytes) " << error.message();
         stop(error);
-        handler(error);
+    }
+
+    for (const auto& message: *batch)
+    {
+        if (!error)
+        {
+            metrics_.sent(*message.command, message.payload->size(),
+                now - message.queued);
+
+            NETWORK_LOG_VERBOSE(LOG_NETWORK)
+                << "Sent " << *message.command << " to [" << authority()
+                << "] (" << message.payload->size() << " bytes)";
+        }
+
+        message.handler(error);
+    }
+
+    if (drained && !error)
+        writable_subscriber_->relay(error::success);
+
+    if (!more)
         return;
+
+    if (delay == asio::duration::zero())
+        do_send();
+    else
+        dispatch_.delayed(delay,
+            std::bind(&proxy::handle_flush,
+                shared_from_this(), _1));
+}
+
+// Fail handlers of messages that have not been passed to the socket.
+void proxy::clear_send_queue(const code& ec)
+{
+    send_batch unsent;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    send_mutex_.lock();
+
+    for (auto& queue: send_queue_)
+    {
+        std::move(queue.begin(), queue.end(), std::back_inserter(unsent));
+        queue.clear();
     }
 
-    LOG_VERBOSE(LOG_NETWORK)
-        << "Sent " << *command << " to [" << authority() << "] (" << size
-        << " bytes)";
+    send_queue_messages_ -= unsent.size();
+
+    for (const auto& message: unsent)
+        send_queue_bytes_ -= message.payload->size();
+
+    send_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
 
-    handler(error);
+    for (const auto& message: unsent)
+        message.handler(ec);
 }
 
 // Stop sequence.
@@ -316,6 +1063,13 @@ void proxy::stop(const code& ec)
 
     stopped_ = true;
 
+    // Unsent messages are not written once stopped.
+    clear_send_queue(error::channel_stopped);
+
+    // Queued verifications retain the channel, so they are dropped.
+    if (serial_)
+        serial_->stop();
+
     // Prevent subscription after stop.
     message_subscriber_.stop();
     message_subscriber_.broadcast(error::channel_stopped);
@@ -324,11 +1078,15 @@ void proxy::stop(const code& ec)
     stop_subscriber_->stop();
     stop_subscriber_->relay(ec);
 
+    // Prevent subscription after stop.
+    writable_subscriber_->stop();
+    writable_subscriber_->relay(error::channel_stopped);
+
     // Give channel opportunity to terminate timers.
     handle_stopping();
 
-    // Signal socket to stop reading and accepting new work.
-    socket_->stop();
+    // Signal transport to stop reading and accepting new work.
+    transport_->stop();
 }
 
 void proxy::stop(const boost_code& ec)
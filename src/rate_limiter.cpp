@@ -0,0 +1,95 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/rate_limiter.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+rate_limiter::rate_limiter(size_t bytes_per_second)
+  : rate_(static_cast<double>(bytes_per_second)),
+    tokens_(rate_),
+    updated_(asio::steady_clock::now())
+{
+}
+
+bool rate_limiter::enabled() const
+{
+    return rate_ != 0;
+}
+
+asio::duration rate_limiter::consume(size_t bytes)
+{
+    if (!enabled())
+        return asio::duration::zero();
+
+    const auto now = asio::steady_clock::now();
+    double debt;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto elapsed = std::chrono::duration<double>(now - updated_);
+    tokens_ = std::min(rate_, tokens_ + elapsed.count() * rate_);
+    tokens_ -= static_cast<double>(bytes);
+    updated_ = now;
+    debt = -tokens_;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (debt <= 0)
+        return asio::duration::zero();
+
+    return std::chrono::duration_cast<asio::duration>(
+        std::chrono::duration<double>(debt / rate_));
+}
+
+asio::duration rate_limiter::delay() const
+{
+    if (!enabled())
+        return asio::duration::zero();
+
+    const auto now = asio::steady_clock::now();
+    double debt;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_shared();
+
+    const auto elapsed = std::chrono::duration<double>(now - updated_);
+    debt = -std::min(rate_, tokens_ + elapsed.count() * rate_);
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (debt <= 0)
+        return asio::duration::zero();
+
+    return std::chrono::duration_cast<asio::duration>(
+        std::chrono::duration<double>(debt / rate_));
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,231 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/request_tracker.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::asio;
+
+// The weight of each delivery in the moving rate and size averages.
+static const double average_weight = 0.25;
+
+// A peer is allowed this multiple of the expected time before a stall.
+static const double stall_tolerance = 2.0;
+
+request_tracker::request_tracker(size_t minimum_window,
+    size_t maximum_window, const duration& minimum_timeout,
+    const duration& maximum_timeout)
+  : minimum_window_(std::max(minimum_window, size_t(1))),
+    maximum_window_(std::max(maximum_window, minimum_window_)),
+    minimum_timeout_(minimum_timeout),
+    maximum_timeout_(std::max(maximum_timeout, minimum_timeout)),
+    window_(minimum_window_),
+    credit_(0),
+    rate_(0),
+    item_size_(0),
+    progress_(steady_clock::now())
+{
+}
+
+// Properties.
+// ----------------------------------------------------------------------------
+
+size_t request_tracker::window() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return window_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t request_tracker::available() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return floor_subtract(window_, requests_.size());
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t request_tracker::outstanding() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return requests_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+double request_tracker::rate() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return rate_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+duration request_tracker::timeout() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return expected();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool request_tracker::stalled() const
+{
+    const auto now = steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return is_stalled(now);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private, call under mutex.
+// Without throughput samples the maximum applies, as for a first block.
+duration request_tracker::expected() const
+{
+    if (rate_ <= 0)
+        return maximum_timeout_;
+
+    const auto bytes = item_size_ * std::max(requests_.size(), size_t(1));
+    const auto seconds = stall_tolerance * bytes / rate_;
+    const auto expected = std::chrono::duration_cast<duration>(
+        std::chrono::duration<double>(seconds));
+
+    return std::min(std::max(expected, minimum_timeout_), maximum_timeout_);
+}
+
+// private, call under mutex.
+bool request_tracker::is_stalled(const time_point& now) const
+{
+    return !requests_.empty() && now - progress_ > expected();
+}
+
+// Requests.
+// ----------------------------------------------------------------------------
+
+bool request_tracker::request(const hash_digest& hash)
+{
+    const auto now = steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (requests_.size() >= window_)
+        return false;
+
+    // Time without outstanding requests is not counted against the peer.
+    if (requests_.empty())
+        progress_ = now;
+
+    return requests_.emplace(hash, now).second;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool request_tracker::deliver(const hash_digest& hash, size_t bytes)
+{
+    const auto now = steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (requests_.erase(hash) == 0)
+        return false;
+
+    // Throughput is measured over the time since the previous progress,
+    // which accounts for pipelined requests.
+    const auto elapsed = std::chrono::duration_cast<
+        std::chrono::duration<double>>(now - progress_).count();
+    const auto sample = bytes / std::max(elapsed, 0.001);
+    const auto first = rate_ <= 0;
+
+    rate_ = first ? sample : rate_ + average_weight * (sample - rate_);
+    item_size_ = first ? bytes : item_size_ + average_weight *
+        (bytes - item_size_);
+    progress_ = now;
+
+    // Additive increase, one per window of deliveries.
+    if (++credit_ >= window_)
+    {
+        credit_ = 0;
+        window_ = std::min(window_ + 1, maximum_window_);
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool request_tracker::cancel(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    return requests_.erase(hash) != 0;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+hash_list request_tracker::cancel()
+{
+    const auto now = steady_clock::now();
+    hash_list hashes;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    // Multiplicative decrease, only for a stall.
+    if (is_stalled(now))
+    {
+        credit_ = 0;
+        window_ = std::max(window_ / 2, minimum_window_);
+    }
+
+    hashes.reserve(requests_.size());
+
+    for (const auto& request: requests_)
+        hashes.push_back(request.first);
+
+    requests_.clear();
+    return hashes;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
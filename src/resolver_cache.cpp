@@ -0,0 +1,205 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/resolver_cache.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+#define NAME "resolver_cache"
+
+using namespace std::placeholders;
+
+// Bound the cache, expired records are pruned when it reaches this size.
+static const size_t maximum_records = 1000;
+
+resolver_cache::resolver_cache(threadpool& pool, const settings& settings)
+  : pool_(pool),
+    lifetime_(settings.resolve_cache())
+{
+}
+
+// private
+// An ip literal (ipv6 optionally bracketed) resolves to itself.
+bool resolver_cache::numeric(const std::string& hostname, uint16_t port,
+    endpoints& out)
+{
+    auto host = hostname;
+
+    if (host.size() > 2 && host.front() == '[' && host.back() == ']')
+        host = host.substr(1, host.size() - 2);
+
+    boost_code ec;
+    const auto ip = asio::address::from_string(host, ec);
+
+    if (ec)
+        return false;
+
+    out.emplace_back(ip, port);
+    return true;
+}
+
+void resolver_cache::resolve(const std::string& hostname, uint16_t port,
+    resolve_handler handler)
+{
+    // Literals are not queried, or they would fill the cache without bound.
+    const auto literal = std::make_shared<endpoints>();
+
+    if (numeric(hostname, port, *literal))
+    {
+        handler(error::success, literal);
+        return;
+    }
+
+    const auto key = hostname + ":" + std::to_string(port);
+    const auto now = asio::steady_clock::now();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    const auto cached = cache_.find(key);
+
+    if (cached != cache_.end() && cached->second.expiry > now)
+    {
+        const auto hosts = cached->second.hosts;
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        handler(error::success, hosts);
+        return;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    auto& waiting = pending_[key];
+    waiting.push_back(handler);
+    const auto query = waiting.size() == 1;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // A query for this name is already in flight.
+    if (!query)
+        return;
+
+    // Each query has its own resolver, as resolvers are not thread safe.
+    const auto resolver = std::make_shared<asio::resolver>(pool_.service());
+    const asio::query request(hostname, std::to_string(port));
+
+    // async_resolve will not invoke the handler within this function.
+    resolver->async_resolve(request,
+        std::bind(&resolver_cache::handle_resolve,
+            this, _1, _2, key, now, resolver));
+}
+
+void resolver_cache::handle_resolve(const boost_code& ec,
+    asio::iterator iterator, const std::string& key, asio::time_point start,
+    resolver_ptr)
+{
+    const auto now = asio::steady_clock::now();
+    const auto elapsed = std::chrono::duration_cast<asio::milliseconds>(
+        now - start);
+
+    const auto resolved = std::make_shared<endpoints>();
+    const asio::iterator end;
+
+    // The bound resolver is retained until here, completing the query.
+    for (; !ec && iterator != end; ++iterator)
+        resolved->push_back(iterator->endpoint());
+
+    const auto result = ec || resolved->empty() ? error::resolve_failed :
+        error::success;
+
+    LOG_DEBUG(LOG_NETWORK)
+        << "Resolved [" << key << "] to (" << resolved->size()
+        << ") addresses in " << elapsed.count() << "ms.";
+
+    handlers waiting;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // Failures are not cached, so the next request queries again.
+    if (!result && lifetime_ != asio::duration::zero())
+    {
+        prune(now);
+
+        if (cache_.size() < maximum_records || cache_.count(key) != 0)
+            cache_[key] = { resolved, now + lifetime_ };
+    }
+
+    waiting.swap(pending_[key]);
+    pending_.erase(key);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    const endpoints_ptr hosts(resolved);
+
+    for (const auto& handler: waiting)
+        handler(result, result ? nullptr : hosts);
+}
+
+// private, call under mutex.
+void resolver_cache::prune(asio::time_point now)
+{
+    if (cache_.size() < maximum_records)
+        return;
+
+    for (auto it = cache_.begin(); it != cache_.end();)
+    {
+        if (it->second.expiry <= now)
+            it = cache_.erase(it);
+        else
+            ++it;
+    }
+}
+
+void resolver_cache::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    cache_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t resolver_cache::size() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return cache_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/rolling_bloom.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// These give a false positive rate of one per million for each generation.
+static const size_t hash_functions = 20;
+static const size_t bits_per_entry = 29;
+static const size_t word_bits = 64;
+
+// Hashes are uniformly distributed, so any eight bytes serve as a hash.
+static uint64_t read_word(const hash_digest& hash, size_t offset)
+{
+    uint64_t value = 0;
+
+    for (size_t byte = 0; byte < sizeof(uint64_t); ++byte)
+        value |= uint64_t(hash[offset + byte]) << (8 * byte);
+
+    return value;
+}
+
+static size_t word_count(size_t generation_capacity)
+{
+    const auto bit_count = generation_capacity * bits_per_entry;
+    return std::max((bit_count + word_bits - 1) / word_bits, size_t(1));
+}
+
+// The seed keeps a peer from crafting hashes that collide in all filters.
+rolling_bloom::rolling_bloom(size_t capacity)
+  : generation_capacity_((capacity + 1) / 2),
+    bit_count_(word_count(generation_capacity_) * word_bits),
+    seed_(pseudo_random(0, max_uint64)),
+    inserted_(0),
+    current_(capacity == 0 ? 0 : word_count(generation_capacity_), 0),
+    previous_(current_.size(), 0)
+{
+}
+
+// private
+// Double hashing derives each function from two words of the hash.
+size_t rolling_bloom::position(const hash_digest& hash,
+    size_t function) const
+{
+    const auto first = read_word(hash, 0) ^ seed_;
+    const auto second = read_word(hash, sizeof(uint64_t)) | 1;
+    return static_cast<size_t>((first + function * second) % bit_count_);
+}
+
+// private
+bool rolling_bloom::test(const bits& generation,
+    const hash_digest& hash) const
+{
+    for (size_t function = 0; function < hash_functions; ++function)
+    {
+        const auto bit = position(hash, function);
+        const auto mask = uint64_t(1) << (bit % word_bits);
+
+        if ((generation[bit / word_bits] & mask) == 0)
+            return false;
+    }
+
+    return true;
+}
+
+bool rolling_bloom::contains(const hash_digest& hash) const
+{
+    if (current_.empty())
+        return false;
+
+    return test(current_, hash) || test(previous_, hash);
+}
+
+void rolling_bloom::insert(const hash_digest& hash)
+{
+    if (current_.empty())
+        return;
+
+    if (inserted_ == generation_capacity_)
+    {
+        previous_.swap(current_);
+        std::fill(current_.begin(), current_.end(), 0);
+        inserted_ = 0;
+    }
+
+    for (size_t function = 0; function < hash_functions; ++function)
+    {
+        const auto bit = position(hash, function);
+        current_[bit / word_bits] |= uint64_t(1) << (bit % word_bits);
+    }
+
+    ++inserted_;
+}
+
+void rolling_bloom::clear()
+{
+    std::fill(current_.begin(), current_.end(), 0);
+    std::fill(previous_.begin(), previous_.end(), 0);
+    inserted_ = 0;
+}
+
+} // namespace network
+} // namespace libbitcoin
@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/runtime_settings.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace bc::asio;
+
+runtime_settings::runtime_settings(const settings& settings)
+  : inbound_connections(settings.inbound_connections),
+    outbound_connections(settings.outbound_connections),
+    connect_timeout_seconds(settings.connect_timeout_seconds),
+    channel_handshake_seconds(settings.channel_handshake_seconds),
+    channel_inactivity_minutes(settings.channel_inactivity_minutes),
+    channel_expiration_minutes(settings.channel_expiration_minutes),
+    blacklists(settings.blacklists),
+    blacklist_subnets(settings.blacklist_subnets)
+{
+}
+
+duration runtime_settings::connect_timeout() const
+{
+    return seconds(connect_timeout_seconds);
+}
+
+duration runtime_settings::channel_handshake() const
+{
+    return seconds(channel_handshake_seconds);
+}
+
+duration runtime_settings::channel_inactivity() const
+{
+    return minutes(channel_inactivity_minutes);
+}
+
+duration runtime_settings::channel_expiration() const
+{
+    return minutes(channel_expiration_minutes);
+}
+
+} // namespace network
+} // namespace libbitcoin
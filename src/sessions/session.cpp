@@ -18,7 +18,6 @@
  */
 #include <bitcoin/network/sessions/session.hpp>
 
-#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -70,25 +69,62 @@ size_t session::connection_count() const
     return network_.connection_count();
 }
 
+runtime_settings::ptr session::current_settings() const
+{
+    return network_.current_settings();
+}
+
+bool session::evict_inbound()
+{
+    return network_.evict();
+}
+
 code session::fetch_address(address& out_address) const
 {
     return network_.fetch_address(out_address);
 }
 
+code session::fetch_address(address& out_address,
+    const hosts::groups& excluded) const
+{
+    return network_.fetch_address(out_address, excluded);
+}
+
+code session::promote_address(const authority& host)
+{
+    return network_.promote(host.to_network_address());
+}
+
+code session::demote_address(const authority& host)
+{
+    return network_.demote(host.to_network_address());
+}
+
+void session::resolve(const config::endpoint& host,
+    resolver_cache::resolve_handler handler)
+{
+    network_.resolver().resolve(host.host(), host.port(), handler);
+}
+
 bool session::blacklisted(const authority& authority) const
 {
-    const auto ip_compare = [&](const config::authority& blocked)
-    {
-        return authority.ip() == blocked.ip();
-    };
+    return network_.inbound_admission().blacklisted(authority);
+}
+
+authority::list session::load_anchors()
+{
+    return network_.load_anchors();
+}
 
-    const auto& list = settings_.blacklists;
-    return std::any_of(list.begin(), list.end(), ip_compare);
+compact_block_pool::ptr session::compact_pool() const
+{
+    return network_.compact_pool();
 }
 
+// A draining network creates no connections, as if stopped.
 bool session::stopped() const
 {
-    return stopped_;
+    return stopped_ || network_.draining();
 }
 
 bool session::stopped(const code& ec) const
@@ -101,12 +137,22 @@ bool session::stopped(const code& ec) const
 
 acceptor::ptr session::create_acceptor()
 {
-    return std::make_shared<acceptor>(pool_, settings_);
+    return network_.create_acceptor();
 }
 
 connector::ptr session::create_connector()
 {
-    return std::make_shared<connector>(pool_, settings_);
+    return network_.create_connector();
+}
+
+void session::release_admission()
+{
+    network_.inbound_admission().release();
+}
+
+bool session::rate_limited() const
+{
+    return true;
 }
 
 // Pending connect.
@@ -188,6 +234,25 @@ void session::register_channel(channel::ptr channel,
         return;
     }
 
+    // Set before start_channel, which may register the channel by nonce.
+    channel->set_notify(notify_on_connect_);
+    channel->set_nonce(pseudo_random(1, max_uint64));
+
+    // Timeouts are taken from the current reload, as they start with it.
+    const auto current = current_settings();
+    channel->set_timeouts(current->channel_expiration(),
+        current->channel_inactivity());
+
+    // Capture from the start, so that the handshake is included.
+    network_.capture(channel);
+
+    if (network_.work_threads().enabled())
+        channel->set_scheduler(network_.work_threads());
+
+    if (rate_limited())
+        channel->set_rate_limits(network_.upload_limit(),
+            network_.download_limit());
+
     start_channel(channel,
         BIND4(handle_start, _1, channel, handle_started, handle_stopped));
 }
@@ -195,9 +260,6 @@ void session::register_channel(channel::ptr channel,
 void session::start_channel(channel::ptr channel,
     result_handler handle_started)
 {
-    channel->set_notify(notify_on_connect_);
-    channel->set_nonce(pseudo_random(1, max_uint64));
-
     // The channel starts, invokes the handler, then starts the read cycle.
     channel->start(
         BIND3(handle_starting, _1, channel, handle_started));
@@ -270,13 +332,25 @@ void session::handle_start(const code& ec, channel::ptr channel,
             BIND3(handle_remove, _1, channel, handle_stopped));
     }
 
-    // This is the end of the registration sequence.
     handle_started(ec);
+
+    // The verack and the first messages of the protocols attached by the
+    // started handler are held by the handshake, and are written together.
+    // This is the end of the registration sequence.
+    channel->uncork();
 }
 
 void session::handle_remove(const code& ec, channel::ptr channel,
     result_handler handle_stopped)
 {
+    // A peer that sent an invalid message is banned from reconnecting.
+    if (ec == error::bad_stream && settings_.ban_misbehaving)
+    {
+        LOG_INFO(LOG_NETWORK)
+            << "Banned misbehaving peer [" << channel->authority() << "]";
+        network_.ban(channel->authority());
+    }
+
     network_.remove(channel);
     handle_stopped(error::success);
 }
@@ -18,7 +18,9 @@
  */
 #include <bitcoin/network/sessions/session_batch.hpp>
 
+#include <algorithm>
 #include <cstddef>
+#include <memory>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/connector.hpp>
 #include <bitcoin/network/p2p.hpp>
@@ -36,7 +38,68 @@ using namespace std::placeholders;
 
 session_batch::session_batch(p2p& network, bool notify_on_connect)
   : session(network, notify_on_connect),
-    batch_size_(std::max(settings_.connect_batch_size, 1u))
+    batch_size_(std::max(settings_.connect_batch_size, 1u)),
+    batch_delay_(settings_.connect_batch_delay())
+{
+}
+
+session_batch::race::race(size_t size)
+  : won(false),
+    connectors(size)
+{
+    hosts.reserve(size);
+}
+
+// private
+// Alternate ipv6 and ipv4 addresses, with fetch failures ordered last.
+void session_batch::interleave(candidates& hosts)
+{
+    candidates ipv4;
+    candidates ipv6;
+    candidates failed;
+
+    for (const auto& host: hosts)
+    {
+        if (host.ec)
+            failed.push_back(host);
+        else if (authority(host.host).ip().is_v4_mapped())
+            ipv4.push_back(host);
+        else
+            ipv6.push_back(host);
+    }
+
+    hosts.clear();
+
+    for (size_t index = 0; index < std::max(ipv4.size(), ipv6.size());
+        ++index)
+    {
+        if (index < ipv6.size())
+            hosts.push_back(ipv6[index]);
+
+        if (index < ipv4.size())
+            hosts.push_back(ipv4[index]);
+    }
+
+    hosts.insert(hosts.end(), failed.begin(), failed.end());
+}
+
+// Properties.
+// ----------------------------------------------------------------------------
+
+// protected:
+size_t session_batch::batch_size() const
+{
+    return batch_size_;
+}
+
+// protected:
+hosts::groups session_batch::excluded_groups() const
+{
+    return {};
+}
+
+// protected:
+void session_batch::attempted(const code&)
 {
 }
 
@@ -46,14 +109,63 @@ session_batch::session_batch(p2p& network, bool notify_on_connect)
 // protected:
 void session_batch::connect(channel_handler handler)
 {
-    const auto join_handler = synchronize(handler, batch_size_, NAME "_join",
+    const auto size = std::max(batch_size(), size_t(1));
+    const auto join_handler = synchronize(handler, size, NAME "_join",
         synchronizer_terminate::on_success);
 
-    for (size_t host = 0; host < batch_size_; ++host)
-        new_connect(join_handler);
+    const auto racer = std::make_shared<race>(size);
+    auto excluded = excluded_groups();
+
+    // Each host of the batch is also excluded from the remainder of it.
+    // If all known hosts are excluded the batch falls back to any host.
+    for (size_t host = 0; host < size; ++host)
+    {
+        candidate item;
+        item.ec = fetch_address(item.host, excluded);
+
+        if (item.ec == error::not_found && !excluded.empty())
+            item.ec = fetch_address(item.host);
+
+        if (!item.ec)
+            excluded.insert(hosts::group(item.host));
+
+        racer->hosts.push_back(item);
+    }
+
+    interleave(racer->hosts);
+
+    for (size_t attempt = 0; attempt < size; ++attempt)
+    {
+        // Staggered attempts reduce connection bursts (RFC 8305).
+        if (attempt == 0 || batch_delay_ == asio::duration::zero())
+            new_connect(racer, attempt, join_handler);
+        else
+            dispatch_delayed(batch_delay_ * attempt,
+                BIND4(handle_delay, _1, racer, attempt, join_handler));
+    }
+}
+
+void session_batch::connect(const authority& host, channel_handler handler)
+{
+    const auto racer = std::make_shared<race>(1);
+    racer->hosts.push_back({ error::success, host.to_network_address() });
+    new_connect(racer, 0, handler);
+}
+
+void session_batch::handle_delay(const code& ec, race_ptr racer,
+    size_t attempt, channel_handler handler)
+{
+    if (ec)
+    {
+        handler(ec, nullptr);
+        return;
+    }
+
+    new_connect(racer, attempt, handler);
 }
 
-void session_batch::new_connect(channel_handler handler)
+void session_batch::new_connect(race_ptr racer, size_t attempt,
+    channel_handler handler)
 {
     if (stopped())
     {
@@ -63,13 +175,19 @@ void session_batch::new_connect(channel_handler handler)
         return;
     }
 
-    network_address address;
-    const auto ec = fetch_address(address);
-    start_connect(ec, address, handler);
+    // Another attempt has already connected.
+    if (racer->won)
+    {
+        handler(error::channel_stopped, nullptr);
+        return;
+    }
+
+    const auto& item = racer->hosts[attempt];
+    start_connect(item.ec, item.host, racer, handler);
 }
 
 void session_batch::start_connect(const code& ec, const authority& host,
-    channel_handler handler)
+    race_ptr racer, channel_handler handler)
 {
     if (stopped(ec))
     {
@@ -101,24 +219,57 @@ void session_batch::start_connect(const code& ec, const authority& host,
         << "Connecting to [" << host << "]";
 
     const auto connector = create_connector();
+
+    // The race is stopped once won, so this fails for late attempts.
+    if (racer->connectors.store(connector))
+    {
+        handler(error::channel_stopped, nullptr);
+        return;
+    }
+
     pend(connector);
 
     // CONNECT
     connector->connect(host,
-        BIND4(handle_connect, _1, _2, connector, handler));
+        BIND6(handle_connect, _1, _2, host, connector, racer, handler));
 }
 
 void session_batch::handle_connect(const code& ec, channel::ptr channel,
-    connector::ptr connector, channel_handler handler)
+    const authority& host, connector::ptr connector, race_ptr racer,
+    channel_handler handler)
 {
+    // Leave the race before unpend, which may make the connector reusable.
+    racer->connectors.remove(connector);
     unpend(connector);
 
     if (ec)
     {
+        // Shutdown and cancellation do not reflect on the address.
+        if (!stopped(ec) && ec != error::channel_stopped && !racer->won)
+        {
+            demote_address(host);
+            attempted(ec);
+        }
+
         handler(ec, nullptr);
         return;
     }
 
+    // Address quality feedback improves selection of future connections.
+    promote_address(host);
+    attempted(error::success);
+
+    // Another attempt connected first, so this channel is not used.
+    if (racer->won.exchange(true))
+    {
+        channel->stop(error::channel_stopped);
+        handler(error::channel_stopped, nullptr);
+        return;
+    }
+
+    // Cancel the remaining attempts.
+    racer->connectors.stop(error::channel_stopped);
+
     LOG_DEBUG(LOG_NETWORK)
         << "Connected to [" << channel->authority() << "]";
 
@@ -18,14 +18,21 @@
  */
 #include <bitcoin/network/sessions/session_inbound.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_address_31402.hpp>
+#include <bitcoin/network/protocols/protocol_bloom_filter_70001.hpp>
+#include <bitcoin/network/protocols/protocol_compact_block_70014.hpp>
+#include <bitcoin/network/protocols/protocol_fee_filter_70013.hpp>
 #include <bitcoin/network/protocols/protocol_ping_31402.hpp>
 #include <bitcoin/network/protocols/protocol_ping_60001.hpp>
 #include <bitcoin/network/protocols/protocol_reject_70002.hpp>
+#include <bitcoin/network/protocols/protocol_relay_31402.hpp>
+#include <bitcoin/network/protocols/protocol_send_headers_70012.hpp>
+#include <bitcoin/network/protocols/protocol_stall_31402.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -36,8 +43,6 @@ using namespace std::placeholders;
 
 session_inbound::session_inbound(p2p& network, bool notify_on_connect)
   : session(network, notify_on_connect),
-    connection_limit_(settings_.inbound_connections +
-        settings_.outbound_connections + settings_.peers.size()),
     CONSTRUCT_TRACK(session_inbound)
 {
 }
@@ -70,23 +75,38 @@ void session_inbound::handle_started(const code& ec, result_handler handler)
         return;
     }
 
-    acceptor_ = create_acceptor();
+    // Each listener shares the port (SO_REUSEPORT) and runs its own accept
+    // loop, so the kernel distributes connections across them.
+    const auto configured = std::max<size_t>(settings_.inbound_listeners, 1);
+    const auto listeners = std::min(configured, acceptor::maximum_listeners());
 
-    // Relay stop to the acceptor.
+    if (listeners < configured)
+        LOG_WARNING(LOG_NETWORK)
+            << "Multiple listeners are not supported on this platform, "
+            << "using one.";
+
+    for (size_t index = 0; index < listeners; ++index)
+        acceptors_.push_back(create_acceptor());
+
+    // Relay stop to the acceptors.
     subscribe_stop(BIND1(handle_stop, _1));
 
     // START LISTENING ON PORT
-    const auto error_code = acceptor_->listen(settings_.inbound_port);
-
-    if (error_code)
+    for (const auto acceptor: acceptors_)
     {
-        LOG_ERROR(LOG_NETWORK)
-            << "Error starting listener: " << ec.message();
-        handler(error_code);
-        return;
+        const auto error_code = acceptor->listen(settings_.inbound_port);
+
+        if (error_code)
+        {
+            LOG_ERROR(LOG_NETWORK)
+                << "Error starting listener: " << error_code.message();
+            handler(error_code);
+            return;
+        }
     }
 
-    start_accept(error::success);
+    for (const auto acceptor: acceptors_)
+        start_accept(error::success, acceptor);
 
     // This is the end of the start sequence.
     handler(error::success);
@@ -94,14 +114,20 @@ void session_inbound::handle_started(const code& ec, result_handler handler)
 
 void session_inbound::handle_stop(const code& ec)
 {
-    // Signal the stop of listener/accept attempt.
-    acceptor_->stop(ec);
+    // Signal the stop of listener/accept attempts.
+    for (const auto acceptor: acceptors_)
+        acceptor->stop(ec);
+}
+
+void session_inbound::drain()
+{
+    handle_stop(error::service_stopped);
 }
 
 // Accept sequence.
 // ----------------------------------------------------------------------------
 
-void session_inbound::start_accept(const code&)
+void session_inbound::start_accept(const code&, acceptor::ptr acceptor)
 {
     if (stopped())
     {
@@ -111,20 +137,24 @@ void session_inbound::start_accept(const code&)
     }
 
     // ACCEPT THE NEXT INCOMING CONNECTION
-    acceptor_->accept(BIND2(handle_accept, _1, _2));
+    acceptor->accept(BIND3(handle_accept, _1, _2, acceptor));
 }
 
-void session_inbound::handle_accept(const code& ec, channel::ptr channel)
+void session_inbound::handle_accept(const code& ec, channel::ptr channel,
+    acceptor::ptr acceptor)
 {
     if (stopped(ec))
     {
+        if (!ec)
+            release_admission();
+
         LOG_DEBUG(LOG_NETWORK)
             << "Suspended inbound connection.";
         return;
     }
 
     // Start accepting again with conditional delay, regardless of error.
-    dispatch_delayed(cycle_delay(ec), BIND1(start_accept, _1));
+    dispatch_delayed(cycle_delay(ec), BIND2(start_accept, _1, acceptor));
 
     if (ec)
     {
@@ -133,21 +163,18 @@ void session_inbound::handle_accept(const code& ec, channel::ptr channel)
         return;
     }
 
-    if (blacklisted(channel->authority()))
-    {
-        LOG_DEBUG(LOG_NETWORK)
-            << "Rejected inbound connection from ["
-            << channel->authority() << "] due to blacklisted address.";
-        return;
-    }
+    channel->set_inbound(true);
 
+    // Blacklisted and throttled addresses are rejected by the acceptor.
     // Inbound connections can easily overflow in the case where manual and/or
     // outbound connections at the time are not yet connected as configured.
-    if (connection_count() >= connection_limit_)
+    // At the limit an unprotected inbound channel is evicted to make room.
+    if (connection_count() >= connection_limit() && !evict_inbound())
     {
         LOG_DEBUG(LOG_NETWORK)
             << "Rejected inbound connection from ["
             << channel->authority() << "] due to connection limit.";
+        release_admission();
         return;
     }
 
@@ -156,9 +183,20 @@ void session_inbound::handle_accept(const code& ec, channel::ptr channel)
         BIND1(handle_channel_stop, _1));
 }
 
+// The limit follows reloads of the inbound and outbound connection counts.
+size_t session_inbound::connection_limit() const
+{
+    const auto current = current_settings();
+    return current->inbound_connections + current->outbound_connections +
+        settings_.peers.size();
+}
+
 void session_inbound::handle_channel_start(const code& ec,
     channel::ptr channel)
 {
+    // The handshake is over, so it no longer counts against the limit.
+    release_admission();
+
     if (ec)
     {
         LOG_DEBUG(LOG_NETWORK)
@@ -188,6 +226,26 @@ void session_inbound::attach_protocols(channel::ptr channel)
         attach<protocol_reject_70002>(channel)->start();
 
     attach<protocol_address_31402>(channel)->start();
+
+    // Filters are served only if the bloom service is advertised (bip111).
+    if (version >= message::version::level::bip37)
+        attach<protocol_bloom_filter_70001>(channel, (settings_.services &
+            message::version::service::node_bloom) != 0)->start();
+
+    attach<protocol_relay_31402>(channel)->start();
+    attach<protocol_stall_31402>(channel)->start();
+
+    if (version >= message::version::level::bip130)
+        attach<protocol_send_headers_70012>(channel)->start();
+
+    if (version >= message::version::level::bip133)
+        attach<protocol_fee_filter_70013>(channel)->start();
+
+    // Compact block relay requires a pool from the layer above.
+    const auto pool = compact_pool();
+
+    if (pool && version >= message::version::level::bip152)
+        attach<protocol_compact_block_70014>(channel, pool, false)->start();
 }
 
 void session_inbound::handle_channel_stop(const code& ec)
@@ -21,13 +21,21 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/connect_scheduler.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_address_31402.hpp>
+#include <bitcoin/network/protocols/protocol_bloom_filter_70001.hpp>
+#include <bitcoin/network/protocols/protocol_compact_block_70014.hpp>
+#include <bitcoin/network/protocols/protocol_fee_filter_70013.hpp>
 #include <bitcoin/network/protocols/protocol_ping_31402.hpp>
 #include <bitcoin/network/protocols/protocol_ping_60001.hpp>
 #include <bitcoin/network/protocols/protocol_reject_70002.hpp>
+#include <bitcoin/network/protocols/protocol_relay_31402.hpp>
+#include <bitcoin/network/protocols/protocol_send_headers_70012.hpp>
+#include <bitcoin/network/protocols/protocol_stall_31402.hpp>
 
 namespace libbitcoin {
 namespace network {
@@ -36,12 +44,20 @@ namespace network {
 
 using namespace std::placeholders;
 
+// A channel that survives this long is healthy, so reconnects immediately.
+static const auto healthy_lifetime = asio::seconds(60);
+
 session_manual::session_manual(p2p& network, bool notify_on_connect)
   : session(network, notify_on_connect),
     CONSTRUCT_TRACK(session_manual)
 {
 }
 
+session_manual::retry::retry()
+  : failures(0)
+{
+}
+
 // Start sequence.
 // ----------------------------------------------------------------------------
 // Manual connections are always enabled.
@@ -80,12 +96,30 @@ void session_manual::connect(const std::string& hostname, uint16_t port,
     channel_handler handler)
 {
     start_connect(error::success, hostname, port,
-        settings_.manual_attempt_limit, handler);
+        settings_.manual_attempt_limit, std::make_shared<retry>(), handler);
+}
+
+// private
+asio::duration session_manual::backoff(retry::ptr state) const
+{
+    return connect_scheduler::backoff(state->failures,
+        settings_.manual_backoff_base(), settings_.manual_backoff_maximum());
+}
+
+// private
+// Reconnect after a channel drop, with the attempt limit restored.
+void session_manual::retry_connect(const code& ec,
+    const std::string& hostname, uint16_t port, retry::ptr state,
+    channel_handler handler)
+{
+    start_connect(ec, hostname, port, settings_.manual_attempt_limit, state,
+        handler);
 }
 
 // The first connect is a sequence, which then spawns a cycle.
 void session_manual::start_connect(const code&, const std::string& hostname,
-    uint16_t port, uint32_t attempts, channel_handler handler)
+    uint16_t port, uint32_t attempts, retry::ptr state,
+    channel_handler handler)
 {
     if (stopped())
     {
@@ -102,13 +136,13 @@ void session_manual::start_connect(const code&, const std::string& hostname,
 
     // MANUAL CONNECT OUTBOUND
     connector->connect(hostname, port,
-        BIND7(handle_connect, _1, _2, hostname, port, retries, connector,
-            handler));
+        BIND8(handle_connect, _1, _2, hostname, port, retries, connector,
+            state, handler));
 }
 
 void session_manual::handle_connect(const code& ec, channel::ptr channel,
     const std::string& hostname, uint16_t port, uint32_t remaining,
-    connector::ptr connector, channel_handler handler)
+    connector::ptr connector, retry::ptr state, channel_handler handler)
 {
     unpend(connector);
 
@@ -123,9 +157,11 @@ void session_manual::handle_connect(const code& ec, channel::ptr channel,
 
         if (remaining > 0)
         {
-            // Retry with conditional delay, regardless of error.
-            dispatch_delayed(cycle_delay(ec),
-                BIND5(start_connect, _1, hostname, port, remaining, handler));
+            // Retry with exponential backoff, regardless of error.
+            ++state->failures;
+            dispatch_delayed(backoff(state),
+                BIND6(start_connect, _1, hostname, port, remaining, state,
+                    handler));
             return;
         }
 
@@ -140,13 +176,14 @@ void session_manual::handle_connect(const code& ec, channel::ptr channel,
     }
 
     register_channel(channel,
-        BIND5(handle_channel_start, _1, hostname, port, channel, handler),
-        BIND3(handle_channel_stop, _1, hostname, port));
+        BIND6(handle_channel_start, _1, hostname, port, channel, state,
+            handler),
+        BIND4(handle_channel_stop, _1, hostname, port, state));
 }
 
 void session_manual::handle_channel_start(const code& ec,
     const std::string& hostname, uint16_t port, channel::ptr channel,
-    channel_handler handler)
+    retry::ptr state, channel_handler handler)
 {
     // The start failure is also caught by handle_channel_stop.
     // Treat a start failure like a stop, but preserve the start handler.
@@ -155,9 +192,14 @@ void session_manual::handle_channel_start(const code& ec,
         LOG_INFO(LOG_NETWORK)
             << "Manual channel failed to start [" << channel->authority()
             << "] " << ec.message();
+
+        // The stop handler backs off from a failed handshake.
+        state->started = asio::time_point();
         return;
     }
 
+    state->started = asio::steady_clock::now();
+
     LOG_INFO(LOG_NETWORK)
         << "Connected manual channel [" << config::endpoint(hostname, port)
         << "] as [" << channel->authority() << "] ("
@@ -181,18 +223,58 @@ void session_manual::attach_protocols(channel::ptr channel)
         attach<protocol_reject_70002>(channel)->start();
 
     attach<protocol_address_31402>(channel)->start();
+
+    // Filters are served only if the bloom service is advertised (bip111).
+    if (version >= message::version::level::bip37)
+        attach<protocol_bloom_filter_70001>(channel, (settings_.services &
+            message::version::service::node_bloom) != 0)->start();
+
+    attach<protocol_relay_31402>(channel)->start();
+    attach<protocol_stall_31402>(channel)->start();
+
+    if (version >= message::version::level::bip130)
+        attach<protocol_send_headers_70012>(channel)->start();
+
+    if (version >= message::version::level::bip133)
+        attach<protocol_fee_filter_70013>(channel)->start();
+
+    // Compact block relay requires a pool from the layer above.
+    const auto pool = compact_pool();
+
+    if (pool && version >= message::version::level::bip152)
+        attach<protocol_compact_block_70014>(channel, pool, false)->start();
+}
+
+bool session_manual::rate_limited() const
+{
+    return false;
 }
 
 void session_manual::handle_channel_stop(const code& ec,
-    const std::string& hostname, uint16_t port)
+    const std::string& hostname, uint16_t port, retry::ptr state)
 {
     LOG_DEBUG(LOG_NETWORK)
         << "Manual channel stopped: " << ec.message();
 
     // Special case for already connected, do not keep trying.
+    if (ec == error::address_in_use)
+        return;
+
+    const auto started = state->started;
+    state->started = asio::time_point();
+
+    // Fast path, a clean drop of a healthy channel reconnects immediately.
+    // Otherwise the drop counts as a failure, so a flapping peer backs off.
+    if (started != asio::time_point() && !stopped(ec) &&
+        asio::steady_clock::now() - started >= healthy_lifetime)
+        state->failures = 0;
+    else
+        ++state->failures;
+
     // After a stop we don't use the caller's start handler, but keep connecting.
-    if (ec != error::address_in_use)
-        connect(hostname, port);
+    const auto unhandled = [](code, channel::ptr) {};
+    dispatch_delayed(backoff(state),
+        BIND5(retry_connect, _1, hostname, port, state, unhandled));
 }
 
 } // namespace network
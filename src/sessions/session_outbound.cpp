@@ -20,12 +20,19 @@
 
 #include <cstddef>
 #include <functional>
+#include <vector>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/network/p2p.hpp>
 #include <bitcoin/network/protocols/protocol_address_31402.hpp>
+#include <bitcoin/network/protocols/protocol_bloom_filter_70001.hpp>
+#include <bitcoin/network/protocols/protocol_compact_block_70014.hpp>
+#include <bitcoin/network/protocols/protocol_fee_filter_70013.hpp>
 #include <bitcoin/network/protocols/protocol_ping_31402.hpp>
 #include <bitcoin/network/protocols/protocol_ping_60001.hpp>
 #include <bitcoin/network/protocols/protocol_reject_70002.hpp>
+#include <bitcoin/network/protocols/protocol_relay_31402.hpp>
+#include <bitcoin/network/protocols/protocol_send_headers_70012.hpp>
+#include <bitcoin/network/protocols/protocol_stall_31402.hpp>
 #include <bitcoin/network/protocols/protocol_version_31402.hpp>
 #include <bitcoin/network/protocols/protocol_version_70002.hpp>
 
@@ -36,9 +43,14 @@ namespace network {
 
 using namespace std::placeholders;
 
+// Bip152 recommends high bandwidth compact block relay from at most 3 peers.
+static const size_t maximum_high_bandwidth = 3;
+
 session_outbound::session_outbound(p2p& network, bool notify_on_connect)
   : session_batch(network, notify_on_connect),
-    CONSTRUCT_TRACK(session_outbound)
+    CONSTRUCT_TRACK(session_outbound),
+    scheduler_(settings_.outbound_connections, settings_.connect_batch_size,
+        settings_.connect_backoff())
 {
 }
 
@@ -69,17 +81,176 @@ void session_outbound::handle_started(const code& ec, result_handler handler)
         return;
     }
 
-    for (size_t peer = 0; peer < settings_.outbound_connections; ++peer)
-        new_connection(error::success);
+    // Anchors (the outbound peers at the last stop) take the first slots.
+    const auto anchors = load_anchors();
+    const size_t slots = current_settings()->outbound_connections;
+    scheduler_.resize(slots);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    slots_.assign(slots, { true, nullptr, false });
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (size_t slot = 0; slot < slots; ++slot)
+    {
+        if (slot < anchors.size())
+            anchor_connection(anchors[slot], slot);
+        else
+            new_connection(error::success, slot);
+    }
 
     // This is the end of the start sequence.
     handler(error::success);
 }
 
+// Reload.
+// ----------------------------------------------------------------------------
+
+void session_outbound::reload()
+{
+    const size_t limit = current_settings()->outbound_connections;
+    std::vector<size_t> added;
+    std::vector<channel::ptr> removed;
+    scheduler_.resize(limit);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (slots_.size() < limit)
+        slots_.resize(limit, { false, nullptr, false });
+
+    for (size_t slot = 0; slot < slots_.size(); ++slot)
+    {
+        auto& state = slots_[slot];
+
+        if (slot < limit && !state.running)
+        {
+            state.running = true;
+            added.push_back(slot);
+        }
+        else if (slot >= limit && state.channel)
+        {
+            removed.push_back(state.channel);
+            state.channel.reset();
+            state.high_bandwidth = false;
+        }
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto channel: removed)
+        channel->stop(error::channel_stopped);
+
+    for (const auto slot: added)
+        new_connection(error::success, slot);
+}
+
+// private
+// A slot beyond the current limit stops its cycle, false if within it.
+bool session_outbound::retire(size_t slot)
+{
+    const size_t limit = current_settings()->outbound_connections;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slot < limit || slot >= slots_.size())
+        return false;
+
+    slots_[slot].running = false;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Record the channel of the slot, false if the slot is beyond the limit.
+bool session_outbound::retain(size_t slot, channel::ptr channel)
+{
+    const size_t limit = current_settings()->outbound_connections;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slot >= limit || slot >= slots_.size())
+        return false;
+
+    slots_[slot].channel = channel;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void session_outbound::release(size_t slot)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (slot < slots_.size())
+    {
+        slots_[slot].channel.reset();
+        slots_[slot].high_bandwidth = false;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Claim high bandwidth compact block relay for the channel, if under limit.
+bool session_outbound::claim_high_bandwidth(channel::ptr channel)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    size_t count = 0;
+    slot_state* owner = nullptr;
+
+    for (auto& state: slots_)
+    {
+        if (state.high_bandwidth)
+            ++count;
+
+        if (state.channel == channel)
+            owner = &state;
+    }
+
+    if (owner == nullptr || count >= maximum_high_bandwidth)
+        return false;
+
+    owner->high_bandwidth = true;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Scheduling.
+// ----------------------------------------------------------------------------
+
+size_t session_outbound::batch_size() const
+{
+    return scheduler_.batch_size();
+}
+
+hosts::groups session_outbound::excluded_groups() const
+{
+    return scheduler_.groups();
+}
+
+void session_outbound::attempted(const code& ec)
+{
+    scheduler_.attempted(!ec);
+}
+
 // Connnect cycle.
 // ----------------------------------------------------------------------------
+// Each slot is maintained independently, backing off while it fails.
 
-void session_outbound::new_connection(const code&)
+void session_outbound::new_connection(const code&, size_t slot)
 {
     if (stopped())
     {
@@ -88,28 +259,66 @@ void session_outbound::new_connection(const code&)
         return;
     }
 
-    session_batch::connect(BIND2(handle_connect, _1, _2));
+    if (retire(slot))
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Retired outbound connection slot (" << slot << ").";
+        return;
+    }
+
+    session_batch::connect(BIND3(handle_connect, _1, _2, slot));
 }
 
-void session_outbound::handle_connect(const code& ec, channel::ptr channel)
+// Retry after the slot's backoff, which grows with consecutive failures.
+void session_outbound::retry_connection(const code& ec, size_t slot)
+{
+    // Cancellation by shutdown does not reflect on the slot.
+    if (!stopped(ec))
+        scheduler_.failed(slot);
+
+    dispatch_delayed(scheduler_.delay(slot),
+        BIND2(new_connection, _1, slot));
+}
+
+// A failed anchor slot is retried from the pool by handle_connect.
+void session_outbound::anchor_connection(const authority& host, size_t slot)
+{
+    if (stopped())
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Suspended anchor connection.";
+        return;
+    }
+
+    LOG_DEBUG(LOG_NETWORK)
+        << "Connecting to anchor [" << host << "]";
+
+    session_batch::connect(host, BIND3(handle_connect, _1, _2, slot));
+}
+
+void session_outbound::handle_connect(const code& ec, channel::ptr channel,
+    size_t slot)
 {
     if (ec)
     {
         LOG_DEBUG(LOG_NETWORK)
             << "Failure connecting outbound: " << ec.message();
 
-        // Retry with conditional delay, regardless of error.
-        dispatch_delayed(cycle_delay(ec), BIND1(new_connection, _1));
+        // Retry with backoff, regardless of error.
+        retry_connection(ec, slot);
         return;
     }
 
+    // Outbound channels are saved as anchors on stop.
+    channel->set_outbound(true);
+
     register_channel(channel,
-        BIND2(handle_channel_start, _1, channel),
-        BIND2(handle_channel_stop, _1, channel));
+        BIND3(handle_channel_start, _1, channel, slot),
+        BIND3(handle_channel_stop, _1, channel, slot));
 }
 
 void session_outbound::handle_channel_start(const code& ec,
-    channel::ptr channel)
+    channel::ptr channel, size_t slot)
 {
     // The start failure is also caught by handle_channel_stop.
     if (ec)
@@ -117,9 +326,24 @@ void session_outbound::handle_channel_start(const code& ec,
         LOG_DEBUG(LOG_NETWORK)
             << "Outbound channel failed to start ["
             << channel->authority() << "] " << ec.message();
+
+        // A failed handshake counts against the slot, preventing a tight loop.
+        if (!stopped(ec))
+            scheduler_.failed(slot);
+
         return;
     }
 
+    // A slot removed by reload while connecting drops its channel.
+    if (!retain(slot, channel))
+    {
+        channel->stop(error::channel_stopped);
+        return;
+    }
+
+    // A started channel clears the slot's backoff and records its group.
+    scheduler_.connected(slot, channel->authority());
+
     LOG_INFO(LOG_NETWORK)
         << "Connected outbound channel [" << channel->authority() << "] ("
         << connection_count() << ")";
@@ -140,6 +364,27 @@ void session_outbound::attach_protocols(channel::ptr channel)
         attach<protocol_reject_70002>(channel)->start();
 
     attach<protocol_address_31402>(channel)->start();
+
+    // Filters are served only if the bloom service is advertised (bip111).
+    if (version >= message::version::level::bip37)
+        attach<protocol_bloom_filter_70001>(channel, (settings_.services &
+            message::version::service::node_bloom) != 0)->start();
+
+    attach<protocol_relay_31402>(channel)->start();
+    attach<protocol_stall_31402>(channel)->start();
+
+    if (version >= message::version::level::bip130)
+        attach<protocol_send_headers_70012>(channel)->start();
+
+    if (version >= message::version::level::bip133)
+        attach<protocol_fee_filter_70013>(channel)->start();
+
+    // Compact block relay requires a pool from the layer above.
+    const auto pool = compact_pool();
+
+    if (pool && version >= message::version::level::bip152)
+        attach<protocol_compact_block_70014>(channel, pool,
+            claim_high_bandwidth(channel))->start();
 }
 
 void session_outbound::attach_handshake_protocols(channel::ptr channel,
@@ -169,13 +414,16 @@ void session_outbound::attach_handshake_protocols(channel::ptr channel,
 }
 
 void session_outbound::handle_channel_stop(const code& ec,
-    channel::ptr channel)
+    channel::ptr channel, size_t slot)
 {
     LOG_DEBUG(LOG_NETWORK)
         << "Outbound channel stopped [" << channel->authority() << "] "
         << ec.message();
 
-    new_connection(error::success);
+    release(slot);
+    scheduler_.disconnected(slot);
+    dispatch_delayed(scheduler_.delay(slot),
+        BIND2(new_connection, _1, slot));
 }
 
 // Channel start sequence.
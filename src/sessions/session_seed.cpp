@@ -18,6 +18,7 @@
  */
 #include <bitcoin/network/sessions/session_seed.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <functional>
@@ -46,6 +47,14 @@ session_seed::session_seed(p2p& network)
 {
 }
 
+session_seed::race::race(size_t target, size_t seeds)
+  : target(target),
+    won(false),
+    connectors(seeds),
+    channels(seeds)
+{
+}
+
 // Start sequence.
 // ----------------------------------------------------------------------------
 
@@ -59,6 +68,12 @@ void session_seed::start(result_handler handler)
         return;
     }
 
+    // Resolve all seed names in parallel, overlapping session startup.
+    // Seed connections then share the cached or in-flight results.
+    if (settings_.prefetch_seeds && address_count() == 0)
+        for (const auto& seed: settings_.seeds)
+            resolve(seed, [](const code&, resolver_cache::endpoints_ptr){});
+
     session::start(CONCURRENT_DELEGATE2(handle_started, _1, handler));
 }
 
@@ -70,9 +85,13 @@ void session_seed::handle_started(const code& ec, result_handler handler)
         return;
     }
 
+    // Under fast start seeding tops up a small pool, concurrently with the
+    // outbound session, otherwise it only fills an empty pool.
+    const auto required = settings_.fast_start ?
+        std::max(settings_.fast_start_minimum_hosts, 1u) : 1u;
     const auto start_size = address_count();
 
-    if (start_size != 0)
+    if (start_size >= required)
     {
         LOG_DEBUG(LOG_NETWORK)
             << "Seeding is not required because there are "
@@ -120,19 +139,25 @@ void session_seed::attach_handshake_protocols(channel::ptr channel,
 // Seed sequence.
 // ----------------------------------------------------------------------------
 
+// Seeds race in parallel. Seeding completes once the pool reaches its target
+// (the remaining seeds are then canceled), or otherwise once all seeds end.
 void session_seed::start_seeding(size_t start_size, result_handler handler)
 {
-    const auto complete = BIND2(handle_complete, start_size, handler);
+    const auto seeds = settings_.seeds.size();
+    const auto racer = std::make_shared<race>(
+        ceiling_add(start_size, minimum_host_increase), seeds);
 
-    const auto join_handler = synchronize(complete, settings_.seeds.size(),
-        NAME, synchronizer_terminate::on_count);
+    const auto complete = BIND2(handle_complete, racer, handler);
+    const auto join_handler = synchronize(complete, seeds, NAME,
+        synchronizer_terminate::on_count);
 
     // We don't use parallel here because connect is itself asynchronous.
     for (const auto& seed: settings_.seeds)
-        start_seed(seed, join_handler);
+        start_seed(seed, racer,
+            BIND4(handle_seed, _1, racer, join_handler, handler));
 }
 
-void session_seed::start_seed(const config::endpoint& seed,
+void session_seed::start_seed(const config::endpoint& seed, race_ptr racer,
     result_handler handler)
 {
     if (stopped())
@@ -149,15 +174,24 @@ void session_seed::start_seed(const config::endpoint& seed,
     const auto connector = create_connector();
     pend(connector);
 
+    // The race is stopped once won, which cancels this connection.
+    if (racer->connectors.store(connector))
+    {
+        unpend(connector);
+        handler(error::channel_stopped);
+        return;
+    }
+
     // OUTBOUND CONNECT
     connector->connect(seed,
-        BIND5(handle_connect, _1, _2, seed, connector, handler));
+        BIND6(handle_connect, _1, _2, seed, connector, racer, handler));
 }
 
 void session_seed::handle_connect(const code& ec, channel::ptr channel,
-    const config::endpoint& seed, connector::ptr connector,
+    const config::endpoint& seed, connector::ptr connector, race_ptr racer,
     result_handler handler)
 {
+    racer->connectors.remove(connector);
     unpend(connector);
 
     if (ec)
@@ -177,12 +211,20 @@ void session_seed::handle_connect(const code& ec, channel::ptr channel,
         return;
     }
 
+    // The race may have been won while this seed was connecting.
+    if (racer->channels.store(channel))
+    {
+        channel->stop(error::channel_stopped);
+        handler(error::channel_stopped);
+        return;
+    }
+
     LOG_INFO(LOG_NETWORK)
         << "Connected seed [" << seed << "] as " << channel->authority();
 
     register_channel(channel,
         BIND3(handle_channel_start, _1, channel, handler),
-        BIND1(handle_channel_stop, _1));
+        BIND3(handle_channel_stop, _1, channel, racer));
 }
 
 void session_seed::handle_channel_start(const code& ec, channel::ptr channel,
@@ -213,18 +255,44 @@ void session_seed::attach_protocols(channel::ptr channel,
     attach<protocol_seed_31402>(channel)->start(handler);
 }
 
-void session_seed::handle_channel_stop(const code& ec)
+void session_seed::handle_channel_stop(const code& ec, channel::ptr channel,
+    race_ptr racer)
 {
+    racer->channels.remove(channel);
+
     LOG_DEBUG(LOG_NETWORK)
         << "Seed channel stopped: " << ec.message();
 }
 
+// Each seed ends here, the first to reach the target completes seeding.
+void session_seed::handle_seed(const code& ec, race_ptr racer,
+    result_handler join, result_handler handler)
+{
+    if (!racer->won && address_count() >= racer->target &&
+        !racer->won.exchange(true))
+    {
+        LOG_INFO(LOG_NETWORK)
+            << "Seeding target reached, canceling remaining seeds.";
+
+        racer->connectors.stop(error::channel_stopped);
+        racer->channels.stop(error::channel_stopped);
+
+        // This is the end of the seed sequence.
+        handler(error::success);
+    }
+
+    join(ec);
+}
+
 // This accepts no error code because individual seed errors are suppressed.
-void session_seed::handle_complete(size_t start_size, result_handler handler)
+void session_seed::handle_complete(race_ptr racer, result_handler handler)
 {
+    // Seeding has already completed if the target was reached.
+    if (racer->won.exchange(true))
+        return;
+
     // We succeed only if there is a host count increase of at least 100.
-    const auto increase = address_count() >=
-        ceiling_add(start_size, minimum_host_increase);
+    const auto increase = address_count() >= racer->target;
 
     // This is the end of the seed sequence.
     handler(increase ? error::success : error::peer_throttling);
@@ -30,25 +30,71 @@ using namespace bc::message;
 // Common default values (no settings context).
 settings::settings()
   : threads(0),
+    thread_affinity(false),
+    work_stealing_threads(0),
     protocol_maximum(version::level::maximum),
     protocol_minimum(version::level::minimum),
     services(version::service::none),
     invalid_services(160),
     relay_transactions(false),
     validate_checksum(false),
+    validate_unsubscribed(false),
     inbound_connections(0),
+    inbound_listeners(1),
+    inbound_backlog(0),
+    inbound_address_rate_per_minute(0),
+    inbound_subnet_rate_per_minute(0),
+    inbound_handshake_limit(0),
+    tcp_no_delay(false),
+    tcp_keepalive(false),
+    tcp_quick_ack(false),
+    tcp_not_sent_low_water(0),
+    ip_type_of_service(0),
+    socket_receive_buffer(0),
+    socket_send_buffer(0),
+    upload_rate_limit(0),
+    download_rate_limit(0),
+    channel_upload_rate_limit(0),
+    channel_download_rate_limit(0),
     outbound_connections(8),
     manual_attempt_limit(0),
+    manual_backoff_base_milliseconds(1000),
+    manual_backoff_maximum_seconds(300),
     connect_batch_size(5),
+    connect_batch_delay_milliseconds(250),
+    connect_backoff_seconds(300),
+    resolve_cache_seconds(300),
+    prefetch_seeds(true),
+    fast_start(false),
+    fast_start_minimum_hosts(100),
     connect_timeout_seconds(5),
     channel_handshake_seconds(30),
     channel_heartbeat_minutes(5),
     channel_inactivity_minutes(10),
     channel_expiration_minutes(60),
     channel_germination_seconds(30),
+    channel_latency_limit_milliseconds(0),
+    send_coalesce_milliseconds(0),
+    relay_trickle_milliseconds(5000),
+    relay_known_inventory(50000),
+    minimum_fee_filter(0),
+    request_window_minimum(1),
+    request_window_maximum(16),
+    request_timeout_minimum_seconds(2),
+    request_timeout_maximum_seconds(60),
+    request_stall_disconnect(true),
+    send_queue_message_limit(10000),
+    send_queue_byte_limit(32 * 1024 * 1024),
+    send_queue_overflow(overflow_policy::drop),
     host_pool_capacity(0),
+    host_pool_flush_seconds(300),
+    address_cache_minutes(60),
     hosts_file("hosts.cache"),
+    anchors_file("anchors.cache"),
+    anchor_connections(8),
+    hosts_file_text(false),
     self(unspecified_network_address),
+    ban_misbehaving(false),
 
     // [log]
     debug_file("debug.log"),
@@ -59,6 +105,8 @@ settings::settings()
     maximum_archive_size(0),
     maximum_archive_files(0),
     statistics_server(unspecified_network_address),
+    statistics_interval_seconds(10),
+    capture_buffer_bytes(4 * 1024 * 1024),
     verbose(false)
 {
 }
@@ -128,6 +176,31 @@ duration settings::connect_timeout() const
     return seconds(connect_timeout_seconds);
 }
 
+duration settings::connect_batch_delay() const
+{
+    return milliseconds(connect_batch_delay_milliseconds);
+}
+
+duration settings::connect_backoff() const
+{
+    return seconds(connect_backoff_seconds);
+}
+
+duration settings::manual_backoff_base() const
+{
+    return milliseconds(manual_backoff_base_milliseconds);
+}
+
+duration settings::manual_backoff_maximum() const
+{
+    return seconds(manual_backoff_maximum_seconds);
+}
+
+duration settings::resolve_cache() const
+{
+    return seconds(resolve_cache_seconds);
+}
+
 duration settings::channel_handshake() const
 {
     return seconds(channel_handshake_seconds);
@@ -153,5 +226,45 @@ duration settings::channel_germination() const
     return seconds(channel_germination_seconds);
 }
 
+duration settings::channel_latency_limit() const
+{
+    return milliseconds(channel_latency_limit_milliseconds);
+}
+
+duration settings::send_coalesce() const
+{
+    return milliseconds(send_coalesce_milliseconds);
+}
+
+duration settings::relay_trickle() const
+{
+    return milliseconds(relay_trickle_milliseconds);
+}
+
+duration settings::request_timeout_minimum() const
+{
+    return seconds(request_timeout_minimum_seconds);
+}
+
+duration settings::request_timeout_maximum() const
+{
+    return seconds(request_timeout_maximum_seconds);
+}
+
+duration settings::host_pool_flush() const
+{
+    return seconds(host_pool_flush_seconds);
+}
+
+duration settings::address_cache() const
+{
+    return minutes(address_cache_minutes);
+}
+
+duration settings::statistics_interval() const
+{
+    return seconds(statistics_interval_seconds);
+}
+
 } // namespace network
 } // namespace libbitcoin
@@ -0,0 +1,86 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/socket_options.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace boost::asio::detail::socket_option;
+
+socket_options::socket_options(const settings& settings)
+  : no_delay_(settings.tcp_no_delay),
+    keepalive_(settings.tcp_keepalive),
+    quick_ack_(settings.tcp_quick_ack),
+    receive_buffer_(settings.socket_receive_buffer),
+    send_buffer_(settings.socket_send_buffer),
+    not_sent_low_water_(settings.tcp_not_sent_low_water),
+    type_of_service_(settings.ip_type_of_service)
+{
+}
+
+// The receive buffer of an outbound socket is set after the handshake, so it
+// may not be reflected in the window scale (listeners set it before).
+void socket_options::apply(asio::socket& socket) const
+{
+    boost_code ignored;
+
+    if (no_delay_)
+        socket.set_option(asio::tcp::no_delay(true), ignored);
+
+    if (keepalive_)
+        socket.set_option(asio::socket::keep_alive(true), ignored);
+
+    if (receive_buffer_ != 0)
+        socket.set_option(asio::socket::receive_buffer_size(
+            receive_buffer_), ignored);
+
+    if (send_buffer_ != 0)
+        socket.set_option(asio::socket::send_buffer_size(send_buffer_),
+            ignored);
+
+// Quick ack is not sticky on linux, so this covers the early exchanges.
+#ifdef TCP_QUICKACK
+    if (quick_ack_)
+        socket.set_option(boolean<IPPROTO_TCP, TCP_QUICKACK>(true), ignored);
+#endif
+
+// Limits unsent data in the kernel, so queued messages stay reorderable.
+#ifdef TCP_NOTSENT_LOWAT
+    if (not_sent_low_water_ != 0)
+        socket.set_option(integer<IPPROTO_TCP, TCP_NOTSENT_LOWAT>(
+            not_sent_low_water_), ignored);
+#endif
+
+    // The socket may be of either family, so both are set.
+    if (type_of_service_ != 0)
+    {
+        socket.set_option(integer<IPPROTO_IP, IP_TOS>(type_of_service_),
+            ignored);
+#ifdef IPV6_TCLASS
+        socket.set_option(integer<IPPROTO_IPV6, IPV6_TCLASS>(
+            type_of_service_), ignored);
+#endif
+    }
+}
+
+} // namespace network
+} // namespace libbitcoin
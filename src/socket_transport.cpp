@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/socket_transport.hpp>
+
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+socket_transport::socket_transport(socket::ptr socket)
+  : socket_(socket)
+{
+}
+
+config::authority socket_transport::authority() const
+{
+    return socket_->authority();
+}
+
+void socket_transport::read_some(const boost::asio::mutable_buffer& buffer,
+    io_handler handler)
+{
+    socket_->get().async_read_some(boost::asio::mutable_buffers_1(buffer),
+        handler);
+}
+
+void socket_transport::read(const boost::asio::mutable_buffer& buffer,
+    io_handler handler)
+{
+    boost::asio::async_read(socket_->get(),
+        boost::asio::mutable_buffers_1(buffer), handler);
+}
+
+void socket_transport::write(const const_buffers& buffers,
+    io_handler handler)
+{
+    boost::asio::async_write(socket_->get(), buffers, handler);
+}
+
+void socket_transport::stop()
+{
+    socket_->stop();
+}
+
+} // namespace network
+} // namespace libbitcoin
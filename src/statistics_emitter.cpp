@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/statistics_emitter.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <boost/asio.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/network/channel_metrics.hpp>
+#include <bitcoin/network/settings.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// Gauge names are qualified by this prefix.
+static const std::string prefix = "bitcoin.network.";
+
+// Datagrams are kept below the minimum reassembly size of ipv4.
+static const size_t maximum_datagram = 512;
+
+statistics_emitter::statistics_emitter(threadpool& pool,
+    const settings& settings)
+  : enabled_(settings.statistics_server.port() != 0),
+    server_(settings.statistics_server.asio_ip(),
+        settings.statistics_server.port()),
+    socket_(pool.service())
+{
+}
+
+bool statistics_emitter::enabled() const
+{
+    return enabled_;
+}
+
+// Types without traffic are omitted, as all gauges are cumulative.
+void statistics_emitter::emit(const channel_metrics::snapshot& metrics,
+    size_t connections)
+{
+    if (!enabled_)
+        return;
+
+    if (!socket_.is_open())
+    {
+        boost_code ec;
+        socket_.open(server_.protocol(), ec);
+
+        if (ec)
+        {
+            LOG_DEBUG(LOG_NETWORK)
+                << "Failure opening statistics socket: " << ec.message();
+            return;
+        }
+    }
+
+    add("connections", connections);
+    add("ping.count", metrics.pings);
+    add("ping.microseconds", metrics.ping_microseconds);
+
+    const auto& commands = channel_metrics::commands();
+
+    for (size_t index = 0; index < commands.size(); ++index)
+    {
+        const auto& type = metrics.types[index];
+
+        if (type.messages_in == 0 && type.messages_out == 0)
+            continue;
+
+        const auto name = commands[index] + ".";
+        add(name + "messages_in", type.messages_in);
+        add(name + "bytes_in", type.bytes_in);
+        add(name + "parse_microseconds", type.parse_microseconds);
+        add(name + "messages_out", type.messages_out);
+        add(name + "bytes_out", type.bytes_out);
+        add(name + "send_wait_microseconds", type.send_wait_microseconds);
+    }
+
+    flush();
+}
+
+// private
+void statistics_emitter::add(const std::string& name, uint64_t value)
+{
+    const auto line = prefix + name + ":" + std::to_string(value) + "|g\n";
+
+    if (datagram_.size() + line.size() > maximum_datagram)
+        flush();
+
+    datagram_ += line;
+}
+
+// private
+void statistics_emitter::flush()
+{
+    if (datagram_.empty())
+        return;
+
+    boost_code ec;
+    socket_.send_to(boost::asio::buffer(datagram_), server_, 0, ec);
+    datagram_.clear();
+
+    if (ec)
+    {
+        LOG_DEBUG(LOG_NETWORK)
+            << "Failure sending statistics: " << ec.message();
+    }
+}
+
+} // namespace network
+} // namespace libbitcoin
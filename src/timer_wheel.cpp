@@ -0,0 +1,199 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/timer_wheel.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+using namespace std::placeholders;
+
+timer_wheel::timer_wheel(threadpool& pool, const asio::duration& resolution,
+    size_t slots)
+  : resolution_(resolution),
+    timer_(std::make_shared<deadline>(pool, resolution)),
+    stopped_(true),
+    next_token_(0),
+    current_(0),
+    slots_(std::max(slots, size_t(1)))
+{
+}
+
+void timer_wheel::start()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    if (!stopped_)
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    stopped_ = false;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    start_tick();
+}
+
+void timer_wheel::stop()
+{
+    entries dropped;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    stopped_ = true;
+    dropped.swap(entries_);
+
+    for (auto& slot: slots_)
+        slot.clear();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    timer_->stop();
+
+    // Handlers (and their bound objects) are released outside of the lock.
+    dropped.clear();
+}
+
+// Delays are rounded up to whole ticks, counted from the next tick, which
+// may be imminent. One tick is added for it, so a handler never fires early.
+timer_wheel::token timer_wheel::schedule(const asio::duration& delay,
+    timeout_handler handler)
+{
+    const auto period = resolution_.count();
+    const auto ticks = static_cast<size_t>(
+        (delay.count() + period - 1) / period) + 1;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    const auto id = ++next_token_;
+
+    if (stopped_)
+        return id;
+
+    const auto slot = (current_ + ticks) % slots_.size();
+    const auto rounds = (ticks - 1) / slots_.size();
+    entries_.emplace(id, entry{ rounds, std::move(handler) });
+    slots_[slot].push_back(id);
+    return id;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The token remains in its slot and is skipped when the slot is processed.
+void timer_wheel::cancel(token id)
+{
+    // The handler is released outside of the lock.
+    timeout_handler released;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    const auto it = entries_.find(id);
+
+    if (it != entries_.end())
+    {
+        released = std::move(it->second.handler);
+        entries_.erase(it);
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void timer_wheel::start_tick()
+{
+    timer_->start(
+        std::bind(&timer_wheel::handle_tick,
+            this, _1));
+}
+
+// private
+void timer_wheel::handle_tick(const code& ec)
+{
+    std::vector<timeout_handler> expired;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (stopped_ || ec)
+    {
+        mutex_.unlock();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    current_ = (current_ + 1) % slots_.size();
+    auto& slot = slots_[current_];
+    std::vector<token> remaining;
+
+    for (const auto id: slot)
+    {
+        const auto it = entries_.find(id);
+
+        // Canceled.
+        if (it == entries_.end())
+            continue;
+
+        if (it->second.rounds > 0)
+        {
+            --it->second.rounds;
+            remaining.push_back(id);
+            continue;
+        }
+
+        expired.push_back(std::move(it->second.handler));
+        entries_.erase(it);
+    }
+
+    slot.swap(remaining);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Handlers may schedule or cancel, so are invoked outside of the lock.
+    for (const auto& handler: expired)
+        handler(error::success);
+
+    start_tick();
+}
+
+} // namespace network
+} // namespace libbitcoin
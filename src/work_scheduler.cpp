@@ -0,0 +1,295 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/network/work_scheduler.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace network {
+
+// The most jobs a serial runs before yielding its worker to other serials.
+static const size_t serial_batch = 16;
+
+// Idle workers wake at this interval to recheck for stealable work.
+static const std::chrono::milliseconds idle_interval(10);
+
+// Serial.
+// ----------------------------------------------------------------------------
+
+work_scheduler::serial::serial(work_scheduler& scheduler, size_t home)
+  : scheduler_(scheduler),
+    home_(home),
+    running_(false),
+    stopped_(false)
+{
+}
+
+void work_scheduler::serial::post(job&& work)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (stopped_)
+    {
+        mutex_.unlock();
+        return;
+    }
+
+    jobs_.push_back(std::move(work));
+    const auto start = !running_;
+    running_ = true;
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Only one run is scheduled at a time, which retains the posted order.
+    if (start)
+        scheduler_.post(home_,
+            std::bind(&serial::run, shared_from_this()));
+}
+
+void work_scheduler::serial::stop()
+{
+    std::deque<job> dropped;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    stopped_ = true;
+    dropped.swap(jobs_);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+void work_scheduler::serial::run()
+{
+    for (size_t count = 0; count < serial_batch; ++count)
+    {
+        job work;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock();
+
+        if (jobs_.empty())
+        {
+            running_ = false;
+            mutex_.unlock();
+            return;
+        }
+
+        work = std::move(jobs_.front());
+        jobs_.pop_front();
+
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        work();
+    }
+
+    // The serial remains running, so no other run can be scheduled.
+    scheduler_.post(home_, std::bind(&serial::run, shared_from_this()));
+}
+
+// Scheduler.
+// ----------------------------------------------------------------------------
+
+work_scheduler::work_scheduler(size_t workers)
+  : workers_(workers),
+    next_(0),
+    queued_(0),
+    stopped_(true)
+{
+    for (size_t index = 0; index < workers_; ++index)
+        queues_.emplace_back(new worker_queue);
+}
+
+work_scheduler::~work_scheduler()
+{
+    shutdown();
+    join();
+}
+
+bool work_scheduler::enabled() const
+{
+    return workers_ != 0;
+}
+
+work_scheduler::serial::ptr work_scheduler::make_serial()
+{
+    const auto home = enabled() ? next_++ % workers_ : 0;
+    return std::make_shared<serial>(*this, home);
+}
+
+void work_scheduler::post(size_t home, job&& work)
+{
+    if (stopped_ || !enabled())
+        return;
+
+    auto& queue = *queues_[home % workers_];
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    queue.mutex.lock();
+    queue.jobs.push_back(std::move(work));
+    ++queued_;
+    queue.mutex.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Taking the idle mutex orders the notify after any waiter's recheck.
+    { std::lock_guard<std::mutex> idle(idle_mutex_); }
+    idle_.notify_one();
+}
+
+void work_scheduler::spawn()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(thread_mutex_);
+
+    if (!stopped_ || !enabled())
+        return;
+
+    stopped_ = false;
+
+    for (size_t index = 0; index < workers_; ++index)
+        threads_.emplace_back(&work_scheduler::work, this, index);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void work_scheduler::shutdown()
+{
+    stopped_ = true;
+
+    { std::lock_guard<std::mutex> idle(idle_mutex_); }
+    idle_.notify_all();
+}
+
+void work_scheduler::join()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(thread_mutex_);
+
+    for (auto& thread: threads_)
+        if (thread.joinable() && thread.get_id() != std::this_thread::get_id())
+            thread.join();
+
+    threads_.clear();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Dropped jobs release the channels that they retain.
+    clear();
+}
+
+// private
+// The owner takes the newest job, which is most likely to be cache resident.
+bool work_scheduler::pop(size_t index, job& out)
+{
+    auto& queue = *queues_[index];
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(queue.mutex);
+
+    if (queue.jobs.empty())
+        return false;
+
+    out = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    --queued_;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// A thief takes the oldest job of the first other queue that has one.
+bool work_scheduler::steal(size_t index, job& out)
+{
+    for (size_t offset = 1; offset < workers_; ++offset)
+    {
+        auto& queue = *queues_[(index + offset) % workers_];
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        unique_lock lock(queue.mutex);
+
+        if (queue.jobs.empty())
+            continue;
+
+        out = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        --queued_;
+        return true;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return false;
+}
+
+// private
+void work_scheduler::work(size_t index)
+{
+    while (!stopped_)
+    {
+        job next;
+
+        if (pop(index, next) || steal(index, next))
+        {
+            next();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> idle(idle_mutex_);
+        idle_.wait_for(idle, idle_interval, [this]()
+        {
+            return stopped_ || queued_ != 0;
+        });
+    }
+}
+
+// private
+void work_scheduler::clear()
+{
+    for (auto& queue: queues_)
+    {
+        std::deque<job> dropped;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        queue->mutex.lock();
+        dropped.swap(queue->jobs);
+        queued_ -= dropped.size();
+        queue->mutex.unlock();
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+} // namespace network
+} // namespace libbitcoin
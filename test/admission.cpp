@@ -0,0 +1,153 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::config;
+using namespace bc::network;
+
+static network::settings make_settings(uint32_t address_rate,
+    uint32_t subnet_rate, uint32_t handshakes)
+{
+    network::settings configuration;
+    configuration.inbound_address_rate_per_minute = address_rate;
+    configuration.inbound_subnet_rate_per_minute = subnet_rate;
+    configuration.inbound_handshake_limit = handshakes;
+    return configuration;
+}
+
+static authority make_authority(const std::string& ip)
+{
+    return authority(ip + ":8333");
+}
+
+BOOST_AUTO_TEST_SUITE(admission_tests)
+
+BOOST_AUTO_TEST_CASE(admission__admit__unlimited__success)
+{
+    const auto configuration = make_settings(0, 0, 0);
+    blacklist list(configuration);
+    admission instance(list, configuration);
+
+    for (size_t count = 0; count < 100; ++count)
+        BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+            error::success);
+}
+
+BOOST_AUTO_TEST_CASE(admission__admit__blacklisted__address_blocked)
+{
+    const auto configuration = make_settings(0, 0, 0);
+    blacklist list(configuration);
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(blacklist::parse("10.0.0.0/24", ip, prefix));
+    list.insert(ip, prefix);
+    admission instance(list, configuration);
+
+    BOOST_REQUIRE(instance.blacklisted(make_authority("10.0.0.1")));
+    BOOST_REQUIRE(!instance.blacklisted(make_authority("10.0.1.1")));
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::address_blocked);
+}
+
+BOOST_AUTO_TEST_CASE(admission__admit__beyond_address_rate__throttled)
+{
+    const auto configuration = make_settings(2, 0, 0);
+    blacklist list(configuration);
+    admission instance(list, configuration);
+
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::peer_throttling);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.2")),
+        error::success);
+}
+
+BOOST_AUTO_TEST_CASE(admission__admit__beyond_subnet_rate__throttled)
+{
+    const auto configuration = make_settings(0, 2, 0);
+    blacklist list(configuration);
+    admission instance(list, configuration);
+
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.2")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.3")),
+        error::peer_throttling);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.1.1")),
+        error::success);
+}
+
+BOOST_AUTO_TEST_CASE(admission__admit__address_throttled__subnet_not_consumed)
+{
+    const auto configuration = make_settings(1, 2, 0);
+    blacklist list(configuration);
+    admission instance(list, configuration);
+
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::peer_throttling);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.2")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.3")),
+        error::peer_throttling);
+}
+
+BOOST_AUTO_TEST_CASE(admission__admit__handshake_limit__throttled_to_release)
+{
+    const auto configuration = make_settings(0, 0, 1);
+    blacklist list(configuration);
+    admission instance(list, configuration);
+
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.1")),
+        error::success);
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.2")),
+        error::peer_throttling);
+    instance.release();
+    BOOST_REQUIRE_EQUAL(instance.admit(make_authority("10.0.0.2")),
+        error::success);
+}
+
+BOOST_AUTO_TEST_CASE(admission__admit__many_addresses__bounded_and_admitted)
+{
+    const auto configuration = make_settings(1, 0, 0);
+    blacklist list(configuration);
+    admission instance(list, configuration);
+
+    // Each novel address has a full bucket however many buckets are evicted.
+    for (uint32_t value = 0; value < 20000; ++value)
+    {
+        const auto ip = "10." + std::to_string((value >> 16) & 0xff) + "." +
+            std::to_string((value >> 8) & 0xff) + "." +
+            std::to_string(value & 0xff);
+
+        BOOST_REQUIRE_EQUAL(instance.admit(make_authority(ip)),
+            error::success);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
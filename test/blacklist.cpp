@@ -0,0 +1,159 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+// Addresses are matched in the ipv6 form, ipv4 is mapped.
+static asio::ipv6 to_ip(const std::string& text)
+{
+    const auto ip = boost::asio::ip::address::from_string(text);
+    return ip.is_v4() ? asio::ipv6::v4_mapped(ip.to_v4()) : ip.to_v6();
+}
+
+static bool contains(const std::string& subnet, const std::string& address)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(blacklist::parse(subnet, ip, prefix));
+
+    const network::settings configuration;
+    blacklist list(configuration);
+    list.insert(ip, prefix);
+    return list.contains(to_ip(address));
+}
+
+BOOST_AUTO_TEST_SUITE(blacklist_tests)
+
+// parse
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__ipv4_address__mapped_128)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(blacklist::parse("10.1.2.3", ip, prefix));
+    BOOST_REQUIRE(ip == to_ip("10.1.2.3"));
+    BOOST_REQUIRE_EQUAL(prefix, 128u);
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__ipv4_subnet__mapped_96_plus_prefix)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(blacklist::parse("10.1.0.0/16", ip, prefix));
+    BOOST_REQUIRE(ip == to_ip("10.1.0.0"));
+    BOOST_REQUIRE_EQUAL(prefix, 112u);
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__ipv6_address__128)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(blacklist::parse("2001:db8::1", ip, prefix));
+    BOOST_REQUIRE(ip == to_ip("2001:db8::1"));
+    BOOST_REQUIRE_EQUAL(prefix, 128u);
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__ipv6_subnet__prefix)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(blacklist::parse("2001:db8::/32", ip, prefix));
+    BOOST_REQUIRE(ip == to_ip("2001:db8::"));
+    BOOST_REQUIRE_EQUAL(prefix, 32u);
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__missing_prefix__false)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(!blacklist::parse("10.0.0.0/", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("2001:db8::/", ip, prefix));
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__oversize_prefix__false)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(!blacklist::parse("10.0.0.0/33", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("2001:db8::/129", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("2001:db8::/1000", ip, prefix));
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__parse__garbage__false)
+{
+    asio::ipv6 ip;
+    uint8_t prefix;
+    BOOST_REQUIRE(!blacklist::parse("", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("banana", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("10.0.0/8", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("10.0.0.0/ab", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("10.0.0.0/-1", ip, prefix));
+    BOOST_REQUIRE(!blacklist::parse("10.0.0.0/8/8", ip, prefix));
+}
+
+// contains
+
+BOOST_AUTO_TEST_CASE(blacklist__contains__prefix_0__all)
+{
+    BOOST_REQUIRE(contains("::/0", "2001:db8::1"));
+    BOOST_REQUIRE(contains("::/0", "1.2.3.4"));
+    BOOST_REQUIRE(contains("0.0.0.0/0", "255.255.255.255"));
+    BOOST_REQUIRE(!contains("0.0.0.0/0", "2001:db8::1"));
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__contains__prefix_7__partial_byte)
+{
+    BOOST_REQUIRE(contains("10.0.0.0/7", "10.0.0.1"));
+    BOOST_REQUIRE(contains("10.0.0.0/7", "11.255.255.255"));
+    BOOST_REQUIRE(!contains("10.0.0.0/7", "9.255.255.255"));
+    BOOST_REQUIRE(!contains("10.0.0.0/7", "12.0.0.0"));
+    BOOST_REQUIRE(contains("fc00::/7", "fd00::1"));
+    BOOST_REQUIRE(!contains("fc00::/7", "fe00::1"));
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__contains__prefix_24__subnet)
+{
+    BOOST_REQUIRE(contains("192.168.1.0/24", "192.168.1.0"));
+    BOOST_REQUIRE(contains("192.168.1.0/24", "192.168.1.255"));
+    BOOST_REQUIRE(!contains("192.168.1.0/24", "192.168.2.0"));
+    BOOST_REQUIRE(!contains("192.168.1.0/24", "192.168.0.255"));
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__contains__prefix_32__address)
+{
+    BOOST_REQUIRE(contains("192.168.1.1/32", "192.168.1.1"));
+    BOOST_REQUIRE(!contains("192.168.1.1/32", "192.168.1.2"));
+    BOOST_REQUIRE(contains("2001:db8::/32", "2001:db8:ffff::1"));
+    BOOST_REQUIRE(!contains("2001:db8::/32", "2001:db9::1"));
+}
+
+BOOST_AUTO_TEST_CASE(blacklist__contains__prefix_128__address)
+{
+    BOOST_REQUIRE(contains("2001:db8::1/128", "2001:db8::1"));
+    BOOST_REQUIRE(!contains("2001:db8::1/128", "2001:db8::2"));
+    BOOST_REQUIRE(contains("10.0.0.1", "10.0.0.1"));
+    BOOST_REQUIRE(!contains("10.0.0.1", "10.0.0.2"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,183 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+using namespace bc::message;
+using namespace bc::network;
+
+static data_chunk base16(const std::string& text)
+{
+    data_chunk out;
+    BOOST_REQUIRE(decode_base16(out, text));
+    return out;
+}
+
+static filter_load empty_filter(uint8_t flags)
+{
+    return filter_load(data_chunk(64, 0x00), 5, 42, flags);
+}
+
+// A transaction paying to a script that pushes the element.
+static transaction funding(const data_chunk& element, uint32_t locktime)
+{
+    const script pay(operation::list{ operation(element) });
+    return transaction(1, locktime, {}, { output(42, pay) });
+}
+
+static transaction spending(const transaction& funded)
+{
+    const input spend(output_point(funded.hash(), 0), script(), 0);
+    return transaction(1, 0, { spend }, {});
+}
+
+BOOST_AUTO_TEST_SUITE(bloom_filter_tests)
+
+// murmur3
+
+// These are the bip37 murmur3 vectors.
+BOOST_AUTO_TEST_CASE(bloom_filter__murmur3__bip37_vectors__expected)
+{
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000, base16("")),
+        0x00000000u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0xfba4c795, base16("")),
+        0x6a396f08u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0xffffffff, base16("")),
+        0x81f16f39u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000, base16("00")),
+        0x514e28b7u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0xfba4c795, base16("00")),
+        0xea3f0b17u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000, base16("ff")),
+        0xfd6cf10du);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("0011")), 0x16c6b7abu);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("001122")), 0x8eb51c3du);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("00112233")), 0xb4471bf8u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("0011223344")), 0xe2301fa8u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("001122334455")), 0xfc2e4a15u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("00112233445566")), 0xb074502cu);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("0011223344556677")), 0x8034d2a0u);
+    BOOST_REQUIRE_EQUAL(bloom_filter::murmur3(0x00000000,
+        base16("001122334455667788")), 0xb4698defu);
+}
+
+// insert/contains
+
+BOOST_AUTO_TEST_CASE(bloom_filter__contains__inserted__true)
+{
+    bloom_filter filter(empty_filter(bloom_filter::update::none));
+    const auto element = base16("99108ad8ed9bb6274d3980bab5a85c048f0950c8");
+    BOOST_REQUIRE(!filter.contains(element));
+    filter.insert(element);
+    BOOST_REQUIRE(filter.contains(element));
+}
+
+// matches
+
+BOOST_AUTO_TEST_CASE(bloom_filter__matches__update_all_spend__true)
+{
+    bloom_filter filter(empty_filter(bloom_filter::update::all));
+    const auto element = base16("99108ad8ed9bb6274d3980bab5a85c048f0950c8");
+    filter.insert(element);
+
+    const auto fund = funding(element, 0);
+    const auto spend = spending(fund);
+
+    // The spend does not match until its funding transaction has matched.
+    BOOST_REQUIRE(!filter.matches(spend));
+    BOOST_REQUIRE(filter.matches(fund));
+    BOOST_REQUIRE(filter.matches(spend));
+}
+
+BOOST_AUTO_TEST_CASE(bloom_filter__matches__update_none_spend__false)
+{
+    bloom_filter filter(empty_filter(bloom_filter::update::none));
+    const auto element = base16("99108ad8ed9bb6274d3980bab5a85c048f0950c8");
+    filter.insert(element);
+
+    const auto fund = funding(element, 0);
+    BOOST_REQUIRE(filter.matches(fund));
+    BOOST_REQUIRE(!filter.matches(spending(fund)));
+}
+
+// filter
+
+BOOST_AUTO_TEST_CASE(bloom_filter__filter__one_transaction__root_only)
+{
+    bloom_filter filter(empty_filter(bloom_filter::update::none));
+    const auto element = base16("00112233");
+    filter.insert(element);
+
+    const auto tx = funding(element, 0);
+    std::vector<size_t> matched;
+    const block block(header(), { tx });
+    const auto merkle = filter.filter(block, matched);
+
+    BOOST_REQUIRE_EQUAL(merkle.total_transactions(), 1u);
+    BOOST_REQUIRE_EQUAL(merkle.hashes().size(), 1u);
+    BOOST_REQUIRE(merkle.hashes()[0] == tx.hash());
+    BOOST_REQUIRE(merkle.flags() == data_chunk{ 0x01 });
+    BOOST_REQUIRE_EQUAL(matched.size(), 1u);
+}
+
+// The bip37 partial merkle tree of three transactions matching the second:
+// the root and left node are parents of the match (1, 1), the left leaves
+// are included (0, 1) and the right node is pruned (0), packed as 0b01011.
+BOOST_AUTO_TEST_CASE(bloom_filter__filter__three_transactions_second__bip37)
+{
+    bloom_filter filter(empty_filter(bloom_filter::update::none));
+    const auto element = base16("00112233");
+    filter.insert(element);
+
+    const auto tx0 = funding(base16("00"), 0);
+    const auto tx1 = funding(element, 1);
+    const auto tx2 = funding(base16("00"), 2);
+    std::vector<size_t> matched;
+    const block block(header(), { tx0, tx1, tx2 });
+    const auto merkle = filter.filter(block, matched);
+
+    const auto right = bitcoin_hash(build_chunk({ tx2.hash(), tx2.hash() }));
+    const auto left = bitcoin_hash(build_chunk({ tx0.hash(), tx1.hash() }));
+    const auto root = bitcoin_hash(build_chunk({ left, right }));
+
+    BOOST_REQUIRE_EQUAL(merkle.total_transactions(), 3u);
+    BOOST_REQUIRE_EQUAL(merkle.hashes().size(), 3u);
+    BOOST_REQUIRE(merkle.hashes()[0] == tx0.hash());
+    BOOST_REQUIRE(merkle.hashes()[1] == tx1.hash());
+    BOOST_REQUIRE(merkle.hashes()[2] == right);
+    BOOST_REQUIRE(merkle.flags() == data_chunk{ 0x0b });
+    BOOST_REQUIRE(root == block.generate_merkle_root());
+    BOOST_REQUIRE_EQUAL(matched.size(), 1u);
+    BOOST_REQUIRE_EQUAL(matched[0], 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
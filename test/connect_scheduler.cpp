@@ -0,0 +1,152 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::config;
+using namespace bc::network;
+
+static const auto second = asio::duration(std::chrono::seconds(1));
+static const auto minute = asio::duration(std::chrono::seconds(60));
+
+// The jittered backoff falls in [delay / 2, delay].
+static bool jittered(const asio::duration& value,
+    const asio::duration& delay)
+{
+    return value <= delay && value >= delay / 2;
+}
+
+BOOST_AUTO_TEST_SUITE(connect_scheduler_tests)
+
+// backoff
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__backoff__no_failures__zero)
+{
+    const auto delay = connect_scheduler::backoff(0, second, minute);
+    BOOST_REQUIRE(delay == asio::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__backoff__consecutive_failures__doubles)
+{
+    BOOST_REQUIRE(jittered(connect_scheduler::backoff(1, second, minute),
+        second));
+    BOOST_REQUIRE(jittered(connect_scheduler::backoff(2, second, minute),
+        2 * second));
+    BOOST_REQUIRE(jittered(connect_scheduler::backoff(4, second, minute),
+        8 * second));
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__backoff__many_failures__maximum)
+{
+    BOOST_REQUIRE(jittered(connect_scheduler::backoff(7, second, minute),
+        minute));
+    BOOST_REQUIRE(jittered(connect_scheduler::backoff(1000, second, minute),
+        minute));
+}
+
+// delay
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__delay__failed__backs_off)
+{
+    connect_scheduler scheduler(2, 1, minute);
+    BOOST_REQUIRE(scheduler.delay(0) == asio::duration::zero());
+    scheduler.failed(0);
+    scheduler.failed(0);
+    BOOST_REQUIRE(jittered(scheduler.delay(0), 2 * second));
+    BOOST_REQUIRE(scheduler.delay(1) == asio::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__delay__connected__cleared)
+{
+    connect_scheduler scheduler(1, 1, minute);
+    scheduler.failed(0);
+    scheduler.connected(0, authority("1.2.3.4:8333"));
+    BOOST_REQUIRE(scheduler.delay(0) == asio::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__delay__invalid_slot__zero)
+{
+    connect_scheduler scheduler(1, 1, minute);
+    scheduler.failed(5);
+    BOOST_REQUIRE(scheduler.delay(5) == asio::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__resize__larger__slot_tracked)
+{
+    connect_scheduler scheduler(1, 1, minute);
+    scheduler.resize(6);
+    scheduler.failed(5);
+    BOOST_REQUIRE(jittered(scheduler.delay(5), second));
+}
+
+// batch_size
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__batch_size__succeeding__configured)
+{
+    connect_scheduler scheduler(8, 5, minute);
+    BOOST_REQUIRE_EQUAL(scheduler.batch_size(), 5u);
+
+    for (size_t count = 0; count < 100; ++count)
+        scheduler.attempted(true);
+
+    BOOST_REQUIRE_EQUAL(scheduler.batch_size(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__batch_size__failing__bounded_growth)
+{
+    connect_scheduler scheduler(8, 5, minute);
+
+    for (size_t count = 0; count < 100; ++count)
+        scheduler.attempted(false);
+
+    BOOST_REQUIRE_EQUAL(scheduler.batch_size(), 20u);
+}
+
+// groups
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__group__same_ipv4_16__equal)
+{
+    const auto group = connect_scheduler::group(authority("1.2.3.4:8333"));
+    BOOST_REQUIRE_EQUAL(group,
+        connect_scheduler::group(authority("1.2.9.9:8333")));
+    BOOST_REQUIRE(group !=
+        connect_scheduler::group(authority("1.3.3.4:8333")));
+}
+
+BOOST_AUTO_TEST_CASE(connect_scheduler__groups__connected__tracked)
+{
+    connect_scheduler scheduler(2, 1, minute);
+    const authority first("1.2.3.4:8333");
+    const authority other("5.6.7.8:8333");
+    scheduler.connected(0, first);
+    scheduler.connected(1, other);
+
+    auto groups = scheduler.groups();
+    BOOST_REQUIRE_EQUAL(groups.size(), 2u);
+    BOOST_REQUIRE_EQUAL(groups.count(connect_scheduler::group(first)), 1u);
+
+    scheduler.disconnected(0);
+    groups = scheduler.groups();
+    BOOST_REQUIRE_EQUAL(groups.size(), 1u);
+    BOOST_REQUIRE_EQUAL(groups.count(connect_scheduler::group(other)), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
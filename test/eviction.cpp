@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::config;
+using namespace bc::network;
+
+// Channels are constructed but not started, so are exempt from timers.
+class eviction_fixture
+{
+public:
+    eviction_fixture()
+      : pool_(1), buffers_(0), timers_(pool_, asio::seconds(1), 8)
+    {
+    }
+
+    ~eviction_fixture()
+    {
+        pool_.shutdown();
+        pool_.join();
+    }
+
+    channel::ptr make_channel(const std::string& host)
+    {
+        const auto transport = std::make_shared<pipe_transport>(pool_,
+            authority(host));
+
+        return std::make_shared<channel>(pool_, buffers_, timers_, transport,
+            settings_);
+    }
+
+private:
+    threadpool pool_;
+    buffer_pool buffers_;
+    timer_wheel timers_;
+    const network::settings settings_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(eviction_tests, eviction_fixture)
+
+BOOST_AUTO_TEST_CASE(eviction__select__empty__null)
+{
+    const eviction instance;
+    BOOST_REQUIRE(!instance.select({}));
+}
+
+BOOST_AUTO_TEST_CASE(eviction__select__all_protected__null)
+{
+    const eviction instance;
+    channel_registry::list channels;
+
+    // Four groups and eight pings are protected before any other criteria.
+    for (size_t host = 0; host < 12; ++host)
+        channels.push_back(make_channel("10." + std::to_string(host) +
+            ".0.1:8333"));
+
+    BOOST_REQUIRE(!instance.select(channels));
+}
+
+BOOST_AUTO_TEST_CASE(eviction__select__populous_group__member_selected)
+{
+    const eviction instance;
+    channel_registry::list channels;
+
+    for (size_t host = 0; host < 100; ++host)
+        channels.push_back(make_channel("10.1.0." + std::to_string(host) +
+            ":8333"));
+
+    for (size_t host = 0; host < 5; ++host)
+        channels.push_back(make_channel("10." + std::to_string(host + 2) +
+            ".0.1:8333"));
+
+    const auto selected = instance.select(channels);
+    BOOST_REQUIRE(selected);
+    BOOST_REQUIRE_EQUAL(connect_scheduler::group(selected->authority()),
+        connect_scheduler::group(authority("10.1.0.0:8333")));
+}
+
+BOOST_AUTO_TEST_CASE(eviction__select__equal_groups__youngest_of_group)
+{
+    const eviction instance;
+    channel_registry::list channels;
+
+    for (size_t host = 0; host < 40; ++host)
+        channels.push_back(make_channel("10.1.0." + std::to_string(host) +
+            ":8333"));
+
+    const auto selected = instance.select(channels);
+    BOOST_REQUIRE(selected);
+
+    // Only channels protected by group or ping may be younger.
+    size_t younger = 0;
+    for (const auto channel: channels)
+        if (channel->started() > selected->started())
+            ++younger;
+
+    BOOST_REQUIRE_LE(younger, 12u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
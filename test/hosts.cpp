@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::config;
+using namespace bc::network;
+
+// Each instance has its own hosts file, removed upon destruct.
+class hosts_fixture
+{
+public:
+    hosts_fixture()
+      : path_(boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path())
+    {
+    }
+
+    ~hosts_fixture()
+    {
+        boost::system::error_code ec;
+        boost::filesystem::remove(path_, ec);
+    }
+
+    network::settings make_settings(uint32_t capacity) const
+    {
+        network::settings configuration;
+        configuration.host_pool_capacity = capacity;
+        configuration.hosts_file = path_;
+        return configuration;
+    }
+
+    static hosts::address make_address(const std::string& host)
+    {
+        return authority(host).to_network_address();
+    }
+
+    // An ipv4 address in the /16 of group, of distinct index and port.
+    static hosts::address make_address(size_t group, size_t index)
+    {
+        return make_address("10." + std::to_string(group) + "." +
+            std::to_string(index / 256) + "." + std::to_string(index % 256) +
+            ":8333");
+    }
+
+private:
+    const boost::filesystem::path path_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(hosts_tests, hosts_fixture)
+
+// group
+
+BOOST_AUTO_TEST_CASE(hosts__group__ipv4__16_bits)
+{
+    const auto group = hosts::group(make_address("1.2.3.4:8333"));
+    BOOST_REQUIRE_EQUAL(group, hosts::group(make_address("1.2.200.1:8333")));
+    BOOST_REQUIRE(group != hosts::group(make_address("1.3.3.4:8333")));
+}
+
+BOOST_AUTO_TEST_CASE(hosts__group__ipv6__32_bits)
+{
+    const auto group = hosts::group(make_address("[2001:db8::1]:8333"));
+    BOOST_REQUIRE_EQUAL(group,
+        hosts::group(make_address("[2001:db8:ffff::1]:8333")));
+    BOOST_REQUIRE(group != hosts::group(make_address("[2001:db9::1]:8333")));
+}
+
+BOOST_AUTO_TEST_CASE(hosts__group__mapped_ipv4__distinct_from_ipv6)
+{
+    // The /32 of 0:102:: has the bytes of the /16 of 1.2.0.0, but no flag.
+    BOOST_REQUIRE(hosts::group(make_address("1.2.0.0:8333")) !=
+        hosts::group(make_address("[0:102::1]:8333")));
+}
+
+// store
+
+BOOST_AUTO_TEST_CASE(hosts__store__disabled__not_stored)
+{
+    hosts instance(make_settings(0));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+    BOOST_REQUIRE_EQUAL(instance.store(make_address(1, 1)), error::success);
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+
+    hosts::address out;
+    BOOST_REQUIRE_EQUAL(instance.fetch(out), error::not_found);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__store__stopped__service_stopped)
+{
+    hosts instance(make_settings(100));
+    BOOST_REQUIRE_EQUAL(instance.store(make_address(1, 1)),
+        error::service_stopped);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__store__duplicate__stored_once)
+{
+    hosts instance(make_settings(100));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+    BOOST_REQUIRE_EQUAL(instance.store(make_address(1, 1)), error::success);
+    BOOST_REQUIRE_EQUAL(instance.store(make_address(1, 1)), error::success);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__store__beyond_bucket__bounded_by_new_table)
+{
+    // Pools of 256 are a single bucket, of which one fifth is tried.
+    hosts instance(make_settings(256));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+
+    for (size_t index = 0; index < 300; ++index)
+        instance.store(make_address(index % 8, index));
+
+    BOOST_REQUIRE_EQUAL(instance.count(), 256u - 256u / 5u);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__store__one_group__limited_to_one_bucket)
+{
+    // Four buckets, a single group fills only the new table of its own.
+    hosts instance(make_settings(1024));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+
+    for (size_t index = 0; index < 1000; ++index)
+        instance.store(make_address(1, index));
+
+    BOOST_REQUIRE_EQUAL(instance.count(), 256u - 256u / 5u);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+// promote/demote
+
+BOOST_AUTO_TEST_CASE(hosts__demote__new_failing__evicted)
+{
+    hosts instance(make_settings(100));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+    const auto host = make_address(1, 1);
+    instance.store(host);
+
+    BOOST_REQUIRE_EQUAL(instance.demote(host), error::success);
+    BOOST_REQUIRE_EQUAL(instance.demote(host), error::success);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.demote(host), error::success);
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.demote(host), error::not_found);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__demote__tried_failing__moved_to_new)
+{
+    hosts instance(make_settings(100));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+    const auto host = make_address(1, 1);
+
+    // An unknown address is promoted directly to tried.
+    BOOST_REQUIRE_EQUAL(instance.promote(host), error::success);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+
+    // Failing in tried moves it to new, with a fresh set of attempts.
+    for (size_t attempt = 0; attempt < 3; ++attempt)
+        BOOST_REQUIRE_EQUAL(instance.demote(host), error::success);
+
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+
+    // Failing in new evicts it.
+    for (size_t attempt = 0; attempt < 3; ++attempt)
+        BOOST_REQUIRE_EQUAL(instance.demote(host), error::success);
+
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__promote__failing__attempts_cleared)
+{
+    hosts instance(make_settings(100));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+    const auto host = make_address(1, 1);
+    instance.store(host);
+
+    instance.demote(host);
+    instance.demote(host);
+    BOOST_REQUIRE_EQUAL(instance.promote(host), error::success);
+
+    // Three tried failures only move the address back to new.
+    for (size_t attempt = 0; attempt < 3; ++attempt)
+        instance.demote(host);
+
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+// fetch
+
+BOOST_AUTO_TEST_CASE(hosts__fetch__excluded_groups__other_group)
+{
+    hosts instance(make_settings(1024));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+
+    for (size_t index = 0; index < 50; ++index)
+        instance.store(make_address(1, index));
+
+    const auto other = make_address(2, 0);
+    instance.store(other);
+
+    const hosts::groups excluded{ hosts::group(make_address(1, 0)) };
+
+    for (size_t fetch = 0; fetch < 20; ++fetch)
+    {
+        hosts::address out;
+        BOOST_REQUIRE_EQUAL(instance.fetch(out, excluded), error::success);
+        BOOST_REQUIRE(out == other);
+    }
+
+    const hosts::groups all{ hosts::group(make_address(1, 0)),
+        hosts::group(other) };
+
+    hosts::address out;
+    BOOST_REQUIRE_EQUAL(instance.fetch(out, all), error::not_found);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__fetch_list__maximum__bounded)
+{
+    // A single bucket, so its share is the whole maximum.
+    hosts instance(make_settings(256));
+    BOOST_REQUIRE_EQUAL(instance.start(), error::success);
+
+    for (size_t index = 0; index < 100; ++index)
+        instance.store(make_address(index, 0));
+
+    hosts::address::list out;
+    BOOST_REQUIRE_EQUAL(instance.fetch(out, 10), error::success);
+    BOOST_REQUIRE_EQUAL(out.size(), 10u);
+    BOOST_REQUIRE_EQUAL(instance.stop(), error::success);
+}
+
+BOOST_AUTO_TEST_CASE(hosts__fetch__stopped__service_stopped)
+{
+    hosts instance(make_settings(100));
+    hosts::address out;
+    BOOST_REQUIRE_EQUAL(instance.fetch(out), error::service_stopped);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
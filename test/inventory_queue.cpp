@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::message;
+using namespace bc::network;
+
+static inventory_vector make_item(uint32_t value)
+{
+    return
+    {
+        inventory_vector::type_id::transaction,
+        sha256_hash(to_chunk(to_little_endian(value)))
+    };
+}
+
+BOOST_AUTO_TEST_SUITE(inventory_queue_tests)
+
+BOOST_AUTO_TEST_CASE(inventory_queue__enqueue__unknown__queued)
+{
+    inventory_queue queue(100);
+    BOOST_REQUIRE_EQUAL(queue.enqueue({ make_item(1), make_item(2) }), 2u);
+    BOOST_REQUIRE_EQUAL(queue.size(), 2u);
+    BOOST_REQUIRE(queue.is_known(make_item(1).hash()));
+}
+
+BOOST_AUTO_TEST_CASE(inventory_queue__enqueue__duplicate__suppressed)
+{
+    inventory_queue queue(100);
+    BOOST_REQUIRE_EQUAL(queue.enqueue({ make_item(1), make_item(1) }), 1u);
+    BOOST_REQUIRE_EQUAL(queue.enqueue({ make_item(1) }), 0u);
+    BOOST_REQUIRE_EQUAL(queue.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(inventory_queue__enqueue__known__suppressed)
+{
+    inventory_queue queue(100);
+    queue.known({ make_item(1) });
+    BOOST_REQUIRE(queue.is_known(make_item(1).hash()));
+    BOOST_REQUIRE_EQUAL(queue.enqueue({ make_item(1), make_item(2) }), 1u);
+    BOOST_REQUIRE_EQUAL(queue.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(inventory_queue__dequeue__beyond_maximum__oldest_first)
+{
+    inventory_queue queue(100);
+    queue.enqueue({ make_item(1), make_item(2), make_item(3) });
+
+    const auto items = queue.dequeue(2);
+    BOOST_REQUIRE_EQUAL(items.size(), 2u);
+    BOOST_REQUIRE(items[0] == make_item(1));
+    BOOST_REQUIRE(items[1] == make_item(2));
+    BOOST_REQUIRE_EQUAL(queue.size(), 1u);
+
+    const auto rest = queue.dequeue(2);
+    BOOST_REQUIRE_EQUAL(rest.size(), 1u);
+    BOOST_REQUIRE(rest[0] == make_item(3));
+    BOOST_REQUIRE_EQUAL(queue.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(inventory_queue__dequeue__dequeued__remains_known)
+{
+    inventory_queue queue(100);
+    queue.enqueue({ make_item(1) });
+    queue.dequeue(10);
+    BOOST_REQUIRE(queue.is_known(make_item(1).hash()));
+    BOOST_REQUIRE_EQUAL(queue.enqueue({ make_item(1) }), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::chain;
+using namespace bc::machine;
+using namespace bc::network;
+
+// A transaction of one input and one output with a 21 byte script.
+static transaction make_transaction()
+{
+    const script pay(operation::list{ operation(data_chunk(20, 0x42)) });
+    const input spend(output_point(null_hash, 0), script(), 0);
+    return transaction(1, 0, { spend }, { output(42, pay) });
+}
+
+// The serialized header and count, followed by the body.
+static data_chunk make_block(const data_chunk& count, const data_chunk& body)
+{
+    return build_chunk({ header().to_data(), count, body });
+}
+
+static bool load(lazy_block& block, const data_chunk& data)
+{
+    auto source = make_safe_deserializer(data.begin(), data.end());
+    return block.from_data(lazy_block::version_maximum, source);
+}
+
+BOOST_AUTO_TEST_SUITE(lazy_block_tests)
+
+BOOST_AUTO_TEST_CASE(lazy_block__from_data__one_transaction__valid)
+{
+    const auto tx = make_transaction();
+    lazy_block block;
+    BOOST_REQUIRE(load(block, make_block({ 0x01 }, tx.to_data())));
+    BOOST_REQUIRE(block.is_valid());
+    BOOST_REQUIRE_EQUAL(block.transaction_count(), 1u);
+    BOOST_REQUIRE(block.index());
+
+    transaction out;
+    BOOST_REQUIRE(block.transaction(0, out));
+    BOOST_REQUIRE(out.hash() == tx.hash());
+    BOOST_REQUIRE(!block.transaction(1, out));
+
+    const auto full = block.block();
+    BOOST_REQUIRE(full);
+    BOOST_REQUIRE_EQUAL(full->transactions().size(), 1u);
+    BOOST_REQUIRE(full->transactions()[0].hash() == tx.hash());
+}
+
+BOOST_AUTO_TEST_CASE(lazy_block__from_data__truncated_transaction__not_indexed)
+{
+    auto body = make_transaction().to_data();
+    body.resize(body.size() - 5);
+    lazy_block block;
+
+    // The count is plausible for the size, so only indexing detects it.
+    BOOST_REQUIRE(load(block, make_block({ 0x01 }, body)));
+    BOOST_REQUIRE(!block.index());
+    BOOST_REQUIRE(!block.block());
+}
+
+BOOST_AUTO_TEST_CASE(lazy_block__from_data__count_exceeds_body__invalid)
+{
+    lazy_block block;
+    BOOST_REQUIRE(!load(block, make_block({ 0x02 },
+        make_transaction().to_data())));
+    BOOST_REQUIRE(!block.is_valid());
+    BOOST_REQUIRE(!block.block());
+}
+
+BOOST_AUTO_TEST_CASE(lazy_block__from_data__oversized_count__invalid)
+{
+    lazy_block block;
+    const data_chunk count{ 0xfe, 0xff, 0xff, 0xff, 0xff };
+    BOOST_REQUIRE(!load(block, make_block(count, data_chunk(100, 0x00))));
+    BOOST_REQUIRE(!block.is_valid());
+    BOOST_REQUIRE(!block.block());
+}
+
+BOOST_AUTO_TEST_CASE(lazy_block__from_data__truncated_header__invalid)
+{
+    const auto data = header().to_data();
+    lazy_block block;
+    BOOST_REQUIRE(!load(block, data_chunk(data.begin(), data.end() - 1)));
+    BOOST_REQUIRE(!block.is_valid());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -177,6 +177,39 @@ static int send_result(const Message& message, p2p& network, int channels)
     return result;
 }
 
+// Simulates a node over an in-memory network shared with other nodes.
+class loopback_p2p
+  : public p2p
+{
+public:
+    loopback_p2p(const network::settings& settings, loopback& network)
+      : p2p(settings), network_(network)
+    {
+    }
+
+    acceptor::ptr create_acceptor() override
+    {
+        return std::make_shared<loopback_acceptor>(network_, thread_pool(),
+            channel_threads(), receive_buffers(), timers(),
+            inbound_admission(), network_settings());
+    }
+
+    connector::ptr create_connector() override
+    {
+        return std::make_shared<loopback_connector>(network_, thread_pool(),
+            channel_threads(), receive_buffers(), timers(), resolver(),
+            network_settings());
+    }
+
+private:
+    loopback& network_;
+};
+
+#define SETTINGS_TESTNET_ONE_THREAD_LOOPBACK(name) \
+    SETTINGS_TESTNET_ONE_THREAD_NO_CONNECTIONS(name); \
+    name.host_pool_capacity = 0; \
+    name.inbound_connections = 0
+
 // Trivial tests just validate static inits (required because p2p tests disabled in travis).
 BOOST_AUTO_TEST_SUITE(empty_tests)
 
@@ -436,6 +469,26 @@ BOOST_AUTO_TEST_CASE(p2p__broadcast__ping_two_distinct_hosts__two_sends_and_succ
     BOOST_REQUIRE_EQUAL(send_result(ping(0), network, 2), error::success);
 }
 
+BOOST_AUTO_TEST_CASE(p2p__connect__loopback__success)
+{
+    print_headers(TEST_NAME);
+    threadpool pool(1);
+    loopback network(pool);
+    SETTINGS_TESTNET_ONE_THREAD_LOOPBACK(server_settings);
+    server_settings.inbound_port = 42;
+    server_settings.inbound_connections = 1;
+    SETTINGS_TESTNET_ONE_THREAD_LOOPBACK(client_settings);
+    loopback_p2p server(server_settings, network);
+    loopback_p2p client(client_settings, network);
+    const config::endpoint host("127.0.0.1", 42);
+    BOOST_REQUIRE_EQUAL(start_result(server), error::success);
+    BOOST_REQUIRE_EQUAL(run_result(server), error::success);
+    BOOST_REQUIRE_EQUAL(start_result(client), error::success);
+    BOOST_REQUIRE_EQUAL(run_result(client), error::success);
+    BOOST_REQUIRE_EQUAL(connect_result(client, host), error::success);
+    BOOST_REQUIRE_EQUAL(send_result(ping(0), client, 1), error::success);
+}
+
 ////BOOST_AUTO_TEST_CASE(p2p__subscribe__seed_outbound__success)
 ////{
 ////    print_headers(TEST_NAME);
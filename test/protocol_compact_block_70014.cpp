@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+typedef protocol_compact_block_70014 compact;
+
+BOOST_AUTO_TEST_SUITE(protocol_compact_block_70014_tests)
+
+// encode
+
+BOOST_AUTO_TEST_CASE(compact_block__encode__empty__empty)
+{
+    BOOST_REQUIRE(compact::encode({}).empty());
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__encode__ascending__differences)
+{
+    const compact::indexes expected{ 0, 0, 2, 0, 5 };
+    BOOST_REQUIRE(compact::encode({ 0, 1, 4, 5, 11 }) == expected);
+}
+
+// decode
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__encoded__round_trip)
+{
+    const compact::indexes values{ 1, 2, 3, 7, 100, 999 };
+    compact::indexes out;
+    BOOST_REQUIRE(compact::decode(out, compact::encode(values), 1000));
+    BOOST_REQUIRE(out == values);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__last_index__true)
+{
+    compact::indexes out;
+    BOOST_REQUIRE(compact::decode(out, { 9 }, 10));
+    BOOST_REQUIRE_EQUAL(out.size(), 1u);
+    BOOST_REQUIRE_EQUAL(out.front(), 9u);
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__index_at_count__false)
+{
+    compact::indexes out;
+    BOOST_REQUIRE(!compact::decode(out, { 10 }, 10));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__cumulative_at_count__false)
+{
+    compact::indexes out;
+    BOOST_REQUIRE(!compact::decode(out, { 5, 4 }, 10));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__beyond_last__false)
+{
+    // The last index is taken, so no further index remains.
+    compact::indexes out;
+    BOOST_REQUIRE(!compact::decode(out, { 9, 0 }, 10));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__overflowing_difference__false)
+{
+    // The sum of the differences would wrap a 64 bit index.
+    compact::indexes out;
+    BOOST_REQUIRE(!compact::decode(out, { 1, max_uint64 }, 10));
+}
+
+BOOST_AUTO_TEST_CASE(compact_block__decode__no_transactions__false)
+{
+    compact::indexes out;
+    BOOST_REQUIRE(!compact::decode(out, { 0 }, 0));
+    BOOST_REQUIRE(compact::decode(out, {}, 0));
+    BOOST_REQUIRE(out.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+BOOST_AUTO_TEST_SUITE(rate_limiter_tests)
+
+BOOST_AUTO_TEST_CASE(rate_limiter__consume__zero_rate__unlimited)
+{
+    rate_limiter limiter(0);
+    BOOST_REQUIRE(!limiter.enabled());
+    BOOST_REQUIRE(limiter.consume(1000000) == asio::duration::zero());
+    BOOST_REQUIRE(limiter.delay() == asio::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(rate_limiter__consume__within_burst__no_delay)
+{
+    rate_limiter limiter(1000);
+    BOOST_REQUIRE(limiter.enabled());
+    BOOST_REQUIRE(limiter.consume(500) == asio::duration::zero());
+    BOOST_REQUIRE(limiter.delay() == asio::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(rate_limiter__consume__beyond_burst__delay_repays_debt)
+{
+    rate_limiter limiter(1000);
+    const auto delay = limiter.consume(2000);
+    BOOST_REQUIRE(delay <= std::chrono::seconds(1));
+    BOOST_REQUIRE(delay > std::chrono::milliseconds(900));
+}
+
+BOOST_AUTO_TEST_CASE(rate_limiter__delay__in_debt__does_not_consume)
+{
+    rate_limiter limiter(1000);
+    limiter.consume(1500);
+    const auto first = limiter.delay();
+    const auto second = limiter.delay();
+    BOOST_REQUIRE(first > std::chrono::milliseconds(400));
+    BOOST_REQUIRE(second <= first);
+    BOOST_REQUIRE(second > std::chrono::milliseconds(400));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,149 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+static const auto second = asio::duration(std::chrono::seconds(1));
+static const auto ten_seconds = asio::duration(std::chrono::seconds(10));
+
+static hash_digest make_hash(uint32_t value)
+{
+    return sha256_hash(to_chunk(to_little_endian(value)));
+}
+
+BOOST_AUTO_TEST_SUITE(request_tracker_tests)
+
+BOOST_AUTO_TEST_CASE(request_tracker__construct__default__minimum_window)
+{
+    const request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE_EQUAL(tracker.window(), 2u);
+    BOOST_REQUIRE_EQUAL(tracker.available(), 2u);
+    BOOST_REQUIRE_EQUAL(tracker.outstanding(), 0u);
+    BOOST_REQUIRE(!tracker.stalled());
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__timeout__no_samples__maximum)
+{
+    const request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(tracker.timeout() == ten_seconds);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__request__beyond_window__false)
+{
+    request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(tracker.request(make_hash(1)));
+    BOOST_REQUIRE(tracker.request(make_hash(2)));
+    BOOST_REQUIRE(!tracker.request(make_hash(3)));
+    BOOST_REQUIRE_EQUAL(tracker.outstanding(), 2u);
+    BOOST_REQUIRE_EQUAL(tracker.available(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__request__outstanding__false)
+{
+    request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(tracker.request(make_hash(1)));
+    BOOST_REQUIRE(!tracker.request(make_hash(1)));
+    BOOST_REQUIRE_EQUAL(tracker.outstanding(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__deliver__not_outstanding__false)
+{
+    request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(!tracker.deliver(make_hash(1), 100));
+    BOOST_REQUIRE_EQUAL(tracker.rate(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__deliver__window_delivered__window_grows)
+{
+    request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(tracker.request(make_hash(1)));
+    BOOST_REQUIRE(tracker.request(make_hash(2)));
+    BOOST_REQUIRE(tracker.deliver(make_hash(1), 100));
+    BOOST_REQUIRE_EQUAL(tracker.window(), 2u);
+    BOOST_REQUIRE(tracker.deliver(make_hash(2), 100));
+    BOOST_REQUIRE_EQUAL(tracker.window(), 3u);
+    BOOST_REQUIRE_EQUAL(tracker.outstanding(), 0u);
+    BOOST_REQUIRE(tracker.rate() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__deliver__many__window_bounded_by_maximum)
+{
+    request_tracker tracker(1, 4, second, ten_seconds);
+
+    for (uint32_t value = 0; value < 100; ++value)
+    {
+        BOOST_REQUIRE(tracker.request(make_hash(value)));
+        BOOST_REQUIRE(tracker.deliver(make_hash(value), 100));
+    }
+
+    BOOST_REQUIRE_EQUAL(tracker.window(), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__cancel_hash__outstanding__removed)
+{
+    request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(tracker.request(make_hash(1)));
+    BOOST_REQUIRE(tracker.cancel(make_hash(1)));
+    BOOST_REQUIRE(!tracker.cancel(make_hash(1)));
+    BOOST_REQUIRE_EQUAL(tracker.outstanding(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__cancel__not_stalled__window_retained)
+{
+    request_tracker tracker(2, 4, second, ten_seconds);
+    BOOST_REQUIRE(tracker.request(make_hash(1)));
+    BOOST_REQUIRE(tracker.request(make_hash(2)));
+
+    const auto hashes = tracker.cancel();
+    BOOST_REQUIRE_EQUAL(hashes.size(), 2u);
+    BOOST_REQUIRE_EQUAL(tracker.outstanding(), 0u);
+    BOOST_REQUIRE_EQUAL(tracker.window(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(request_tracker__cancel__stalled__window_halved)
+{
+    const auto zero = asio::duration::zero();
+    request_tracker tracker(1, 8, zero, zero);
+
+    // Grow the window to three, a window of deliveries at a time.
+    BOOST_REQUIRE(tracker.request(make_hash(1)));
+    BOOST_REQUIRE(tracker.deliver(make_hash(1), 100));
+    BOOST_REQUIRE(tracker.request(make_hash(2)));
+    BOOST_REQUIRE(tracker.request(make_hash(3)));
+    BOOST_REQUIRE(tracker.deliver(make_hash(2), 100));
+    BOOST_REQUIRE(tracker.deliver(make_hash(3), 100));
+    BOOST_REQUIRE_EQUAL(tracker.window(), 3u);
+
+    // With a zero timeout any outstanding request stalls once time passes.
+    BOOST_REQUIRE(tracker.request(make_hash(4)));
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    BOOST_REQUIRE(tracker.stalled());
+
+    BOOST_REQUIRE_EQUAL(tracker.cancel().size(), 1u);
+    BOOST_REQUIRE_EQUAL(tracker.window(), 1u);
+    BOOST_REQUIRE(!tracker.stalled());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <future>
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+class resolver_cache_fixture
+{
+public:
+    resolver_cache_fixture()
+      : pool_(2), cache_(pool_, settings_)
+    {
+    }
+
+    ~resolver_cache_fixture()
+    {
+        pool_.shutdown();
+        pool_.join();
+    }
+
+    // Block until the resolution completes.
+    code resolve(const std::string& hostname, uint16_t port,
+        resolver_cache::endpoints_ptr& out)
+    {
+        std::promise<code> promise;
+        cache_.resolve(hostname, port,
+            [&](const code& ec, resolver_cache::endpoints_ptr hosts)
+            {
+                out = hosts;
+                promise.set_value(ec);
+            });
+
+        return promise.get_future().get();
+    }
+
+protected:
+    const network::settings settings_;
+    threadpool pool_;
+    resolver_cache cache_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(resolver_cache_tests, resolver_cache_fixture)
+
+BOOST_AUTO_TEST_CASE(resolver_cache__resolve__ipv4_literal__not_cached)
+{
+    resolver_cache::endpoints_ptr hosts;
+    BOOST_REQUIRE_EQUAL(resolve("10.0.0.1", 8333, hosts), error::success);
+    BOOST_REQUIRE(hosts);
+    BOOST_REQUIRE_EQUAL(hosts->size(), 1u);
+    BOOST_REQUIRE_EQUAL(hosts->front().port(), 8333u);
+    BOOST_REQUIRE_EQUAL(cache_.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(resolver_cache__resolve__ipv6_literal__not_cached)
+{
+    resolver_cache::endpoints_ptr hosts;
+    BOOST_REQUIRE_EQUAL(resolve("[::1]", 8333, hosts), error::success);
+    BOOST_REQUIRE(hosts);
+    BOOST_REQUIRE_EQUAL(hosts->size(), 1u);
+    BOOST_REQUIRE(hosts->front().address().is_v6());
+    BOOST_REQUIRE_EQUAL(cache_.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(resolver_cache__resolve__name__cached)
+{
+    resolver_cache::endpoints_ptr first;
+    resolver_cache::endpoints_ptr second;
+    BOOST_REQUIRE_EQUAL(resolve("localhost", 8333, first), error::success);
+    BOOST_REQUIRE_EQUAL(cache_.size(), 1u);
+    BOOST_REQUIRE_EQUAL(resolve("localhost", 8333, second), error::success);
+    BOOST_REQUIRE(first == second);
+
+    cache_.clear();
+    BOOST_REQUIRE_EQUAL(cache_.size(), 0u);
+}
+
+// Each port is a distinct record, so localhost fills the cache offline.
+BOOST_AUTO_TEST_CASE(resolver_cache__resolve__beyond_maximum__bounded)
+{
+    resolver_cache::endpoints_ptr hosts;
+
+    for (uint16_t port = 1; port <= 1100; ++port)
+        BOOST_REQUIRE_EQUAL(resolve("localhost", port, hosts),
+            error::success);
+
+    BOOST_REQUIRE_EQUAL(cache_.size(), 1000u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,87 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+static hash_digest make_hash(uint32_t value)
+{
+    return sha256_hash(to_chunk(to_little_endian(value)));
+}
+
+BOOST_AUTO_TEST_SUITE(rolling_bloom_tests)
+
+BOOST_AUTO_TEST_CASE(rolling_bloom__contains__empty__false)
+{
+    const rolling_bloom filter(100);
+    BOOST_REQUIRE(!filter.contains(make_hash(0)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom__contains__inserted__true)
+{
+    rolling_bloom filter(100);
+    filter.insert(make_hash(42));
+    BOOST_REQUIRE(filter.contains(make_hash(42)));
+    BOOST_REQUIRE(!filter.contains(make_hash(43)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom__insert__zero_capacity__disabled)
+{
+    rolling_bloom filter(0);
+    filter.insert(make_hash(42));
+    BOOST_REQUIRE(!filter.contains(make_hash(42)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom__insert__beyond_capacity__newest_retained)
+{
+    rolling_bloom filter(100);
+
+    for (uint32_t value = 0; value < 150; ++value)
+        filter.insert(make_hash(value));
+
+    for (uint32_t value = 100; value < 150; ++value)
+        BOOST_REQUIRE(filter.contains(make_hash(value)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom__insert__beyond_generations__oldest_lost)
+{
+    rolling_bloom filter(10);
+
+    for (uint32_t value = 0; value < 30; ++value)
+        filter.insert(make_hash(value));
+
+    for (uint32_t value = 0; value < 5; ++value)
+        BOOST_REQUIRE(!filter.contains(make_hash(value)));
+
+    for (uint32_t value = 20; value < 30; ++value)
+        BOOST_REQUIRE(filter.contains(make_hash(value)));
+}
+
+BOOST_AUTO_TEST_CASE(rolling_bloom__clear__inserted__forgotten)
+{
+    rolling_bloom filter(100);
+    filter.insert(make_hash(42));
+    filter.clear();
+    BOOST_REQUIRE(!filter.contains(make_hash(42)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+static const asio::duration millisecond = std::chrono::milliseconds(1);
+
+class timer_wheel_fixture
+{
+public:
+    timer_wheel_fixture()
+      : pool_(2)
+    {
+    }
+
+    // The pool is joined before the wheels are destroyed, as the aborted
+    // tick of a stopped wheel may still be pending.
+    ~timer_wheel_fixture()
+    {
+        for (const auto& wheel: wheels_)
+            wheel->stop();
+
+        pool_.shutdown();
+        pool_.join();
+    }
+
+    timer_wheel& make_wheel(const asio::duration& resolution, size_t slots)
+    {
+        wheels_.emplace_back(new timer_wheel(pool_, resolution, slots));
+        return *wheels_.back();
+    }
+
+    // Block until the timeout fires, returning the elapsed time.
+    asio::duration elapsed(timer_wheel& wheel, const asio::duration& delay)
+    {
+        std::promise<code> promise;
+        const auto start = asio::steady_clock::now();
+        wheel.schedule(delay, [&](const code& ec)
+        {
+            promise.set_value(ec);
+        });
+
+        BOOST_REQUIRE_EQUAL(promise.get_future().get(), error::success);
+        return asio::steady_clock::now() - start;
+    }
+
+private:
+    threadpool pool_;
+    std::vector<std::unique_ptr<timer_wheel>> wheels_;
+};
+
+BOOST_FIXTURE_TEST_SUITE(timer_wheel_tests, timer_wheel_fixture)
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__not_started__dropped)
+{
+    auto& wheel = make_wheel(millisecond, 8);
+    const auto retained = std::make_shared<bool>(false);
+    wheel.schedule(millisecond, [retained](const code&) { *retained = true; });
+    BOOST_REQUIRE_EQUAL(retained.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__within_wheel__never_early)
+{
+    auto& wheel = make_wheel(10 * millisecond, 8);
+    wheel.start();
+
+    for (auto delay = millisecond; delay < 80 * millisecond; delay *= 3)
+        BOOST_REQUIRE(elapsed(wheel, delay) >= delay);
+
+    wheel.stop();
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__beyond_wheel__never_early)
+{
+    auto& wheel = make_wheel(10 * millisecond, 4);
+    wheel.start();
+
+    // Delays of several rounds, and one of exactly one round.
+    BOOST_REQUIRE(elapsed(wheel, 40 * millisecond) >= 40 * millisecond);
+    BOOST_REQUIRE(elapsed(wheel, 95 * millisecond) >= 95 * millisecond);
+    wheel.stop();
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__beyond_512_slots__never_early)
+{
+    auto& wheel = make_wheel(millisecond, 512);
+    wheel.start();
+
+    const auto delay = 600 * millisecond;
+    const auto actual = elapsed(wheel, delay);
+    BOOST_REQUIRE(actual >= delay);
+
+    // Fires up to two resolutions late, tick scheduling adds some latency.
+    BOOST_REQUIRE(actual < 2 * delay);
+    wheel.stop();
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__cancel__scheduled__dropped)
+{
+    auto& wheel = make_wheel(millisecond, 8);
+    wheel.start();
+
+    const auto retained = std::make_shared<bool>(false);
+    const auto token = wheel.schedule(5 * millisecond,
+        [retained](const code&) { *retained = true; });
+
+    wheel.cancel(token);
+    BOOST_REQUIRE_EQUAL(retained.use_count(), 1);
+
+    // A later timeout that fires implies the canceled slot has passed.
+    elapsed(wheel, 20 * millisecond);
+    BOOST_REQUIRE(!*retained);
+
+    // Canceling a canceled or fired token has no effect.
+    wheel.cancel(token);
+    wheel.stop();
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__stop__scheduled__dropped)
+{
+    auto& wheel = make_wheel(millisecond, 8);
+    wheel.start();
+
+    const auto retained = std::make_shared<bool>(false);
+    wheel.schedule(asio::duration(std::chrono::seconds(10)),
+        [retained](const code&) { *retained = true; });
+
+    BOOST_REQUIRE_EQUAL(retained.use_count(), 2);
+    wheel.stop();
+    BOOST_REQUIRE_EQUAL(retained.use_count(), 1);
+    BOOST_REQUIRE(!*retained);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__start__restarted__fires)
+{
+    auto& wheel = make_wheel(millisecond, 8);
+    wheel.start();
+    wheel.stop();
+    wheel.start();
+    BOOST_REQUIRE(elapsed(wheel, 5 * millisecond) >= 5 * millisecond);
+    wheel.stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/network.hpp>
+
+using namespace bc;
+using namespace bc::network;
+
+BOOST_AUTO_TEST_SUITE(work_scheduler_tests)
+
+BOOST_AUTO_TEST_CASE(work_scheduler__post__no_workers__dropped)
+{
+    work_scheduler scheduler(0);
+    BOOST_REQUIRE(!scheduler.enabled());
+    scheduler.spawn();
+
+    auto ran = false;
+    scheduler.post(0, [&]() { ran = true; });
+    scheduler.shutdown();
+    scheduler.join();
+    BOOST_REQUIRE(!ran);
+}
+
+BOOST_AUTO_TEST_CASE(work_scheduler__post__not_spawned__dropped)
+{
+    work_scheduler scheduler(2);
+    BOOST_REQUIRE(scheduler.enabled());
+
+    auto ran = false;
+    scheduler.post(0, [&]() { ran = true; });
+    scheduler.spawn();
+    scheduler.shutdown();
+    scheduler.join();
+    BOOST_REQUIRE(!ran);
+}
+
+BOOST_AUTO_TEST_CASE(work_scheduler__post__spawned__all_run)
+{
+    static const size_t jobs = 1000;
+    work_scheduler scheduler(4);
+    scheduler.spawn();
+
+    std::atomic<size_t> remaining(jobs);
+    std::promise<void> done;
+
+    // All jobs are posted to one worker, the others steal from it.
+    for (size_t job = 0; job < jobs; ++job)
+        scheduler.post(0, [&]()
+        {
+            if (--remaining == 0)
+                done.set_value();
+        });
+
+    done.get_future().wait();
+    scheduler.shutdown();
+    scheduler.join();
+    BOOST_REQUIRE_EQUAL(remaining.load(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(work_scheduler__serial_post__many__ordered)
+{
+    static const size_t jobs = 1000;
+    work_scheduler scheduler(4);
+    scheduler.spawn();
+
+    const auto serial = scheduler.make_serial();
+    std::vector<size_t> order;
+    std::promise<void> done;
+
+    // Serial jobs run one at a time, so the vector requires no lock.
+    for (size_t job = 0; job < jobs; ++job)
+        serial->post([&, job]()
+        {
+            order.push_back(job);
+
+            if (order.size() == jobs)
+                done.set_value();
+        });
+
+    done.get_future().wait();
+    scheduler.shutdown();
+    scheduler.join();
+
+    BOOST_REQUIRE_EQUAL(order.size(), jobs);
+    for (size_t job = 0; job < jobs; ++job)
+        BOOST_REQUIRE_EQUAL(order[job], job);
+}
+
+BOOST_AUTO_TEST_CASE(work_scheduler__serial_stop__posted_later__dropped)
+{
+    work_scheduler scheduler(2);
+    scheduler.spawn();
+
+    const auto retained = std::make_shared<size_t>(0);
+    const auto serial = scheduler.make_serial();
+    serial->stop();
+    serial->post([retained]() { ++*retained; });
+
+    scheduler.shutdown();
+    scheduler.join();
+    BOOST_REQUIRE_EQUAL(*retained, 0u);
+    BOOST_REQUIRE_EQUAL(retained.use_count(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()